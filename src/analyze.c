@@ -0,0 +1,288 @@
+/*
+    BSBOT made by William Dawson (MrBisquit on GitHub)
+    https://wtdawson.info
+
+    --------------------------------------------------------------------------------------------
+
+    bsbot_analyze
+
+    Goes through replay logs (see replay.h) and counts what the players did (see prior.h):
+    where each ship went, which ships were next to each other, where the first shots went and
+    how often players shot at cells where their own ships were. Prints heatmaps of it all,
+    and writes the counts as a prior file the bot can use.
+
+    The logs are mapped, and split up by block across every core, and counting a game is
+    only a few table lookups, so it's mostly waiting on the disk.
+
+    Usage: bsbot_analyze [--out FILE] [--side a|b|both] [--threads N] LOG...
+
+    --------------------------------------------------------------------------------------------
+
+ *  License:    SPDX-License-Identifier: MIT
+ *              See LICENSE file in the project root for full license text.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "prior.h"
+#include "fleet.h"
+#include "pool.h"
+
+#define ANALYZE_BASELINE 100000 // Random fleets counted to compare against
+
+typedef struct {
+    const replay_t* log;
+    const uint8_t* start;
+    const uint8_t* end;     // The next block in the same log (NULL = the end of it)
+} analyze_block_t;
+
+typedef struct {
+    analyze_block_t* blocks;
+    prior_counts_t* counts; // One per worker
+    uint64_t* games;        // One per worker (spaced out so they don't share cache lines)
+    uint8_t sides;
+} analyze_ctx_t;
+
+/// @brief Counts every game in one block
+static void bs_analyze_task(void* arg, uint32_t task, uint32_t worker) {
+    analyze_ctx_t* ctx = arg;
+    const analyze_block_t* block = &ctx->blocks[task];
+    prior_counts_t* counts = &ctx->counts[worker];
+
+    replay_cursor_t cursor;
+    bs_replay_range(block->log, &cursor, block->start, block->end);
+
+    const replay_game_t* game;
+    uint64_t games = 0;
+    while((game = bs_replay_next(&cursor)) != NULL) {
+        bs_prior_count(counts, game, ctx->sides);
+        games++;
+    }
+    ctx->games[worker * 8] += games;
+}
+
+/// @brief Prints a heatmap, as a percentage of `total` in each cell
+static void bs_analyze_heatmap(const char* title, const uint64_t* cells, uint64_t total) {
+    printf("%s:\n", title);
+    printf("      1     2     3     4     5     6     7     8     9    10\n");
+    for(uint8_t y = 0; y < BB_SIZE; y++) {
+        printf("%c ", 'A' + y);
+        for(uint8_t x = 0; x < BB_SIZE; x++) {
+            double p = total ? (100.0 * (double)cells[bs_bb_index(x, y)]) / (double)total : 0.0;
+            printf("%5.1f ", p);
+        }
+        printf("\n");
+    }
+}
+
+static void bs_analyze_usage(void) {
+    printf("Usage: bsbot_analyze [--out FILE] [--side a|b|both] [--threads N] LOG...\n");
+    printf("  --out FILE    Where the prior goes (default bsbot.prior)\n");
+    printf("  --side S      Whose fleets and shots to count (default both)\n");
+    printf("  --threads N   How many threads to use (default 0 = one per core)\n");
+}
+
+/// @brief The main function
+/// @param argc Args count
+/// @param argv Args
+/// @return Return code (0 = Success, 1 = bad arguments or a log couldn't be read)
+int main(int argc, char* argv[]) {
+    const char* out = "bsbot.prior";
+    uint32_t threads = 0;
+    analyze_ctx_t ctx = { .sides = PRIOR_SIDE_BOTH };
+
+    const char** paths = calloc(argc, sizeof(const char*));
+    uint32_t path_count = 0;
+    if(paths == NULL) return 1;
+
+    for(int i = 1; i < argc; i++) {
+        const char* arg = argv[i];
+        const char* value = (i + 1 < argc) ? argv[i + 1] : NULL;
+
+        if(strcmp(arg, "--help") == 0 || strcmp(arg, "-h") == 0) {
+            bs_analyze_usage();
+            return 0;
+        }
+        if(strncmp(arg, "--", 2) != 0) {
+            paths[path_count++] = arg;
+            continue;
+        }
+        if(value == NULL) {
+            bs_analyze_usage();
+            return 1;
+        }
+
+        if(strcmp(arg, "--out") == 0) out = value;
+        else if(strcmp(arg, "--threads") == 0) threads = (uint32_t)strtoul(value, NULL, 10);
+        else if(strcmp(arg, "--side") == 0) {
+            if(strcmp(value, "a") == 0) ctx.sides = PRIOR_SIDE_A;
+            else if(strcmp(value, "b") == 0) ctx.sides = PRIOR_SIDE_B;
+            else if(strcmp(value, "both") == 0) ctx.sides = PRIOR_SIDE_BOTH;
+            else {
+                bs_analyze_usage();
+                return 1;
+            }
+        } else {
+            bs_analyze_usage();
+            return 1;
+        }
+        i++;
+    }
+
+    if(path_count == 0) {
+        bs_analyze_usage();
+        return 1;
+    }
+
+    // Map every log, and find every block in them
+    replay_t* logs = calloc(path_count, sizeof(replay_t));
+    if(logs == NULL) return 1;
+
+    uint64_t total_blocks = 0, bytes = 0;
+    for(uint32_t l = 0; l < path_count; l++) {
+        if(!bs_replay_open(&logs[l], paths[l])) {
+            printf("couldn't open the replay log %s\n", paths[l]);
+            return 1;
+        }
+        total_blocks += bs_replay_blocks(&logs[l], NULL, 0);
+        bytes += logs[l].map.size;
+    }
+    if(total_blocks > UINT32_MAX) return 1;
+
+    ctx.blocks = calloc(total_blocks + 1, sizeof(analyze_block_t));
+    const uint8_t** starts = calloc(total_blocks + 1, sizeof(const uint8_t*));
+    if(ctx.blocks == NULL || starts == NULL) return 1;
+
+    uint64_t b = 0;
+    for(uint32_t l = 0; l < path_count; l++) {
+        uint64_t n = bs_replay_blocks(&logs[l], starts, total_blocks);
+        for(uint64_t i = 0; i < n; i++, b++) {
+            ctx.blocks[b].log = &logs[l];
+            ctx.blocks[b].start = starts[i];
+            ctx.blocks[b].end = (i + 1 < n) ? starts[i + 1] : NULL;
+        }
+    }
+    free(starts);
+
+    static pool_t pool;
+    bs_pool_init(&pool, threads);
+
+    ctx.counts = calloc(pool.workers, sizeof(prior_counts_t));
+    ctx.games = calloc((size_t)pool.workers * 8, sizeof(uint64_t));
+    if(ctx.counts == NULL || ctx.games == NULL) return 1;
+    for(uint32_t w = 0; w < pool.workers; w++) bs_prior_clear(&ctx.counts[w]); // Before any threads use the placement tables
+
+    uint64_t start = bs_time_ns();
+    bs_pool_run(&pool, bs_analyze_task, &ctx, (uint32_t)total_blocks);
+    double seconds = (double)(bs_time_ns() - start) / 1e9;
+    if(seconds <= 0.0) seconds = 1e-9;
+
+    prior_counts_t* counts = &ctx.counts[0];
+    uint64_t games = ctx.games[0];
+    for(uint32_t w = 1; w < pool.workers; w++) {
+        bs_prior_merge(counts, &ctx.counts[w]);
+        games += ctx.games[w * 8];
+    }
+    bs_prior_finish(counts);
+
+    // How it'd look if every fleet was placed completely at random, to compare against
+    prior_counts_t* random = calloc(1, sizeof(prior_counts_t));
+    if(random == NULL) return 1;
+    bs_prior_clear(random);
+
+    rng_t rng;
+    bs_rng_seed(&rng, 1);
+    replay_game_t fake;
+    memset(&fake, 0, sizeof(fake));
+    for(uint32_t i = 0; i < ANALYZE_BASELINE; i++) {
+        uint8_t picks[FLEET_SIZE];
+        bs_fleet_pick(NULL, &rng, picks);
+        for(uint8_t s = 0; s < FLEET_SIZE; s++) {
+            const placement_t* p = &bs_ship_placements[s].list[picks[s]];
+            fake.fleet[0][s] = p->cell | (p->rotation ? REPLAY_ROTATED : 0);
+            fake.fleet[1][s] = REPLAY_NONE;
+        }
+        bs_prior_count(random, &fake, PRIOR_SIDE_A);
+    }
+
+    printf("bsbot_analyze: %u logs, %llu games, %u threads\n", path_count, (unsigned long long)games, pool.workers);
+    printf("read:      %.1f games/s, %.1f MB/s (%.3fs)\n", (double)games / seconds, ((double)bytes / (1024.0 * 1024.0)) / seconds, seconds);
+    printf("fleets:    %llu whole, %llu players' first shots\n\n", (unsigned long long)counts->fleets, (unsigned long long)counts->openings);
+
+    uint64_t occupied[BB_CELLS];
+    for(uint8_t c = 0; c < BB_CELLS; c++) {
+        occupied[c] = 0;
+        for(uint8_t s = 0; s < FLEET_SIZE; s++) occupied[c] += counts->cells[s][c];
+    }
+    bs_analyze_heatmap("Ships (% of fleets with a ship on each cell)", occupied, counts->fleets);
+    printf("\n");
+    bs_analyze_heatmap("First shot (% of players)", counts->opening[0], counts->openings);
+    printf("\n");
+
+    uint64_t opening[BB_CELLS] = { 0 };
+    uint64_t shots = 0;
+    for(uint8_t ply = 0; ply < PRIOR_OPENING; ply++) {
+        for(uint8_t c = 0; c < BB_CELLS; c++) {
+            opening[c] += counts->opening[ply][c];
+            shots += counts->opening[ply][c];
+        }
+    }
+    char title[64];
+    snprintf(title, sizeof(title), "First %d shots (%% of those shots)", PRIOR_OPENING);
+    bs_analyze_heatmap(title, opening, shots);
+    printf("\n");
+
+    const char* names[FLEET_SIZE] = { "AC", "BS", "DS", "SB", "PB" };
+    printf("Ships next to each other (%% of fleets, random fleets in brackets):\n   ");
+    for(uint8_t j = 1; j < FLEET_SIZE; j++) printf("           %s", names[j]);
+    printf("\n");
+    for(uint8_t i = 0; i < FLEET_SIZE - 1; i++) {
+        printf("%s ", names[i]);
+        for(uint8_t j = 1; j < FLEET_SIZE; j++) {
+            if(j <= i) {
+                printf("             ");
+                continue;
+            }
+            double seen = counts->fleets ? (100.0 * (double)counts->touching[i][j]) / (double)counts->fleets : 0.0;
+            double expected = (100.0 * (double)random->touching[i][j]) / (double)random->fleets;
+            printf(" %5.1f (%4.1f)", seen, expected);
+        }
+        printf("\n");
+    }
+    printf("Pairs touching per fleet: ");
+    for(uint8_t n = 0; n <= PRIOR_PAIRS; n++) {
+        if(counts->touching_pairs[n] == 0 && random->touching_pairs[n] == 0) continue;
+        double seen = counts->fleets ? (100.0 * (double)counts->touching_pairs[n]) / (double)counts->fleets : 0.0;
+        double expected = (100.0 * (double)random->touching_pairs[n]) / (double)random->fleets;
+        printf("%u: %.1f%% (%.1f%%)  ", n, seen, expected);
+    }
+    printf("\n\n");
+
+    uint64_t all_shots = 0, own = 0;
+    for(uint8_t c = 0; c < BB_CELLS; c++) {
+        all_shots += counts->shots[c];
+        own += counts->own[c];
+    }
+    if(all_shots > 0) {
+        // 17 of the 100 cells have their own ships on, so shooting blind would land there 17% of the time
+        printf("Shots at cells with the shooter's own ships: %.1f%% (17.0%% if it made no difference)\n\n", (100.0 * (double)own) / (double)all_shots);
+    }
+
+    if(!bs_prior_write(out, counts)) {
+        printf("couldn't write the prior %s\n", out);
+        return 1;
+    }
+    printf("wrote %s\n", out);
+
+    bs_pool_destroy(&pool);
+    for(uint32_t l = 0; l < path_count; l++) bs_replay_close(&logs[l]);
+    free(random);
+    free(ctx.counts);
+    free(ctx.games);
+    free(ctx.blocks);
+    free(logs);
+    free(paths);
+    return 0;
+}
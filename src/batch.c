@@ -0,0 +1,178 @@
+/*
+    BSBOT made by William Dawson (MrBisquit on GitHub)
+    https://wtdawson.info
+
+    --------------------------------------------------------------------------------------------
+
+    Lockstep batches (See batch.h)
+
+    The kernels themselves are in batch_kernel.h, built here for the default (SSE2 on x86), and
+    in batch_avx2.c for AVX2. Which one a batch uses is picked when it's set up.
+
+    --------------------------------------------------------------------------------------------
+
+ *  License:    SPDX-License-Identifier: MIT
+ *              See LICENSE file in the project root for full license text.
+*/
+
+#include <stdlib.h>
+#include <string.h>
+#include "batch.h"
+#include "placement.h"
+#include "platform.h"
+
+#define BATCH_KERNEL bs_batch_pick_default
+#include "batch_kernel.h"
+
+#if defined(BSBOT_BATCH_AVX2) && !defined(BSBOT_BATCH_SCALAR)
+void bs_batch_pick_avx2(batch_t* batch, const bb_t starts[6][2]); // batch_avx2.c
+#endif
+
+/// @brief Whether the AVX2 kernel was built, and the CPU it's running on has AVX2
+static bool bs_batch_avx2(void) {
+#if defined(BSBOT_BATCH_AVX2) && !defined(BSBOT_BATCH_SCALAR)
+    return (bs_cpu_features() & BS_CPU_AVX2) != 0;
+#else
+    return false;
+#endif
+}
+
+/// @brief Gets which SIMD instructions batches use on this machine
+/// @return "avx2", "sse2" or "scalar"
+const char* bs_batch_isa(void) {
+    return bs_batch_avx2() ? "avx2" : BATCH_ISA;
+}
+
+/// @brief Sets up a batch (every game starts over, use `bs_batch_set` to give it ships)
+/// @param batch The batch
+/// @param games How many games it holds
+/// @return Returns `true` if it could allocate it
+bool bs_batch_init(batch_t* batch, uint32_t games) {
+    bs_placement_init();
+    memset(batch, 0, sizeof(batch_t));
+
+    uint32_t capacity = ((games + BATCH_LANES_MAX - 1) / BATCH_LANES_MAX) * BATCH_LANES_MAX; // Enough for any of the kernels
+    uint32_t words = (FLEET_SIZE * 2) + FLEET_SIZE + 6;
+
+    batch->memory = calloc(capacity, (sizeof(uint64_t) * words) + 3);
+    if(batch->memory == NULL) return false;
+
+    uint64_t* next = batch->memory;
+    for(uint8_t s = 0; s < FLEET_SIZE; s++) {
+        batch->ships[s][0] = next; next += capacity;
+        batch->ships[s][1] = next; next += capacity;
+        batch->alive[s] = next; next += capacity;
+    }
+    for(uint8_t w = 0; w < 2; w++) {
+        batch->hits[w] = next; next += capacity;
+        batch->blocked[w] = next; next += capacity;
+        batch->shot[w] = next; next += capacity;
+    }
+
+    uint8_t* bytes = (uint8_t*)next;
+    batch->afloat = bytes;
+    batch->shots = bytes + capacity;
+    batch->moves = bytes + (capacity * 2);
+
+    batch->games = games;
+    batch->capacity = capacity;
+    batch->avx2 = bs_batch_avx2();
+    return true;
+}
+
+/// @brief Frees a batch
+void bs_batch_destroy(batch_t* batch) {
+    free(batch->memory);
+    memset(batch, 0, sizeof(batch_t));
+}
+
+/// @brief Starts a new game in one slot
+/// @param batch The batch
+/// @param game The slot
+/// @param places Each ship's cells (index is PLACE_x - 1)
+void bs_batch_set(batch_t* batch, uint32_t game, const bb_t places[FLEET_SIZE]) {
+    for(uint8_t s = 0; s < FLEET_SIZE; s++) {
+        batch->ships[s][0][game] = places[s].lo;
+        batch->ships[s][1][game] = places[s].hi;
+        batch->alive[s][game] = ~0ULL;
+    }
+    for(uint8_t w = 0; w < 2; w++) {
+        batch->hits[w][game] = 0;
+        batch->blocked[w][game] = 0;
+        batch->shot[w][game] = 0;
+    }
+
+    batch->afloat[game] = FLEET_ALL;
+    batch->shots[game] = 0;
+    batch->moves[game] = BB_CELLS;
+}
+
+/// @brief Works out every game's next shot (into `moves`)
+/// @param batch The batch
+void bs_batch_pick(batch_t* batch) {
+    // Cells each length of ship can start on without going off the grid
+    bb_t starts[6][2];
+    for(uint8_t length = 2; length <= 5; length++) {
+        starts[length][0] = bs_bb_empty();
+        starts[length][1] = bs_bb_empty();
+        for(uint8_t y = 0; y < BB_SIZE; y++) {
+            for(uint8_t x = 0; x < BB_SIZE; x++) {
+                if(y + length <= BB_SIZE) bs_bb_set(&starts[length][0], bs_bb_index(x, y));
+                if(x + length <= BB_SIZE) bs_bb_set(&starts[length][1], bs_bb_index(x, y));
+            }
+        }
+    }
+
+#if defined(BSBOT_BATCH_AVX2) && !defined(BSBOT_BATCH_SCALAR)
+    if(batch->avx2) {
+        bs_batch_pick_avx2(batch, starts);
+        return;
+    }
+#endif
+    bs_batch_pick_default(batch, starts);
+}
+
+/// @brief Fires every unfinished game's shot from `moves`
+/// @param batch The batch
+/// @return How many games still aren't over
+uint32_t bs_batch_fire(batch_t* batch) {
+    uint32_t playing = 0;
+
+    for(uint32_t game = 0; game < batch->games; game++) {
+        if(batch->afloat[game] == 0) continue;
+
+        uint8_t cell = batch->moves[game];
+        if(cell >= BB_CELLS) {
+            batch->afloat[game] = 0; // Nowhere left to shoot (can't happen with a legal fleet)
+            continue;
+        }
+
+        uint8_t w = cell / 64;
+        uint64_t bit = 1ULL << (cell % 64);
+        batch->shot[w][game] |= bit;
+        batch->shots[game]++;
+
+        uint8_t ship = FLEET_SIZE;
+        for(uint8_t s = 0; s < FLEET_SIZE && ship == FLEET_SIZE; s++) {
+            if(batch->ships[s][w][game] & bit) ship = s;
+        }
+
+        if(ship == FLEET_SIZE) {
+            batch->blocked[w][game] |= bit;
+        } else if((batch->ships[ship][0][game] & ~batch->shot[0][game]) == 0 && (batch->ships[ship][1][game] & ~batch->shot[1][game]) == 0) {
+            // Sunk, so it's out of the way, and its cells aren't open hits any more
+            batch->alive[ship][game] = 0;
+            batch->afloat[game] &= ~(1 << ship);
+            for(uint8_t i = 0; i < 2; i++) {
+                batch->blocked[i][game] |= batch->ships[ship][i][game];
+                batch->hits[i][game] &= ~batch->ships[ship][i][game];
+            }
+        } else {
+            batch->hits[w][game] |= bit;
+        }
+
+        if(batch->afloat[game] != 0) playing++;
+    }
+
+    return playing;
+}
@@ -0,0 +1,62 @@
+/*
+    BSBOT made by William Dawson (MrBisquit on GitHub)
+    https://wtdawson.info
+
+    --------------------------------------------------------------------------------------------
+
+    Lockstep batches
+
+    Plays lots of games against the density bot (see density.c) at the same time, one game per
+    SIMD lane. Every game's bitboards are kept structure-of-arrays (all the games' low words
+    next to each other, then all the high words, ...), so one instruction works on the same
+    board of several games at once: 4 games with AVX2, 2 with SSE2, or 1 at a time without
+    either. The picks come out the same as `BOT_MODE_DENSITY` would make, they're just worked
+    out differently: every placement of a ship is added up at once as bitboards (bit-sliced
+    counters, see batch_kernel.h), rather than a placement at a time.
+
+    SSE2 is always there on x86-64, and AVX2 is used if the CPU has it (it's checked when a
+    batch is set up). Defining BSBOT_BATCH_SCALAR forces the plain C version.
+
+    --------------------------------------------------------------------------------------------
+
+ *  License:    SPDX-License-Identifier: MIT
+ *              See LICENSE file in the project root for full license text.
+*/
+
+#ifndef BSBOT_BATCH_H
+#define BSBOT_BATCH_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "bitboard.h"
+#include "knowledge.h"
+
+#define BATCH_LANES_MAX 4 // Games per vector with the widest instructions (AVX2)
+
+typedef struct {
+    uint32_t games;                     // Games in the batch
+    uint32_t capacity;                  // `games`, rounded up to a whole number of lanes
+    bool avx2;                          // Picks with AVX2 (if the CPU has it)
+
+    // One entry per game for each of these ([0] = low word, [1] = high word)
+    uint64_t* ships[FLEET_SIZE][2];     // Each ship's cells
+    uint64_t* alive[FLEET_SIZE];        // All ones while the ship's afloat, 0 once it's sunk
+    uint64_t* hits[2];                  // Hits on ships that haven't been sunk
+    uint64_t* blocked[2];               // Misses, and the cells of sunk ships
+    uint64_t* shot[2];                  // Every cell that's been shot
+
+    uint8_t* afloat;                    // Ships afloat (0 = the game's over)
+    uint8_t* shots;                     // Shots taken
+    uint8_t* moves;                     // Next shot (from `bs_batch_pick`)
+
+    void* memory;
+} batch_t;
+
+bool bs_batch_init(batch_t* batch, uint32_t games);
+void bs_batch_destroy(batch_t* batch);
+void bs_batch_set(batch_t* batch, uint32_t game, const bb_t places[FLEET_SIZE]);
+void bs_batch_pick(batch_t* batch);
+uint32_t bs_batch_fire(batch_t* batch);
+const char* bs_batch_isa(void);
+
+#endif
@@ -0,0 +1,23 @@
+/*
+    BSBOT made by William Dawson (MrBisquit on GitHub)
+    https://wtdawson.info
+
+    --------------------------------------------------------------------------------------------
+
+    Lockstep batch kernels with AVX2 (See batch_kernel.h)
+
+    This file is built with AVX2 turned on (see CMakeLists.txt), so nothing else can go in it,
+    it'd only run on CPUs that have it. batch.c only calls it if the CPU does.
+
+    --------------------------------------------------------------------------------------------
+
+ *  License:    SPDX-License-Identifier: MIT
+ *              See LICENSE file in the project root for full license text.
+*/
+
+#if defined(__AVX2__) && !defined(BSBOT_BATCH_SCALAR)
+#define BATCH_KERNEL bs_batch_pick_avx2
+#include "batch_kernel.h"
+#else
+typedef int bs_batch_avx2_unused; // C doesn't allow an empty file
+#endif
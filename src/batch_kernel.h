@@ -0,0 +1,289 @@
+/*
+    BSBOT made by William Dawson (MrBisquit on GitHub)
+    https://wtdawson.info
+
+    --------------------------------------------------------------------------------------------
+
+    Lockstep batch kernels (See batch.h)
+
+    The kernels are written once against a tiny set of vector operations (`vec_t`, one game
+    per lane), and those are defined for AVX2, SSE2 and plain C below, going by what the file
+    that includes this is being built for. batch.c includes it for the default (SSE2 on x86),
+    and batch_avx2.c includes it again built with AVX2 turned on, so there's no include guard.
+    Define `BATCH_KERNEL` as the name of the function it makes first.
+
+    Everything is counted with bit-sliced counters (one bitboard for each bit of the count),
+    so every cell of every lane goes up at once and there's never a loop over the cells:
+
+    - A placement with no hits is worth 1, so before there are any hits the counts are just
+      the placements that aren't blocked, added on a cell at a time of their length.
+    - Once there are hits, the hits each placement covers are counted the same way, and the
+      placements are split up by that. Each hit is worth 16 times as much (see
+      `bs_density_weights`), so each lot is added onto the total 4 bits further up.
+
+    Then the busiest cell is found by going down the bits of the total.
+
+    --------------------------------------------------------------------------------------------
+
+ *  License:    SPDX-License-Identifier: MIT
+ *              See LICENSE file in the project root for full license text.
+*/
+
+#include "batch.h"
+#include "density.h"
+
+#define BATCH_PLANES        6   // Bits in one count (a cell can have at most 2 * (5 + 4 + 3 + 3 + 2) = 34 placements on it)
+#define BATCH_HIT_PLANES    3   // Bits in how many hits a placement covers (up to 5)
+#define BATCH_CLASSES       5   // Placements over 0 to 4 hits (all 5 of the longest ship is worth nothing)
+#define BATCH_TOTAL_PLANES  22  // Bits in a cell's total (34 placements at 16^4 at most)
+
+#if !defined(BSBOT_BATCH_SCALAR) && defined(__AVX2__)
+#include <immintrin.h>
+#define BATCH_ISA "avx2"
+#define VEC_LANES 4
+
+typedef __m256i vec_t;
+static inline vec_t v_load(const uint64_t* p) { return _mm256_loadu_si256((const __m256i*)p); }
+static inline void v_store(uint64_t* p, vec_t a) { _mm256_storeu_si256((__m256i*)p, a); }
+static inline vec_t v_set1(uint64_t x) { return _mm256_set1_epi64x((long long)x); }
+static inline vec_t v_and(vec_t a, vec_t b) { return _mm256_and_si256(a, b); }
+static inline vec_t v_andnot(vec_t a, vec_t b) { return _mm256_andnot_si256(b, a); }
+static inline vec_t v_or(vec_t a, vec_t b) { return _mm256_or_si256(a, b); }
+static inline vec_t v_xor(vec_t a, vec_t b) { return _mm256_xor_si256(a, b); }
+static inline vec_t v_shr(vec_t a, int n) { return _mm256_srl_epi64(a, _mm_cvtsi32_si128(n)); }
+static inline vec_t v_shl(vec_t a, int n) { return _mm256_sll_epi64(a, _mm_cvtsi32_si128(n)); }
+static inline vec_t v_eqz(vec_t a) { return _mm256_cmpeq_epi64(a, _mm256_setzero_si256()); }
+static inline vec_t v_blend(vec_t m, vec_t a, vec_t b) { return _mm256_blendv_epi8(b, a, m); }
+static inline bool v_any(vec_t a) { return !_mm256_testz_si256(a, a); }
+
+#elif !defined(BSBOT_BATCH_SCALAR) && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#include <emmintrin.h>
+#define BATCH_ISA "sse2"
+#define VEC_LANES 2
+
+typedef __m128i vec_t;
+static inline vec_t v_load(const uint64_t* p) { return _mm_loadu_si128((const __m128i*)p); }
+static inline void v_store(uint64_t* p, vec_t a) { _mm_storeu_si128((__m128i*)p, a); }
+static inline vec_t v_set1(uint64_t x) { return _mm_set1_epi64x((long long)x); }
+static inline vec_t v_and(vec_t a, vec_t b) { return _mm_and_si128(a, b); }
+static inline vec_t v_andnot(vec_t a, vec_t b) { return _mm_andnot_si128(b, a); }
+static inline vec_t v_or(vec_t a, vec_t b) { return _mm_or_si128(a, b); }
+static inline vec_t v_xor(vec_t a, vec_t b) { return _mm_xor_si128(a, b); }
+static inline vec_t v_shr(vec_t a, int n) { return _mm_srl_epi64(a, _mm_cvtsi32_si128(n)); }
+static inline vec_t v_shl(vec_t a, int n) { return _mm_sll_epi64(a, _mm_cvtsi32_si128(n)); }
+static inline vec_t v_blend(vec_t m, vec_t a, vec_t b) { return _mm_or_si128(_mm_and_si128(m, a), _mm_andnot_si128(m, b)); }
+static inline bool v_any(vec_t a) { return _mm_movemask_epi8(_mm_cmpeq_epi8(a, _mm_setzero_si128())) != 0xFFFF; }
+
+// SSE2 can only compare 32 bits at a time, so both halves have to agree
+static inline vec_t v_eqz(vec_t a) {
+    vec_t m = _mm_cmpeq_epi32(a, _mm_setzero_si128());
+    return _mm_and_si128(m, _mm_shuffle_epi32(m, _MM_SHUFFLE(2, 3, 0, 1)));
+}
+
+#else
+#define BATCH_ISA "scalar"
+#define VEC_LANES 1
+
+typedef uint64_t vec_t;
+static inline vec_t v_load(const uint64_t* p) { return *p; }
+static inline void v_store(uint64_t* p, vec_t a) { *p = a; }
+static inline vec_t v_set1(uint64_t x) { return x; }
+static inline vec_t v_and(vec_t a, vec_t b) { return a & b; }
+static inline vec_t v_andnot(vec_t a, vec_t b) { return a & ~b; }
+static inline vec_t v_or(vec_t a, vec_t b) { return a | b; }
+static inline vec_t v_xor(vec_t a, vec_t b) { return a ^ b; }
+static inline vec_t v_shr(vec_t a, int n) { return a >> n; }
+static inline vec_t v_shl(vec_t a, int n) { return a << n; }
+static inline vec_t v_eqz(vec_t a) { return a == 0 ? ~0ULL : 0; }
+static inline vec_t v_blend(vec_t m, vec_t a, vec_t b) { return (m & a) | (~m & b); }
+static inline bool v_any(vec_t a) { return a != 0; }
+#endif
+
+/// @brief A bitboard for every lane
+typedef struct {
+    vec_t lo;
+    vec_t hi;
+} vbb_t;
+
+static inline vbb_t vbb_load(uint64_t* const words[2], uint32_t game) {
+    return (vbb_t){ .lo = v_load(&words[0][game]), .hi = v_load(&words[1][game]) };
+}
+
+static inline vbb_t vbb_set1(bb_t a) {
+    return (vbb_t){ .lo = v_set1(a.lo), .hi = v_set1(a.hi) };
+}
+
+static inline vbb_t vbb_and(vbb_t a, vbb_t b) {
+    return (vbb_t){ .lo = v_and(a.lo, b.lo), .hi = v_and(a.hi, b.hi) };
+}
+
+/// @brief `a` without anything in `b`
+static inline vbb_t vbb_andnot(vbb_t a, vbb_t b) {
+    return (vbb_t){ .lo = v_andnot(a.lo, b.lo), .hi = v_andnot(a.hi, b.hi) };
+}
+
+static inline vbb_t vbb_or(vbb_t a, vbb_t b) {
+    return (vbb_t){ .lo = v_or(a.lo, b.lo), .hi = v_or(a.hi, b.hi) };
+}
+
+static inline vbb_t vbb_xor(vbb_t a, vbb_t b) {
+    return (vbb_t){ .lo = v_xor(a.lo, b.lo), .hi = v_xor(a.hi, b.hi) };
+}
+
+/// @brief Whether any lane has any cell set
+static inline bool vbb_any(vbb_t a) {
+    return v_any(v_or(a.lo, a.hi));
+}
+
+/// @brief Every cell that isn't set (and nothing past cell 99)
+static inline vbb_t vbb_not(vbb_t a) {
+    return (vbb_t){ .lo = v_xor(a.lo, v_set1(~0ULL)), .hi = v_xor(a.hi, v_set1(BB_HI_MASK)) };
+}
+
+/// @brief Moves every bit down `n` cells (1 to 63)
+static inline vbb_t vbb_shr(vbb_t a, int n) {
+    return (vbb_t){ .lo = v_or(v_shr(a.lo, n), v_shl(a.hi, 64 - n)), .hi = v_shr(a.hi, n) };
+}
+
+/// @brief Moves every bit up `n` cells (1 to 63), dropping anything past cell 99
+static inline vbb_t vbb_shl(vbb_t a, int n) {
+    return (vbb_t){ .lo = v_shl(a.lo, n), .hi = v_and(v_or(v_shl(a.hi, n), v_shr(a.lo, 64 - n)), v_set1(BB_HI_MASK)) };
+}
+
+/// @brief Adds 1 onto a bit-sliced counter on every cell in `carry`
+static inline void vbb_count(vbb_t* planes, uint8_t count, vbb_t carry) {
+    for(uint8_t b = 0; b < count; b++) {
+        vbb_t next = vbb_and(planes[b], carry);
+        planes[b] = vbb_xor(planes[b], carry);
+        carry = next;
+    }
+}
+
+/// @brief Adds a count onto the total, `shift` bits up (so it's multiplied by 2^shift)
+static inline void vbb_add(vbb_t total[BATCH_TOTAL_PLANES], const vbb_t planes[BATCH_PLANES], uint8_t shift) {
+    vbb_t carry = vbb_set1(bs_bb_empty());
+    for(uint8_t b = 0; b < BATCH_PLANES; b++) {
+        vbb_t t = total[shift + b];
+        vbb_t x = planes[b];
+        vbb_t half = vbb_xor(t, x);
+        total[shift + b] = vbb_xor(half, carry);
+        carry = vbb_or(vbb_and(t, x), vbb_and(half, carry));
+    }
+
+    // Above the count it's only the carry left to go up
+    for(uint8_t b = shift + BATCH_PLANES; b < BATCH_TOTAL_PLANES && vbb_any(carry); b++) {
+        vbb_t next = vbb_and(total[b], carry);
+        total[b] = vbb_xor(total[b], carry);
+        carry = next;
+    }
+}
+
+/// @brief Every cell a placement of one ship (the way it's turned) could start on, where none
+/// of its cells are blocked (and only in the lanes where it's afloat)
+static inline vbb_t bs_batch_starts(vbb_t free, bb_t starts, uint8_t length, int step, vec_t alive) {
+    vbb_t starts_free = vbb_and(free, vbb_set1(starts));
+    for(uint8_t i = 1; i < length; i++) starts_free = vbb_and(starts_free, vbb_shr(free, step * i));
+    starts_free.lo = v_and(starts_free.lo, alive);
+    starts_free.hi = v_and(starts_free.hi, alive);
+    return starts_free;
+}
+
+/// @brief Picks the busiest cell that hasn't been shot (the lowest one if there's a tie) for each lane
+static void bs_batch_best(batch_t* batch, uint32_t game, const vbb_t* planes, uint8_t count) {
+    // Keep whichever cells have the top bit set, then the next, and so on
+    vbb_t candidates = vbb_not(vbb_load(batch->shot, game));
+    for(int b = count - 1; b >= 0; b--) {
+        vbb_t top = vbb_and(candidates, planes[b]);
+        vec_t none = v_eqz(v_or(top.lo, top.hi));
+        candidates.lo = v_blend(none, candidates.lo, top.lo);
+        candidates.hi = v_blend(none, candidates.hi, top.hi);
+    }
+
+    uint64_t lo[VEC_LANES];
+    uint64_t hi[VEC_LANES];
+    v_store(lo, candidates.lo);
+    v_store(hi, candidates.hi);
+    for(uint32_t l = 0; l < VEC_LANES; l++) batch->moves[game + l] = bs_bb_lsb((bb_t){ .lo = lo[l], .hi = hi[l] });
+}
+
+/// @brief Picks for lanes with no hits, where every placement counts the same
+static void bs_batch_pick_hunt(batch_t* batch, uint32_t game, const bb_t starts[6][2]) {
+    vbb_t free = vbb_not(vbb_load(batch->blocked, game));
+    vbb_t planes[BATCH_PLANES];
+    for(uint8_t b = 0; b < BATCH_PLANES; b++) planes[b] = vbb_set1(bs_bb_empty());
+
+    for(uint8_t s = 0; s < FLEET_SIZE; s++) {
+        vec_t alive = v_load(&batch->alive[s][game]);
+        if(!v_any(alive)) continue;
+        uint8_t length = bs_fleet_lengths[s];
+
+        for(uint8_t rotation = 0; rotation < 2; rotation++) {
+            int step = rotation == 0 ? BB_SIZE : 1;
+            vbb_t starts_free = bs_batch_starts(free, starts[length][rotation], length, step, alive);
+
+            // Add each of its cells onto the counter
+            for(uint8_t i = 0; i < length; i++) vbb_count(planes, BATCH_PLANES, i == 0 ? starts_free : vbb_shl(starts_free, step * i));
+        }
+    }
+
+    bs_batch_best(batch, game, planes, BATCH_PLANES);
+}
+
+/// @brief Picks for lanes where some have hits, with the placements split up by how many hits
+/// they cover (like density.c weighs them)
+static void bs_batch_pick_target(batch_t* batch, uint32_t game, const bb_t starts[6][2]) {
+    vbb_t free = vbb_not(vbb_load(batch->blocked, game));
+    vbb_t hits = vbb_load(batch->hits, game);
+
+    vbb_t classes[BATCH_CLASSES][BATCH_PLANES];
+    bool used[BATCH_CLASSES] = { false };
+    for(uint8_t h = 0; h < BATCH_CLASSES; h++) {
+        for(uint8_t b = 0; b < BATCH_PLANES; b++) classes[h][b] = vbb_set1(bs_bb_empty());
+    }
+
+    for(uint8_t s = 0; s < FLEET_SIZE; s++) {
+        vec_t alive = v_load(&batch->alive[s][game]);
+        if(!v_any(alive)) continue;
+        uint8_t length = bs_fleet_lengths[s];
+
+        for(uint8_t rotation = 0; rotation < 2; rotation++) {
+            int step = rotation == 0 ? BB_SIZE : 1;
+            vbb_t starts_free = bs_batch_starts(free, starts[length][rotation], length, step, alive);
+
+            // How many hits the placement from each start covers
+            vbb_t covered[BATCH_HIT_PLANES];
+            for(uint8_t b = 0; b < BATCH_HIT_PLANES; b++) covered[b] = vbb_set1(bs_bb_empty());
+            for(uint8_t i = 0; i < length; i++) vbb_count(covered, BATCH_HIT_PLANES, i == 0 ? hits : vbb_shr(hits, step * i));
+
+            // Covering every cell with hits means it's not this ship, so that's never counted
+            for(uint8_t h = 0; h < length; h++) {
+                vbb_t these = starts_free;
+                for(uint8_t b = 0; b < BATCH_HIT_PLANES; b++) these = (h >> b) & 1 ? vbb_and(these, covered[b]) : vbb_andnot(these, covered[b]);
+                if(!vbb_any(these)) continue;
+
+                used[h] = true;
+                for(uint8_t i = 0; i < length; i++) vbb_count(classes[h], BATCH_PLANES, i == 0 ? these : vbb_shl(these, step * i));
+            }
+        }
+    }
+
+    // The total is each count times 16^hits
+    vbb_t total[BATCH_TOTAL_PLANES];
+    for(uint8_t b = 0; b < BATCH_TOTAL_PLANES; b++) total[b] = b < BATCH_PLANES ? classes[0][b] : vbb_set1(bs_bb_empty());
+    for(uint8_t h = 1; h < BATCH_CLASSES; h++) {
+        if(used[h]) vbb_add(total, classes[h], 4 * h);
+    }
+
+    bs_batch_best(batch, game, total, BATCH_TOTAL_PLANES);
+}
+
+/// @brief Works out the next shot of every game in the batch
+/// @param batch The batch (its capacity has to be a whole number of `VEC_LANES`)
+/// @param starts Cells each length of ship can start on, down ([0]) and across ([1])
+void BATCH_KERNEL(batch_t* batch, const bb_t starts[6][2]) {
+    for(uint32_t game = 0; game < batch->games; game += VEC_LANES) {
+        vbb_t hits = vbb_load(batch->hits, game);
+        if(vbb_any(hits)) bs_batch_pick_target(batch, game, starts);
+        else bs_batch_pick_hunt(batch, game, starts);
+    }
+}
@@ -0,0 +1,512 @@
+/*
+    BSBOT made by William Dawson (MrBisquit on GitHub)
+    https://wtdawson.info
+
+    --------------------------------------------------------------------------------------------
+
+    bsbot_bench
+
+    Times each of the hot helpers on its own. Every benchmark is warmed up first, then run in
+    batches (sized so a batch takes long enough for the clock to be worth reading), and each
+    batch is one sample. The numbers are per call, so they include a little loop overhead,
+    and the inputs cycle through a table so the branch predictor can't learn a single answer.
+
+    Usage: bsbot_bench [--format text|csv|json] [--samples N] [--filter NAME]
+
+    --------------------------------------------------------------------------------------------
+
+ *  License:    SPDX-License-Identifier: MIT
+ *              See LICENSE file in the project root for full license text.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "game.h"
+#include "session.h"
+#include "batch.h"
+#include "enumerate.h"
+#include "prior.h"
+#include "grid.h"
+#include "defense.h"
+#include "platform.h"
+
+#define BENCH_INPUTS        256     // Size of each input table (a power of 2)
+#define BENCH_WARMUP        16      // Batches thrown away before timing
+#define BENCH_MIN_BATCH_NS  20000   // A batch should take at least this long
+#define BENCH_LOCKSTEP      64      // Games in the lockstep batch
+#define BENCH_SESSIONS      4096    // Games going at once in the session benchmark
+
+typedef void (*bench_fn)(uint32_t i);
+
+typedef struct {
+    const char* name;
+    bench_fn fn;
+} bench_t;
+
+typedef struct {
+    const char* name;
+    uint64_t batch;
+    uint32_t samples;
+    double min;
+    double mean;
+    double p50;
+    double p99;
+} bench_result_t;
+
+typedef enum {
+    BENCH_FORMAT_TEXT,
+    BENCH_FORMAT_CSV,
+    BENCH_FORMAT_JSON
+} bench_format_t;
+
+static volatile uint64_t bench_sink; // Everything's results go in here so nothing gets optimised away
+
+static Rectangle bench_rects[BENCH_INPUTS];
+static Vector2 bench_points[BENCH_INPUTS];
+static Vector2 bench_grid_points[BENCH_INPUTS]; // Always on the grid (see `bs_get_grid_pos`)
+static item_t bench_items[BENCH_INPUTS];
+static bb_t bench_occupied[BENCH_INPUTS];
+static item_t bench_item_arrays[BENCH_INPUTS][5];
+static bot_t bench_bot;
+static knowledge_t bench_knowledge;
+static bb_t bench_shot;
+static batch_t bench_lockstep;
+static fleet_gen_t bench_fleet_no_touch;
+static fleet_gen_t bench_fleet_edge;
+static rng_t bench_rng;
+static session_pool_t bench_sessions;
+static prior_weights_t bench_prior;
+static grid_rules_t bench_grid_rules[2];   // The standard fleet on 10x10 and 32x32
+static grid_bot_t bench_grid_bots[2];
+static defense_model_t bench_defense;
+
+/// @brief Builds every input table, and a game that's part of the way through for the bot
+static void bs_bench_setup(void) {
+    rng_t rng;
+    bs_rng_seed(&rng, 1);
+
+    for(uint32_t i = 0; i < BENCH_INPUTS; i++) {
+        // Roughly the size of a ship being dragged around, somewhere near the grid
+        bench_rects[i] = (Rectangle){
+            .x = (float)bs_rng_below(&rng, 400),
+            .y = (float)bs_rng_below(&rng, 400),
+            .width = 16.0f + (float)bs_rng_below(&rng, 32),
+            .height = 32.0f + (float)bs_rng_below(&rng, 140)
+        };
+        bench_points[i] = (Vector2){ .x = (float)bs_rng_below(&rng, 400), .y = (float)bs_rng_below(&rng, 400) };
+        bench_grid_points[i] = (Vector2){ .x = 33.0f + (float)bs_rng_below(&rng, 330), .y = 33.0f + (float)bs_rng_below(&rng, 330) }; // Past the labels
+
+        item_t item = bs_get_item((game_item_t)bs_rng_below(&rng, 5));
+        item.rotation = bs_rng_below(&rng, 2);
+        item.relative_pos = (Vector2){ .x = (float)bs_rng_below(&rng, 10), .y = (float)bs_rng_below(&rng, 10) };
+        bench_items[i] = item;
+
+        side_t side;
+        bs_random_fleet(&side, NULL, NULL, &rng);
+        uint8_t ships = bs_rng_below(&rng, 5);
+        bench_occupied[i] = bs_bb_empty();
+        for(uint8_t s = 0; s < ships; s++) bench_occupied[i] = bs_bb_or(bench_occupied[i], side.places[s]);
+
+        // Somewhere between empty and full
+        uint8_t filled = bs_rng_below(&rng, 6);
+        for(uint8_t s = 0; s < 5; s++) {
+            bench_item_arrays[i][s] = bs_get_item((game_item_t)s);
+            if(s >= filled) bench_item_arrays[i][s].type = PLACE_HIT_INVALID;
+        }
+    }
+
+    // The general code, part of the way through a game on each size
+    static const uint8_t lengths[FLEET_SIZE] = { 5, 4, 3, 3, 2 };
+    bs_grid_rules(&bench_grid_rules[0], 10, 10, lengths, FLEET_SIZE);
+    bs_grid_rules(&bench_grid_rules[1], 32, 32, lengths, FLEET_SIZE);
+    for(uint8_t g = 0; g < 2; g++) {
+        grid_side_t side;
+        bs_grid_random_fleet(&side, &bench_grid_rules[g], &rng);
+        bs_grid_bot_init(&bench_grid_bots[g], &bench_grid_rules[g]);
+
+        for(uint16_t shots = 0; shots < bench_grid_rules[g].cells * 3 / 10; shots++) {
+            uint16_t cell = bs_grid_bot_pick(&bench_grid_bots[g]);
+            uint8_t result = bs_grid_fire(&side, cell);
+            grid_bits_t sunk;
+            if(result != PLACE_HIT_INVALID && (result & HIT_SUNK)) bs_grid_ship(&side, (result & ~HIT_SUNK) - 1, &sunk);
+            bs_grid_bot_observe(&bench_grid_bots[g], cell, result, &sunk);
+        }
+    }
+
+    // Nothing's been learned, but starting from it costs the same either way
+    prior_counts_t* counts = calloc(1, sizeof(prior_counts_t));
+    if(counts != NULL) {
+        bs_prior_clear(counts);
+        bs_prior_weights(counts, &bench_prior);
+        free(counts);
+    }
+
+    // 30 shots into a game, so the exact mode can finish and the sampler has hits to work with
+    side_t target;
+    bs_random_fleet(&target, NULL, NULL, &rng);
+    bs_bot_init(&bench_bot);
+    bench_bot.mode = BOT_MODE_HEURISTIC;
+    bench_bot.randomness = false;
+
+    for(uint8_t shots = 0; shots < 30; shots++) {
+        uint8_t cell = bs_bot_pick(&bench_bot, bs_bb_or(target.hitmap, target.missmap));
+        uint8_t result = bs_fire(&target, cell);
+        bb_t sunk = bs_bb_empty();
+        if(result != PLACE_HIT_INVALID && (result & HIT_SUNK)) sunk = target.places[(result & ~HIT_SUNK) - 1];
+        bs_bot_observe(&bench_bot, cell, result, sunk);
+    }
+
+    bench_knowledge = bs_side_knowledge(&target);
+    bench_shot = bs_bb_or(target.hitmap, target.missmap);
+    bench_bot.sampling.max_samples = 16384;
+    bench_bot.sampling.max_time_ns = 0;
+    bench_bot.sampling.confidence = 0.0f;
+
+    fleet_rules_t no_touch = { .no_touch = true };
+    fleet_rules_t edge = { .edge_bias = 1.0f };
+    bs_fleet_init(&bench_fleet_no_touch, &no_touch);
+    bs_fleet_init(&bench_fleet_edge, &edge);
+    bs_rng_seed(&bench_rng, 2);
+
+    // A batch of games 20 shots in, so some lanes are hunting and some have hits
+    bs_batch_init(&bench_lockstep, BENCH_LOCKSTEP);
+    for(uint32_t g = 0; g < BENCH_LOCKSTEP; g++) {
+        side_t side;
+        bs_random_fleet(&side, NULL, NULL, &rng);
+        bs_batch_set(&bench_lockstep, g, side.places);
+    }
+    for(uint8_t shots = 0; shots < 20; shots++) {
+        bs_batch_pick(&bench_lockstep);
+        bs_batch_fire(&bench_lockstep);
+    }
+
+    bs_session_pool_init(&bench_sessions, BENCH_SESSIONS);
+    for(uint32_t s = 0; s < BENCH_SESSIONS; s++) bs_session_open(&bench_sessions, s);
+
+    bs_defense_density(&bench_defense);
+}
+
+static void bs_bench_grid_check(uint32_t i) {
+    Rectangle rect = bench_rects[i & (BENCH_INPUTS - 1)];
+    bench_sink += bs_grid_check(rect, 0, 0).total;
+}
+
+static void bs_bench_get_grid_pos(uint32_t i) {
+    Vector2 pos = bs_get_grid_pos(0, 0, bench_grid_points[i & (BENCH_INPUTS - 1)]);
+    bench_sink += (uint64_t)pos.x + (uint64_t)pos.y;
+}
+
+static void bs_bench_rect_overlap(uint32_t i) {
+    bench_sink += bs_rect_overlap(bench_rects[i & (BENCH_INPUTS - 1)], bench_rects[(i * 7 + 3) & (BENCH_INPUTS - 1)]);
+}
+
+static void bs_bench_point_in_rect(uint32_t i) {
+    bench_sink += bs_point_in_rect(bench_points[i & (BENCH_INPUTS - 1)], bench_rects[(i * 7 + 3) & (BENCH_INPUTS - 1)]);
+}
+
+static void bs_bench_add_item(uint32_t i) {
+    item_t array[5];
+    memcpy(array, bench_item_arrays[i & (BENCH_INPUTS - 1)], sizeof(array)); // It changes the array, so work on a copy
+    bench_sink += bs_add_item(array, bench_items[i & (BENCH_INPUTS - 1)]);
+}
+
+static void bs_bench_check_add_item(uint32_t i) {
+    bench_sink += bs_check_add_item(bench_occupied[(i * 7 + 3) & (BENCH_INPUTS - 1)], bench_items[i & (BENCH_INPUTS - 1)]);
+}
+
+static void bs_bench_new_board(uint32_t i) {
+    board_t board = bs_new_board();
+    bench_sink += board.a_items[i % 5].type;
+}
+
+static void bs_bench_fleet_uniform(uint32_t i) {
+    (void)i;
+    bb_t places[FLEET_SIZE];
+    bs_fleet_generate(NULL, &bench_rng, places);
+    bench_sink += places[0].lo;
+}
+
+static void bs_bench_fleet_no_touch(uint32_t i) {
+    (void)i;
+    bb_t places[FLEET_SIZE];
+    bs_fleet_generate(&bench_fleet_no_touch, &bench_rng, places);
+    bench_sink += places[0].lo;
+}
+
+static void bs_bench_fleet_edge(uint32_t i) {
+    (void)i;
+    bb_t places[FLEET_SIZE];
+    bs_fleet_generate(&bench_fleet_edge, &bench_rng, places);
+    bench_sink += places[0].lo;
+}
+
+static void bs_bench_bot_init(uint32_t i) {
+    bot_t bot;
+    bs_bot_init(&bot);
+    bench_sink += bot.possibilities[i % 10][(i / 10) % 10];
+}
+
+static void bs_bench_bot_init_prior(uint32_t i) {
+    bot_t bot;
+    bs_bot_init(&bot);
+    bs_bot_prior(&bot, &bench_prior);
+    bench_sink += bot.possibilities[i % 10][(i / 10) % 10];
+}
+
+static void bs_bench_bot_pick(uint32_t i) {
+    (void)i;
+    bench_sink += bs_bot_pick(&bench_bot, bench_shot);
+}
+
+static void bs_bench_bot_think_density(uint32_t i) {
+    (void)i;
+    bench_bot.mode = BOT_MODE_DENSITY;
+    bs_bot_think(&bench_bot, &bench_knowledge);
+    bench_sink += bs_bot_pick(&bench_bot, bench_shot);
+}
+
+static void bs_bench_density_shot(uint32_t i) {
+    density_t d = bench_bot.density; // Includes copying it, since a shot changes it
+    uint8_t cell = i % BB_CELLS;
+    if(bs_bb_test(d.shot, cell)) return;
+
+    if(i & 1) bs_density_hit(&d, cell);
+    else bs_density_miss(&d, cell);
+    bench_sink += d.counts[cell];
+}
+
+static void bs_bench_grid_pick_10(uint32_t i) {
+    (void)i;
+    bench_sink += bs_grid_bot_pick(&bench_grid_bots[0]);
+}
+
+static void bs_bench_grid_pick_32(uint32_t i) {
+    (void)i;
+    bench_sink += bs_grid_bot_pick(&bench_grid_bots[1]);
+}
+
+static void bs_bench_batch_pick(uint32_t i) {
+    (void)i;
+    bs_batch_pick(&bench_lockstep); // Only writes the moves, so it can go again
+    bench_sink += bench_lockstep.moves[0];
+}
+
+static void bs_bench_bot_think_exact(uint32_t i) {
+    (void)i;
+    bench_bot.mode = BOT_MODE_EXACT;
+    bs_bot_think(&bench_bot, &bench_knowledge);
+    bench_sink += bs_bot_pick(&bench_bot, bench_shot);
+}
+
+static void bs_bench_bot_think_lookahead(uint32_t i) {
+    (void)i;
+    bench_bot.mode = BOT_MODE_LOOKAHEAD;
+    bench_bot.search.max_time_ns = 0; // Two shots ahead, however long that takes
+    bench_bot.search.max_depth = 2;
+    bs_bot_think(&bench_bot, &bench_knowledge);
+    bench_sink += bs_bot_pick(&bench_bot, bench_shot);
+}
+
+static void bs_bench_bot_think_mc(uint32_t i) {
+    (void)i;
+    bench_bot.mode = BOT_MODE_MONTE_CARLO;
+    bs_bot_think(&bench_bot, &bench_knowledge);
+    bench_sink += bs_bot_pick(&bench_bot, bench_shot);
+}
+
+/// @brief Places the bot's fleet, with a fixed number of tries (working out the shot orders included)
+static void bs_bench_defense(uint32_t i) {
+    defense_limits_t limits = { .iterations = 1000, .seed = i };
+    defense_result_t placed;
+    bs_defense_run(NULL, &bench_defense, &limits, &placed);
+    bench_sink += placed.picks[0];
+}
+
+/// @brief Moves one of lots of games on by one turn each (the player shoots at random, then the bot shoots back)
+static void bs_bench_session_turn(uint32_t i) {
+    session_t* session = &bench_sessions.sessions[i % BENCH_SESSIONS];
+
+    switch(session->state) {
+        case SESSION_SETUP:
+            if(bs_session_place_random(session, NULL)) bs_session_start(session);
+            session->bot.mode = BOT_MODE_DENSITY;
+            session->bot.randomness = false;
+            return;
+        case SESSION_PLAYER_TURN: {
+            bb_t shot = bs_bb_or(session->board.b.hitmap, session->board.b.missmap);
+            uint8_t cell = (uint8_t)bs_rng_below(&session->rng, BB_CELLS);
+            while(bs_bb_test(shot, cell)) cell = (cell + 1) % BB_CELLS;
+            bs_session_fire(session, cell);
+        }
+        /* fall through */
+        case SESSION_BOT_TURN:
+            bench_sink += bs_session_bot_turn(session);
+            return;
+        case SESSION_OVER:
+            bs_session_close(&bench_sessions, session);
+            bs_session_open(&bench_sessions, i); // Hands the same slot straight back
+            return;
+    }
+}
+
+static const bench_t benchmarks[] = {
+    { "grid_check", bs_bench_grid_check },
+    { "get_grid_pos", bs_bench_get_grid_pos },
+    { "rect_overlap", bs_bench_rect_overlap },
+    { "point_in_rect", bs_bench_point_in_rect },
+    { "add_item", bs_bench_add_item },
+    { "check_add_item", bs_bench_check_add_item },
+    { "new_board", bs_bench_new_board },
+    { "fleet_uniform", bs_bench_fleet_uniform },
+    { "fleet_no_touch", bs_bench_fleet_no_touch },
+    { "fleet_edge", bs_bench_fleet_edge },
+    { "bot_init", bs_bench_bot_init },
+    { "bot_init_prior", bs_bench_bot_init_prior },
+    { "bot_pick", bs_bench_bot_pick },
+    { "density_shot", bs_bench_density_shot },
+    { "bot_think_density", bs_bench_bot_think_density },
+    { "grid_pick_10", bs_bench_grid_pick_10 },
+    { "grid_pick_32", bs_bench_grid_pick_32 },
+    { "batch_pick_64", bs_bench_batch_pick },
+    { "session_turn", bs_bench_session_turn },
+    { "defense_1000", bs_bench_defense },
+    { "bot_think_exact", bs_bench_bot_think_exact },
+    { "bot_think_lookahead", bs_bench_bot_think_lookahead },
+    { "bot_think_mc", bs_bench_bot_think_mc }
+};
+
+/// @brief Times a batch of calls
+/// @return How long it took in nanoseconds
+static uint64_t bs_bench_batch(bench_fn fn, uint64_t batch, uint32_t* i) {
+    uint64_t start = bs_time_ns();
+    for(uint64_t n = 0; n < batch; n++) fn((*i)++);
+    return bs_time_ns() - start;
+}
+
+static int bs_bench_compare(const void* a, const void* b) {
+    double x = *(const double*)a;
+    double y = *(const double*)b;
+    return (x > y) - (x < y);
+}
+
+/// @brief Runs one benchmark
+/// @param bench The benchmark
+/// @param samples How many batches to time
+/// @param times Space for `samples` numbers
+/// @return The results (in nanoseconds per call)
+static bench_result_t bs_bench_run(const bench_t* bench, uint32_t samples, double* times) {
+    bench_result_t result = { .name = bench->name, .samples = samples };
+    uint32_t i = 0;
+
+    // Double the batch until it's long enough to time properly
+    uint64_t batch = 1;
+    while(batch < (1ULL << 24) && bs_bench_batch(bench->fn, batch, &i) < BENCH_MIN_BATCH_NS) batch *= 2;
+    result.batch = batch;
+
+    for(uint32_t n = 0; n < BENCH_WARMUP; n++) bs_bench_batch(bench->fn, batch, &i);
+
+    double total = 0.0;
+    for(uint32_t n = 0; n < samples; n++) {
+        times[n] = (double)bs_bench_batch(bench->fn, batch, &i) / (double)batch;
+        total += times[n];
+    }
+
+    qsort(times, samples, sizeof(double), bs_bench_compare);
+    result.min = times[0];
+    result.mean = total / samples;
+    result.p50 = times[((samples - 1) * 50) / 100];
+    result.p99 = times[((samples - 1) * 99) / 100];
+
+    return result;
+}
+
+static void bs_bench_print(const bench_result_t* r, bench_format_t format, bool first) {
+    switch(format) {
+        case BENCH_FORMAT_TEXT:
+            if(first) printf("%-18s %10s %8s %12s %12s %12s %12s\n", "benchmark", "batch", "samples", "min ns/op", "mean ns/op", "p50 ns/op", "p99 ns/op");
+            printf("%-18s %10llu %8u %12.2f %12.2f %12.2f %12.2f\n", r->name, (unsigned long long)r->batch, r->samples, r->min, r->mean, r->p50, r->p99);
+            break;
+        case BENCH_FORMAT_CSV:
+            if(first) printf("name,batch,samples,min_ns,mean_ns,p50_ns,p99_ns\n");
+            printf("%s,%llu,%u,%.3f,%.3f,%.3f,%.3f\n", r->name, (unsigned long long)r->batch, r->samples, r->min, r->mean, r->p50, r->p99);
+            break;
+        case BENCH_FORMAT_JSON:
+            printf("%s\n    { \"name\": \"%s\", \"batch\": %llu, \"samples\": %u, \"min_ns\": %.3f, \"mean_ns\": %.3f, \"p50_ns\": %.3f, \"p99_ns\": %.3f }",
+                first ? "" : ",", r->name, (unsigned long long)r->batch, r->samples, r->min, r->mean, r->p50, r->p99);
+            break;
+    }
+    fflush(stdout);
+}
+
+static void bs_bench_usage(void) {
+    printf("Usage: bsbot_bench [--format text|csv|json] [--samples N] [--filter NAME]\n");
+    printf("  --format F    How to print the results (default text)\n");
+    printf("  --samples N   Batches to time per benchmark (default 200)\n");
+    printf("  --filter NAME Only run benchmarks with NAME in their name\n");
+}
+
+/// @brief The main function
+/// @param argc Args count
+/// @param argv Args
+/// @return Return code (0 = Success, 1 = bad arguments)
+int main(int argc, char* argv[]) {
+    bench_format_t format = BENCH_FORMAT_TEXT;
+    uint32_t samples = 200;
+    const char* filter = NULL;
+
+    for(int i = 1; i < argc; i++) {
+        const char* arg = argv[i];
+        const char* value = (i + 1 < argc) ? argv[i + 1] : NULL;
+
+        if(strcmp(arg, "--help") == 0 || strcmp(arg, "-h") == 0) {
+            bs_bench_usage();
+            return 0;
+        }
+        if(value == NULL) {
+            bs_bench_usage();
+            return 1;
+        }
+
+        if(strcmp(arg, "--samples") == 0) samples = (uint32_t)strtoul(value, NULL, 10);
+        else if(strcmp(arg, "--filter") == 0) filter = value;
+        else if(strcmp(arg, "--format") == 0) {
+            if(strcmp(value, "text") == 0) format = BENCH_FORMAT_TEXT;
+            else if(strcmp(value, "csv") == 0) format = BENCH_FORMAT_CSV;
+            else if(strcmp(value, "json") == 0) format = BENCH_FORMAT_JSON;
+            else {
+                bs_bench_usage();
+                return 1;
+            }
+        } else {
+            bs_bench_usage();
+            return 1;
+        }
+        i++;
+    }
+
+    if(samples == 0) samples = 1;
+    double* times = malloc(sizeof(double) * samples);
+    if(times == NULL) return 1;
+
+    bs_enum_init();
+    bs_bench_setup();
+
+    if(format == BENCH_FORMAT_JSON) printf("{\n  \"benchmarks\": [");
+
+    bool first = true;
+    for(size_t b = 0; b < sizeof(benchmarks) / sizeof(benchmarks[0]); b++) {
+        if(filter != NULL && strstr(benchmarks[b].name, filter) == NULL) continue;
+
+        bench_result_t result = bs_bench_run(&benchmarks[b], samples, times);
+        bs_bench_print(&result, format, first);
+        first = false;
+    }
+
+    if(format == BENCH_FORMAT_JSON) printf("\n  ]\n}\n");
+
+    free(times);
+    bs_batch_destroy(&bench_lockstep);
+    return 0;
+}
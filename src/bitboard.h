@@ -0,0 +1,258 @@
+/*
+    BSBOT made by William Dawson (MrBisquit on GitHub)
+    https://wtdawson.info
+
+    --------------------------------------------------------------------------------------------
+
+    Bitboards
+
+    A 10x10 grid packed into 100 bits (two 64-bit words). Cell (x, y) is bit (y * 10) + x,
+    so rows 0-5 and the first 4 cells of row 6 live in `lo`, and the rest live in `hi`.
+
+    Everything here is `static inline` so it can be used from any file without paying for
+    a function call, since these get hammered by the bot.
+
+    --------------------------------------------------------------------------------------------
+
+ *  License:    SPDX-License-Identifier: MIT
+ *              See LICENSE file in the project root for full license text.
+*/
+
+#ifndef BSBOT_BITBOARD_H
+#define BSBOT_BITBOARD_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+#define BB_SIZE     10
+#define BB_CELLS    100
+
+#define BB_HI_MASK      0xFFFFFFFFFULL          // Bits 64-99
+#define BB_COL0_LO      0x1004010040100401ULL   // Column 0 (x = 0)
+#define BB_COL0_HI      0x4010040ULL
+#define BB_COL9_LO      0x0802008020080200ULL   // Column 9 (x = 9)
+#define BB_COL9_HI      0x802008020ULL
+
+typedef struct {
+    uint64_t lo;
+    uint64_t hi; // Only the bottom 36 bits are used
+} bb_t;
+
+/// @brief Counts the set bits in a 64-bit word
+static inline int bs_popcount64(uint64_t v) {
+#if defined(_MSC_VER)
+    return (int)__popcnt64(v);
+#else
+    return __builtin_popcountll(v);
+#endif
+}
+
+/// @brief Gets the index of the lowest set bit in a 64-bit word
+/// @note `v` must not be 0
+static inline int bs_ctz64(uint64_t v) {
+#if defined(_MSC_VER)
+    unsigned long i;
+    _BitScanForward64(&i, v);
+    return (int)i;
+#else
+    return __builtin_ctzll(v);
+#endif
+}
+
+/// @brief Gets the cell index of a grid coordinate
+static inline uint8_t bs_bb_index(uint8_t x, uint8_t y) {
+    return (uint8_t)((y * BB_SIZE) + x);
+}
+
+static inline bb_t bs_bb_empty(void) {
+    return (bb_t){ .lo = 0, .hi = 0 };
+}
+
+static inline bb_t bs_bb_full(void) {
+    return (bb_t){ .lo = ~0ULL, .hi = BB_HI_MASK };
+}
+
+/// @brief A bitboard with only one cell set
+static inline bb_t bs_bb_cell(uint8_t cell) {
+    if(cell < 64) return (bb_t){ .lo = 1ULL << cell, .hi = 0 };
+    return (bb_t){ .lo = 0, .hi = 1ULL << (cell - 64) };
+}
+
+static inline bb_t bs_bb_row(uint8_t y) {
+    bb_t r = bs_bb_empty();
+    uint8_t start = y * BB_SIZE;
+    if(start + BB_SIZE <= 64) {
+        r.lo = 0x3FFULL << start;
+    } else if(start >= 64) {
+        r.hi = 0x3FFULL << (start - 64);
+    } else {
+        // Row 6 straddles the two words
+        r.lo = 0x3FFULL << start;
+        r.hi = 0x3FFULL >> (64 - start);
+    }
+    return r;
+}
+
+static inline bb_t bs_bb_and(bb_t a, bb_t b) {
+    return (bb_t){ .lo = a.lo & b.lo, .hi = a.hi & b.hi };
+}
+
+static inline bb_t bs_bb_or(bb_t a, bb_t b) {
+    return (bb_t){ .lo = a.lo | b.lo, .hi = a.hi | b.hi };
+}
+
+static inline bb_t bs_bb_xor(bb_t a, bb_t b) {
+    return (bb_t){ .lo = a.lo ^ b.lo, .hi = a.hi ^ b.hi };
+}
+
+/// @brief Everything in `a` that isn't in `b`
+static inline bb_t bs_bb_andnot(bb_t a, bb_t b) {
+    return (bb_t){ .lo = a.lo & ~b.lo, .hi = a.hi & ~b.hi };
+}
+
+static inline bb_t bs_bb_not(bb_t a) {
+    return (bb_t){ .lo = ~a.lo, .hi = ~a.hi & BB_HI_MASK };
+}
+
+static inline bool bs_bb_is_empty(bb_t a) {
+    return (a.lo | a.hi) == 0;
+}
+
+static inline bool bs_bb_equal(bb_t a, bb_t b) {
+    return a.lo == b.lo && a.hi == b.hi;
+}
+
+static inline bool bs_bb_intersects(bb_t a, bb_t b) {
+    return ((a.lo & b.lo) | (a.hi & b.hi)) != 0;
+}
+
+static inline bool bs_bb_test(bb_t a, uint8_t cell) {
+    if(cell < 64) return (a.lo >> cell) & 1;
+    return (a.hi >> (cell - 64)) & 1;
+}
+
+static inline void bs_bb_set(bb_t* a, uint8_t cell) {
+    if(cell < 64) a->lo |= 1ULL << cell;
+    else a->hi |= 1ULL << (cell - 64);
+}
+
+static inline void bs_bb_clear(bb_t* a, uint8_t cell) {
+    if(cell < 64) a->lo &= ~(1ULL << cell);
+    else a->hi &= ~(1ULL << (cell - 64));
+}
+
+static inline int bs_bb_popcount(bb_t a) {
+    return bs_popcount64(a.lo) + bs_popcount64(a.hi);
+}
+
+/// @brief Gets the lowest set cell
+/// @return The cell index, or `BB_CELLS` if the bitboard is empty
+static inline uint8_t bs_bb_lsb(bb_t a) {
+    if(a.lo) return (uint8_t)bs_ctz64(a.lo);
+    if(a.hi) return (uint8_t)(64 + bs_ctz64(a.hi));
+    return BB_CELLS;
+}
+
+/// @brief Removes and returns the lowest set cell (for iterating over a bitboard)
+/// @note The bitboard must not be empty
+static inline uint8_t bs_bb_pop_lsb(bb_t* a) {
+    if(a->lo) {
+        uint8_t cell = (uint8_t)bs_ctz64(a->lo);
+        a->lo &= a->lo - 1;
+        return cell;
+    }
+
+    uint8_t cell = (uint8_t)(64 + bs_ctz64(a->hi));
+    a->hi &= a->hi - 1;
+    return cell;
+}
+
+/// @brief Shifts towards higher cell indices (anything past cell 99 falls off)
+static inline bb_t bs_bb_shl(bb_t a, uint8_t n) {
+    bb_t r;
+    if(n == 0) return a;
+    if(n >= 64) {
+        r.lo = 0;
+        r.hi = a.lo << (n - 64);
+    } else {
+        r.lo = a.lo << n;
+        r.hi = (a.hi << n) | (a.lo >> (64 - n));
+    }
+    r.hi &= BB_HI_MASK;
+    return r;
+}
+
+/// @brief Shifts towards lower cell indices (anything before cell 0 falls off)
+static inline bb_t bs_bb_shr(bb_t a, uint8_t n) {
+    bb_t r;
+    if(n == 0) return a;
+    if(n >= 64) {
+        r.lo = a.hi >> (n - 64);
+        r.hi = 0;
+    } else {
+        r.lo = (a.lo >> n) | (a.hi << (64 - n));
+        r.hi = a.hi >> n;
+    }
+    return r;
+}
+
+static inline bb_t bs_bb_col(uint8_t x) {
+    return bs_bb_shl((bb_t){ .lo = BB_COL0_LO, .hi = BB_COL0_HI }, x);
+}
+
+// Directional shifts. These stop cells wrapping around onto the next/previous row.
+static inline bb_t bs_bb_north(bb_t a) { return bs_bb_shr(a, BB_SIZE); }
+static inline bb_t bs_bb_south(bb_t a) { return bs_bb_shl(a, BB_SIZE); }
+static inline bb_t bs_bb_east(bb_t a) {
+    return bs_bb_shl(bs_bb_andnot(a, (bb_t){ .lo = BB_COL9_LO, .hi = BB_COL9_HI }), 1);
+}
+static inline bb_t bs_bb_west(bb_t a) {
+    return bs_bb_shr(bs_bb_andnot(a, (bb_t){ .lo = BB_COL0_LO, .hi = BB_COL0_HI }), 1);
+}
+
+/// @brief The cells directly above, below, left and right of every set cell (a diamond)
+static inline bb_t bs_bb_neighbours4(bb_t a) {
+    return bs_bb_or(bs_bb_or(bs_bb_north(a), bs_bb_south(a)), bs_bb_or(bs_bb_east(a), bs_bb_west(a)));
+}
+
+/// @brief Every cell touching a set cell, including diagonals (a 3x3 square)
+static inline bb_t bs_bb_neighbours8(bb_t a) {
+    bb_t row = bs_bb_or(a, bs_bb_or(bs_bb_east(a), bs_bb_west(a)));
+    bb_t all = bs_bb_or(row, bs_bb_or(bs_bb_north(row), bs_bb_south(row)));
+    return bs_bb_andnot(all, a);
+}
+
+/// @brief Builds the mask for a ship
+/// @param x X coordinate of the first cell
+/// @param y Y coordinate of the first cell
+/// @param places How many cells the ship takes up
+/// @param rotation 0 = extends downwards (along Y), 1 = extends right (along X), same as `item_t`
+/// @return The ship's cells, or an empty bitboard if it doesn't fit on the grid
+static inline bb_t bs_bb_ship(uint8_t x, uint8_t y, uint8_t places, uint8_t rotation) {
+    bb_t r = bs_bb_empty();
+    if(x >= BB_SIZE || y >= BB_SIZE || places == 0) return r;
+
+    if(rotation == 0) {
+        if(y + places > BB_SIZE) return r;
+        for(uint8_t i = 0; i < places; i++) bs_bb_set(&r, bs_bb_index(x, y + i));
+    } else {
+        if(x + places > BB_SIZE) return r;
+        // Horizontal ships are a run of bits, but it may cross from `lo` into `hi`
+        uint8_t start = bs_bb_index(x, y);
+        uint64_t run = (1ULL << places) - 1;
+        if(start >= 64) {
+            r.hi = run << (start - 64);
+        } else {
+            r.lo = run << start;
+            if(start + places > 64) r.hi = run >> (64 - start);
+        }
+    }
+
+    return r;
+}
+
+#endif
@@ -0,0 +1,69 @@
+/*
+    BSBOT made by William Dawson (MrBisquit on GitHub)
+    https://wtdawson.info
+
+    --------------------------------------------------------------------------------------------
+
+    Opening book (See book.h)
+
+    --------------------------------------------------------------------------------------------
+
+ *  License:    SPDX-License-Identifier: MIT
+ *              See LICENSE file in the project root for full license text.
+*/
+
+#include <stdio.h>
+#include <string.h>
+#include "book.h"
+
+/// @brief Maps a book file
+/// @param book The book
+/// @param path The file
+/// @return Returns `false` if it couldn't be opened or isn't a book (the book is left empty)
+bool bs_book_open(book_t* book, const char* path) {
+    memset(book, 0, sizeof(book_t));
+    if(!bs_map_file(&book->map, path)) return false;
+
+    // The header's read in place too, it's only ever compared
+    const book_header_t* header = book->map.data;
+    if(book->map.size < sizeof(book_header_t) || header->magic != BOOK_MAGIC || header->version != BOOK_VERSION ||
+        header->depth == 0 || header->depth > BOOK_MAX_DEPTH || header->nodes != (1ULL << header->depth) - 1 ||
+        book->map.size < sizeof(book_header_t) + header->nodes) {
+        bs_book_close(book);
+        return false;
+    }
+
+    book->moves = (const uint8_t*)book->map.data + sizeof(book_header_t);
+    book->nodes = header->nodes;
+    book->depth = header->depth;
+    return true;
+}
+
+/// @brief Unmaps a book
+void bs_book_close(book_t* book) {
+    bs_unmap_file(&book->map);
+    memset(book, 0, sizeof(book_t));
+}
+
+/// @brief Writes a book file
+/// @param path The file
+/// @param depth Shots the book covers
+/// @param moves `(1 << depth) - 1` moves, in node order
+/// @return Returns `true` if it was written
+bool bs_book_write(const char* path, uint32_t depth, const uint8_t* moves) {
+    if(depth == 0 || depth > BOOK_MAX_DEPTH) return false;
+
+    book_header_t header = {
+        .magic = BOOK_MAGIC,
+        .version = BOOK_VERSION,
+        .depth = depth,
+        .nodes = (1ULL << depth) - 1
+    };
+
+    FILE* f = fopen(path, "wb");
+    if(f == NULL) return false;
+
+    bool ok = fwrite(&header, sizeof(header), 1, f) == 1 && fwrite(moves, 1, (size_t)header.nodes, f) == header.nodes;
+    if(fclose(f) != 0) ok = false;
+    return ok;
+}
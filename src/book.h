@@ -0,0 +1,83 @@
+/*
+    BSBOT made by William Dawson (MrBisquit on GitHub)
+    https://wtdawson.info
+
+    --------------------------------------------------------------------------------------------
+
+    Opening book
+
+    Every game starts from the same empty board, so the bot's first few shots can be worked
+    out ahead of time (see bookgen.c). The book is a full binary tree stored as one flat array:
+    node 0 is the first shot, and node n's next shot is at 2n + 1 if it missed or 2n + 2 if it
+    hit. So the bot just keeps its node number, and a lookup is one array read straight out of
+    the mapped file.
+
+    File layout (little endian):
+        book_header_t
+        uint8_t moves[nodes]    Cell to shoot at (BOOK_NONE if that node can't happen)
+
+    A shot that sinks something leaves the book (the tree would be a lot bigger otherwise), and
+    so does running off the bottom of it.
+
+    It's a greedy book, not an optimal one: each node's move is the most likely cell at that
+    node, the same as the bot would pick without it, just worked out more carefully (counted
+    exactly, or with far more samples) than there's time for in a game. It doesn't look at
+    what each shot sets up. Scoring the nodes with the lookahead (search.h) instead, looking
+    2 to 4 shots ahead, came out slightly worse, because that treats the ships as independent.
+
+    --------------------------------------------------------------------------------------------
+
+ *  License:    SPDX-License-Identifier: MIT
+ *              See LICENSE file in the project root for full license text.
+*/
+
+#ifndef BSBOT_BOOK_H
+#define BSBOT_BOOK_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "platform.h"
+
+#define BOOK_MAGIC      0x4B425342 // "BSBK"
+#define BOOK_VERSION    1
+#define BOOK_MAX_DEPTH  24
+#define BOOK_NONE       0xFF        // No move (the node can't happen)
+#define BOOK_OUT        UINT64_MAX  // Node number once the game has left the book
+
+typedef struct {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t depth;     // Shots the book covers
+    uint32_t reserved;
+    uint64_t nodes;     // (1 << depth) - 1
+} book_header_t;
+
+typedef struct {
+    bs_map_t map;
+    const uint8_t* moves;
+    uint64_t nodes;
+    uint32_t depth;
+} book_t;
+
+bool bs_book_open(book_t* book, const char* path);
+void bs_book_close(book_t* book);
+bool bs_book_write(const char* path, uint32_t depth, const uint8_t* moves);
+
+/// @brief Gets the node after a shot
+/// @param book The book
+/// @param node The node the shot was from
+/// @param hit If it hit
+/// @return The next node, or `BOOK_OUT` if that's past the end of the book
+static inline uint64_t bs_book_next(const book_t* book, uint64_t node, bool hit) {
+    if(node >= book->nodes) return BOOK_OUT;
+    uint64_t next = (node * 2) + (hit ? 2 : 1);
+    return next < book->nodes ? next : BOOK_OUT;
+}
+
+/// @brief Gets the move for a node
+/// @return The cell, or `BOOK_NONE` if there isn't one
+static inline uint8_t bs_book_move(const book_t* book, uint64_t node) {
+    return node < book->nodes ? book->moves[node] : BOOK_NONE;
+}
+
+#endif
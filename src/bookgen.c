@@ -0,0 +1,167 @@
+/*
+    BSBOT made by William Dawson (MrBisquit on GitHub)
+    https://wtdawson.info
+
+    --------------------------------------------------------------------------------------------
+
+    bsbot_book
+
+    Works out the bot's opening book (see book.h) and writes it to a file. Every node is the
+    position after following the book so far (each shot either hit or missed), and its move
+    is the most likely cell, counted exactly if it can be and sampled if not (so it's a
+    greedy book, see book.h). A level only
+    depends on the ones above it, so each level is spread across every core.
+
+    Usage: bsbot_book [--depth N] [--out FILE] [--samples N] [--work N] [--seed N] [--threads N]
+
+    --------------------------------------------------------------------------------------------
+
+ *  License:    SPDX-License-Identifier: MIT
+ *              See LICENSE file in the project root for full license text.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "book.h"
+#include "enumerate.h"
+#include "montecarlo.h"
+#include "pool.h"
+
+typedef struct {
+    uint8_t* moves;
+    uint64_t first;     // First node of the level being worked out
+    uint64_t max_work;
+    mc_limits_t sampling;
+} bookgen_ctx_t;
+
+/// @brief Works out one node's move
+static void bs_bookgen_task(void* arg, uint32_t task, uint32_t worker) {
+    (void)worker;
+    bookgen_ctx_t* ctx = arg;
+    uint64_t node = ctx->first + task;
+
+    // Follow the path back up to the first shot
+    knowledge_t k = { .afloat = FLEET_ALL };
+    for(uint64_t n = node; n > 0; n = (n - 1) / 2) {
+        uint8_t cell = ctx->moves[(n - 1) / 2];
+        if(cell == BOOK_NONE) {
+            ctx->moves[node] = BOOK_NONE; // Can't get here
+            return;
+        }
+
+        if(n % 2 == 0) bs_bb_set(&k.hits, cell); // Even nodes are the ones after a hit
+        else bs_bb_set(&k.misses, cell);
+    }
+
+    float p[BB_CELLS];
+    enum_result_t result;
+    enum_limits_t limits = { .max_work = ctx->max_work };
+
+    if(bs_enum_run(&k, &limits, &result)) {
+        if(result.layouts == 0) {
+            ctx->moves[node] = BOOK_NONE;
+            return;
+        }
+        bs_enum_probabilities(&result, &k, p);
+    } else {
+        mc_limits_t sampling = ctx->sampling;
+        mc_result_t mc;
+        sampling.seed ^= node;
+        if(!bs_mc_run(NULL, &k, &sampling, &mc, p)) {
+            ctx->moves[node] = BOOK_NONE;
+            return;
+        }
+    }
+
+    // The most likely cell that hasn't been shot (the lowest one if there's a tie)
+    bb_t shot = bs_bb_or(k.hits, k.misses);
+    uint8_t best = BOOK_NONE;
+    for(uint8_t cell = 0; cell < BB_CELLS; cell++) {
+        if(bs_bb_test(shot, cell)) continue;
+        if(best == BOOK_NONE || p[cell] > p[best]) best = cell;
+    }
+
+    ctx->moves[node] = best;
+}
+
+static void bs_bookgen_usage(void) {
+    printf("Usage: bsbot_book [--depth N] [--out FILE] [--samples N] [--work N] [--seed N] [--threads N]\n");
+    printf("  --depth N     Shots the book covers (default 8, at most %d)\n", BOOK_MAX_DEPTH);
+    printf("  --out FILE    Where to write it (default opening.book)\n");
+    printf("  --samples N   Monte Carlo samples per node when it can't be counted (default 131072)\n");
+    printf("  --work N      Most work to do counting exactly before sampling (default 20000000, about 0.4s)\n");
+    printf("  --seed N      Sampling seed (default 1)\n");
+    printf("  --threads N   How many threads to use (default 0 = one per core)\n");
+}
+
+/// @brief The main function
+/// @param argc Args count
+/// @param argv Args
+/// @return Return code (0 = Success, 1 = bad arguments or it couldn't write the file)
+int main(int argc, char* argv[]) {
+    uint32_t depth = 8;
+    const char* out = "opening.book";
+    uint32_t threads = 0;
+    bookgen_ctx_t ctx = {
+        .max_work = 20000000,
+        .sampling = { .max_samples = 131072, .seed = 1 }
+    };
+
+    for(int i = 1; i < argc; i++) {
+        const char* arg = argv[i];
+        const char* value = (i + 1 < argc) ? argv[i + 1] : NULL;
+
+        if(strcmp(arg, "--help") == 0 || strcmp(arg, "-h") == 0) {
+            bs_bookgen_usage();
+            return 0;
+        }
+        if(value == NULL) {
+            bs_bookgen_usage();
+            return 1;
+        }
+
+        if(strcmp(arg, "--depth") == 0) depth = (uint32_t)strtoul(value, NULL, 10);
+        else if(strcmp(arg, "--out") == 0) out = value;
+        else if(strcmp(arg, "--samples") == 0) ctx.sampling.max_samples = strtoull(value, NULL, 10);
+        else if(strcmp(arg, "--work") == 0) ctx.max_work = strtoull(value, NULL, 10);
+        else if(strcmp(arg, "--seed") == 0) ctx.sampling.seed = strtoull(value, NULL, 10);
+        else if(strcmp(arg, "--threads") == 0) threads = (uint32_t)strtoul(value, NULL, 10);
+        else {
+            bs_bookgen_usage();
+            return 1;
+        }
+        i++;
+    }
+
+    if(depth == 0 || depth > BOOK_MAX_DEPTH) {
+        bs_bookgen_usage();
+        return 1;
+    }
+
+    uint64_t nodes = (1ULL << depth) - 1;
+    ctx.moves = malloc((size_t)nodes);
+    if(ctx.moves == NULL) return 1;
+
+    bs_enum_init(); // Not thread-safe, so before any threads start
+
+    static pool_t pool;
+    bs_pool_init(&pool, threads);
+
+    uint64_t start = bs_time_ns();
+    for(uint32_t level = 0; level < depth; level++) {
+        ctx.first = (1ULL << level) - 1;
+        bs_pool_run(&pool, bs_bookgen_task, &ctx, 1U << level);
+        printf("depth %u done (%.1fs)\n", level + 1, (double)(bs_time_ns() - start) / 1e9);
+    }
+
+    bs_pool_destroy(&pool);
+
+    bool ok = bs_book_write(out, depth, ctx.moves);
+    if(ok) printf("wrote %s (%llu nodes, first shot x %u y %u)\n", out, (unsigned long long)nodes, ctx.moves[0] % BB_SIZE, ctx.moves[0] / BB_SIZE);
+    else printf("couldn't write %s\n", out);
+
+    free(ctx.moves);
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,152 @@
+/*
+    BSBOT made by William Dawson (MrBisquit on GitHub)
+    https://wtdawson.info
+
+    --------------------------------------------------------------------------------------------
+
+    Position cache (See cache.h)
+
+    --------------------------------------------------------------------------------------------
+
+ *  License:    SPDX-License-Identifier: MIT
+ *              See LICENSE file in the project root for full license text.
+*/
+
+#include <stdlib.h>
+#include <string.h>
+#include "cache.h"
+#include "rng.h"
+
+static uint64_t zobrist_hits[BB_CELLS];
+static uint64_t zobrist_misses[BB_CELLS];
+static uint64_t zobrist_sunk[BB_CELLS];
+static uint64_t zobrist_afloat[FLEET_SIZE];
+static bool initialised = false;
+
+/// @brief Fills in the random numbers (always the same ones, so hashes don't change between runs)
+/// @note Not thread-safe, but `bs_cache_init` calls it, so it's done before any thread has a cache
+static void bs_zobrist_init(void) {
+    if(initialised) return;
+
+    uint64_t seed = 0x42534254; // "BSBT"
+    for(uint8_t c = 0; c < BB_CELLS; c++) {
+        zobrist_hits[c] = bs_splitmix64(&seed);
+        zobrist_misses[c] = bs_splitmix64(&seed);
+        zobrist_sunk[c] = bs_splitmix64(&seed);
+    }
+    for(uint8_t s = 0; s < FLEET_SIZE; s++) zobrist_afloat[s] = bs_splitmix64(&seed);
+
+    initialised = true;
+}
+
+static inline uint64_t bs_zobrist_cells(const uint64_t keys[BB_CELLS], bb_t cells) {
+    uint64_t hash = 0;
+    while(!bs_bb_is_empty(cells)) hash ^= keys[bs_bb_pop_lsb(&cells)];
+    return hash;
+}
+
+/// @brief Hashes what's known about a board
+/// @param k What's known
+/// @return The hash (never 0)
+uint64_t bs_zobrist_hash(const knowledge_t* k) {
+    bs_zobrist_init();
+
+    uint64_t hash = bs_zobrist_cells(zobrist_hits, k->hits) ^ bs_zobrist_cells(zobrist_misses, k->misses) ^ bs_zobrist_cells(zobrist_sunk, k->sunk);
+    for(uint8_t s = 0; s < FLEET_SIZE; s++) {
+        if(k->afloat & (1 << s)) hash ^= zobrist_afloat[s];
+    }
+
+    return hash ? hash : 1;
+}
+
+/// @brief Sets up a cache
+/// @param cache The cache
+/// @param bytes Roughly how much memory it can use (rounded down to a power of 2 sets)
+/// @return Returns `true` if it could allocate it
+bool bs_cache_init(cache_t* cache, size_t bytes) {
+    bs_zobrist_init();
+    memset(cache, 0, sizeof(cache_t));
+
+    size_t set_size = (sizeof(cache_entry_t) * CACHE_WAYS) + 1;
+    uint32_t sets = 1;
+    while((size_t)sets * 2 * set_size <= bytes && sets < (1U << 30)) sets *= 2;
+
+    cache->entries = calloc((size_t)sets * CACHE_WAYS, sizeof(cache_entry_t));
+    cache->hands = calloc(sets, 1);
+    if(cache->entries == NULL || cache->hands == NULL) {
+        bs_cache_destroy(cache);
+        return false;
+    }
+
+    cache->sets = sets;
+    return true;
+}
+
+/// @brief Frees a cache
+void bs_cache_destroy(cache_t* cache) {
+    free(cache->entries);
+    free(cache->hands);
+    memset(cache, 0, sizeof(cache_t));
+}
+
+/// @brief Empties a cache (and resets the counters)
+void bs_cache_clear(cache_t* cache) {
+    if(cache->entries == NULL) return;
+    memset(cache->entries, 0, sizeof(cache_entry_t) * CACHE_WAYS * cache->sets);
+    memset(cache->hands, 0, cache->sets);
+    cache->hits = 0;
+    cache->misses = 0;
+    cache->evictions = 0;
+}
+
+/// @brief Looks a position up
+/// @param cache The cache
+/// @param key The position's hash
+/// @param probabilities Filled in if it's there
+/// @return Returns `true` if it was there
+bool bs_cache_get(cache_t* cache, uint64_t key, float probabilities[BB_CELLS]) {
+    cache_entry_t* set = &cache->entries[(key & (cache->sets - 1)) * CACHE_WAYS];
+
+    for(uint8_t w = 0; w < CACHE_WAYS; w++) {
+        if(set[w].key == key) {
+            set[w].referenced = true;
+            memcpy(probabilities, set[w].probabilities, sizeof(float) * BB_CELLS);
+            cache->hits++;
+            return true;
+        }
+    }
+
+    cache->misses++;
+    return false;
+}
+
+/// @brief Stores a position (throwing another one out if the set's full)
+/// @param cache The cache
+/// @param key The position's hash
+/// @param probabilities What to store
+void bs_cache_put(cache_t* cache, uint64_t key, const float probabilities[BB_CELLS]) {
+    uint32_t index = (uint32_t)(key & (cache->sets - 1));
+    cache_entry_t* set = &cache->entries[index * CACHE_WAYS];
+    cache_entry_t* entry = NULL;
+
+    for(uint8_t w = 0; w < CACHE_WAYS && entry == NULL; w++) {
+        if(set[w].key == key || set[w].key == 0) entry = &set[w];
+    }
+
+    // Go round giving everything that's been used a second chance, until something hasn't been
+    while(entry == NULL) {
+        uint8_t* hand = &cache->hands[index];
+        cache_entry_t* e = &set[*hand];
+        *hand = (*hand + 1) % CACHE_WAYS;
+
+        if(e->referenced) e->referenced = false;
+        else {
+            entry = e;
+            cache->evictions++;
+        }
+    }
+
+    entry->key = key;
+    entry->referenced = false;
+    memcpy(entry->probabilities, probabilities, sizeof(float) * BB_CELLS);
+}
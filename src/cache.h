@@ -0,0 +1,58 @@
+/*
+    BSBOT made by William Dawson (MrBisquit on GitHub)
+    https://wtdawson.info
+
+    --------------------------------------------------------------------------------------------
+
+    Position cache
+
+    Lots of games go through exactly the same positions (especially the first few shots), so
+    the bot keeps what it worked out for each one. A position is hashed Zobrist style (a random
+    64-bit number for every hit, miss and sunk cell, and every ship afloat, XOR'd together), and
+    the cache is a fixed size, 4-way set associative table, using a clock within each set to
+    pick what to throw out.
+
+    A cache isn't thread-safe, so give every thread its own.
+
+    --------------------------------------------------------------------------------------------
+
+ *  License:    SPDX-License-Identifier: MIT
+ *              See LICENSE file in the project root for full license text.
+*/
+
+#ifndef BSBOT_CACHE_H
+#define BSBOT_CACHE_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include "bitboard.h"
+#include "knowledge.h"
+
+#define CACHE_WAYS 4
+
+typedef struct {
+    uint64_t key;                   // 0 = empty
+    bool referenced;                // Used since the clock hand last went past it
+    float probabilities[BB_CELLS];
+} cache_entry_t;
+
+typedef struct {
+    cache_entry_t* entries;         // `sets` * `CACHE_WAYS`
+    uint8_t* hands;                 // Each set's clock hand
+    uint32_t sets;                  // A power of 2
+
+    uint64_t hits;
+    uint64_t misses;
+    uint64_t evictions;
+} cache_t;
+
+uint64_t bs_zobrist_hash(const knowledge_t* k);
+
+bool bs_cache_init(cache_t* cache, size_t bytes);
+void bs_cache_destroy(cache_t* cache);
+void bs_cache_clear(cache_t* cache);
+bool bs_cache_get(cache_t* cache, uint64_t key, float probabilities[BB_CELLS]);
+void bs_cache_put(cache_t* cache, uint64_t key, const float probabilities[BB_CELLS]);
+
+#endif
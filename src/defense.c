@@ -0,0 +1,277 @@
+/*
+    BSBOT made by William Dawson (MrBisquit on GitHub)
+    https://wtdawson.info
+
+    --------------------------------------------------------------------------------------------
+
+    Fleet placement optimiser (See defense.h)
+
+    --------------------------------------------------------------------------------------------
+
+ *  License:    SPDX-License-Identifier: MIT
+ *              See LICENSE file in the project root for full license text.
+*/
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include "defense.h"
+#include "fleet.h"
+#include "platform.h"
+
+#define DEFENSE_HOT     4.0f    // Starting temperature (in shots)
+#define DEFENSE_COLD    0.05f   // Finishing temperature
+#define DEFENSE_CHECK   256     // Layouts tried between looking at the clock
+
+typedef struct {
+    uint8_t first[FLEET_SIZE][PLACEMENT_MAX][DEFENSE_ORDERS]; // When each placement gets its first shot, in each order
+    const defense_limits_t* limits;
+    uint64_t start;
+    uint64_t deadline;          // 0 = no time limit
+    defense_result_t* results;  // One per chain
+} defense_ctx_t;
+
+/// @brief Every cell the same, so it's only down to the noise (an opponent shooting at random)
+void bs_defense_uniform(defense_model_t* model) {
+    for(uint8_t c = 0; c < BB_CELLS; c++) model->heat[c] = 0.0f;
+}
+
+/// @brief An opponent that shoots every other cell first (in a checkerboard)
+void bs_defense_parity(defense_model_t* model) {
+    for(uint8_t c = 0; c < BB_CELLS; c++) model->heat[c] = (((c % BB_SIZE) + (c / BB_SIZE)) & 1) ? 0.0f : 1.0f;
+}
+
+/// @brief An opponent that shoots where the most placements fit first (like the density mode, so the middle)
+void bs_defense_density(defense_model_t* model) {
+    bs_placement_init();
+    bs_defense_uniform(model);
+
+    for(uint8_t s = 0; s < FLEET_SIZE; s++) {
+        const ship_placements_t* table = &bs_ship_placements[s];
+        for(uint8_t p = 0; p < table->count; p++) {
+            bb_t mask = table->list[p].mask;
+            while(!bs_bb_is_empty(mask)) model->heat[bs_bb_pop_lsb(&mask)] += 1.0f;
+        }
+    }
+}
+
+/// @brief An opponent that opens the way players in the replay logs did (see prior.h)
+/// @param model The model
+/// @param counts The counts (only the openings are used)
+/// @return Returns `false` if there weren't any openings counted (the model's left alone)
+bool bs_defense_learned(defense_model_t* model, const prior_counts_t* counts) {
+    if(counts->openings == 0) return false;
+
+    // Earlier shots count for more
+    for(uint8_t c = 0; c < BB_CELLS; c++) {
+        float heat = 0.0f;
+        for(uint8_t ply = 0; ply < PRIOR_OPENING; ply++) heat += (float)counts->opening[ply][c] * (float)(PRIOR_OPENING - ply);
+        model->heat[c] = heat;
+    }
+    return true;
+}
+
+/// @brief Works out when each placement gets shot first, in each of the orders
+static void bs_defense_orders(defense_ctx_t* ctx, const defense_model_t* model, rng_t* rng) {
+    float low = model->heat[0], high = model->heat[0];
+    for(uint8_t c = 1; c < BB_CELLS; c++) {
+        if(model->heat[c] < low) low = model->heat[c];
+        if(model->heat[c] > high) high = model->heat[c];
+    }
+    float scale = high > low ? 1.0f / (high - low) : 0.0f;
+
+    for(uint8_t k = 0; k < DEFENSE_ORDERS; k++) {
+        float key[BB_CELLS];
+        uint8_t rank[BB_CELLS];
+        for(uint8_t c = 0; c < BB_CELLS; c++) {
+            float noise = (float)(bs_rng_next(rng) >> 40) * (1.0f / 16777216.0f);
+            key[c] = ((model->heat[c] - low) * scale) + (DEFENSE_NOISE * noise);
+        }
+
+        // Each cell's place in the order is how many come before it
+        for(uint8_t c = 0; c < BB_CELLS; c++) {
+            rank[c] = 0;
+            for(uint8_t o = 0; o < BB_CELLS; o++) {
+                if(key[o] > key[c] || (key[o] == key[c] && o < c)) rank[c]++;
+            }
+        }
+
+        for(uint8_t s = 0; s < FLEET_SIZE; s++) {
+            const ship_placements_t* table = &bs_ship_placements[s];
+            for(uint8_t p = 0; p < table->count; p++) {
+                uint8_t first = BB_CELLS;
+                bb_t mask = table->list[p].mask;
+                while(!bs_bb_is_empty(mask)) {
+                    uint8_t r = rank[bs_bb_pop_lsb(&mask)];
+                    if(r < first) first = r;
+                }
+                ctx->first[s][p][k] = first;
+            }
+        }
+    }
+}
+
+/// @brief Scores a layout, how many shots the opponent is expected to take to find every ship
+/// @note The last ship found is what matters most, the rest only break ties between layouts
+static float bs_defense_score(const defense_ctx_t* ctx, const uint8_t picks[FLEET_SIZE]) {
+    // Which ships are straight next to each other is the same in every order
+    bb_t masks[FLEET_SIZE];
+    uint8_t touching[FLEET_SIZE] = { 0 };
+    for(uint8_t s = 0; s < FLEET_SIZE; s++) masks[s] = bs_ship_placements[s].list[picks[s]].mask;
+    for(uint8_t i = 0; i < FLEET_SIZE; i++) {
+        bb_t around = bs_bb_neighbours4(masks[i]);
+        for(uint8_t j = i + 1; j < FLEET_SIZE; j++) {
+            if(!bs_bb_intersects(around, masks[j])) continue;
+            touching[i] |= 1 << j;
+            touching[j] |= 1 << i;
+        }
+    }
+
+    uint8_t any = 0;
+    for(uint8_t s = 0; s < FLEET_SIZE; s++) any |= touching[s];
+
+    uint32_t last = 0, sum = 0;
+    for(uint8_t k = 0; k < DEFENSE_ORDERS; k++) {
+        uint8_t found[FLEET_SIZE];
+        for(uint8_t s = 0; s < FLEET_SIZE; s++) found[s] = ctx->first[s][picks[s]][k];
+
+        // Finding one finds whatever's touching it, and whatever's touching that...
+        for(uint8_t pass = 0; pass < FLEET_SIZE - 1 && any; pass++) {
+            for(uint8_t s = 0; s < FLEET_SIZE; s++) {
+                for(uint8_t t = 0; t < FLEET_SIZE; t++) {
+                    if((touching[s] & (1 << t)) && found[t] + DEFENSE_TOUCH < found[s]) found[s] = found[t] + DEFENSE_TOUCH;
+                }
+            }
+        }
+
+        uint8_t latest = 0;
+        for(uint8_t s = 0; s < FLEET_SIZE; s++) {
+            if(found[s] > latest) latest = found[s];
+            sum += found[s];
+        }
+        last += latest;
+    }
+
+    return ((float)last + ((float)sum / (4.0f * FLEET_SIZE))) / DEFENSE_ORDERS;
+}
+
+/// @brief Runs one annealing chain
+static void bs_defense_task(void* arg, uint32_t task, uint32_t worker) {
+    (void)worker;
+    defense_ctx_t* ctx = arg;
+    const defense_limits_t* limits = ctx->limits;
+    defense_result_t* result = &ctx->results[task];
+
+    rng_t rng;
+    bs_rng_seed(&rng, limits->seed ^ ((task + 1) * 0x9E3779B97F4A7C15ULL));
+
+    uint8_t picks[FLEET_SIZE];
+    bb_t masks[FLEET_SIZE];
+    bb_t occupied = bs_bb_empty();
+    bs_fleet_pick(NULL, &rng, picks);
+    for(uint8_t s = 0; s < FLEET_SIZE; s++) {
+        masks[s] = bs_ship_placements[s].list[picks[s]].mask;
+        occupied = bs_bb_or(occupied, masks[s]);
+    }
+
+    float current = bs_defense_score(ctx, picks);
+    memcpy(result->picks, picks, FLEET_SIZE);
+    result->score = current;
+
+    float temperature = DEFENSE_HOT;
+    uint64_t i = 0;
+    for(;; i++) {
+        if(limits->iterations != 0 && i >= limits->iterations) break;
+
+        // Cools from hot to cold over however long it's got
+        if(i % DEFENSE_CHECK == 0) {
+            float progress = 0.0f;
+            if(limits->iterations != 0) progress = (float)i / (float)limits->iterations;
+            if(ctx->deadline != 0) {
+                uint64_t now = bs_time_ns();
+                if(now >= ctx->deadline) break;
+
+                float elapsed = (float)(now - ctx->start) / (float)limits->max_time_ns;
+                if(elapsed > progress) progress = elapsed;
+            }
+            temperature = DEFENSE_HOT * powf(DEFENSE_COLD / DEFENSE_HOT, progress);
+        }
+
+        // Move one ship somewhere else it fits
+        uint8_t s = (uint8_t)bs_rng_below(&rng, FLEET_SIZE);
+        const ship_placements_t* table = &bs_ship_placements[s];
+        uint8_t p = (uint8_t)bs_rng_below(&rng, table->count);
+        bb_t mask = table->list[p].mask;
+        if(p == picks[s] || bs_bb_intersects(mask, bs_bb_andnot(occupied, masks[s]))) continue;
+
+        uint8_t old = picks[s];
+        picks[s] = p;
+        float next = bs_defense_score(ctx, picks);
+
+        float chance = (float)(bs_rng_next(&rng) >> 40) * (1.0f / 16777216.0f);
+        if(next < current && chance >= expf((next - current) / temperature)) {
+            picks[s] = old;
+            continue;
+        }
+
+        occupied = bs_bb_or(bs_bb_andnot(occupied, masks[s]), mask);
+        masks[s] = mask;
+        current = next;
+        if(current > result->score) {
+            memcpy(result->picks, picks, FLEET_SIZE);
+            result->score = current;
+        }
+    }
+
+    result->iterations = i;
+}
+
+/// @brief Finds a layout that takes the opponent as long as possible to find
+/// @param pool Threads to search on, one chain each (NULL = only the calling thread)
+/// @param model How the opponent shoots
+/// @param limits When to stop (at least one limit has to be set)
+/// @param out The best layout found
+/// @return Returns `false` if there's no limit, or it couldn't allocate what it needs
+bool bs_defense_run(pool_t* pool, const defense_model_t* model, const defense_limits_t* limits, defense_result_t* out) {
+    if(limits->max_time_ns == 0 && limits->iterations == 0) return false;
+
+    uint64_t start = bs_time_ns();
+    bs_placement_init(); // Before any threads use the placement tables
+
+    uint32_t chains = (pool != NULL && pool->workers > 0) ? pool->workers : 1;
+    defense_ctx_t* ctx = calloc(1, sizeof(defense_ctx_t));
+    defense_result_t* results = calloc(chains, sizeof(defense_result_t));
+    if(ctx == NULL || results == NULL) {
+        free(ctx);
+        free(results);
+        return false;
+    }
+
+    ctx->limits = limits;
+    ctx->start = start;
+    ctx->deadline = limits->max_time_ns != 0 ? start + limits->max_time_ns : 0;
+    ctx->results = results;
+
+    rng_t rng;
+    bs_rng_seed(&rng, limits->seed);
+    bs_defense_orders(ctx, model, &rng);
+
+    if(chains > 1) bs_pool_run(pool, bs_defense_task, ctx, chains);
+    else bs_defense_task(ctx, 0, 0);
+
+    // The best of every chain (ties go to the first, so it's the same however the threads ran)
+    uint32_t best = 0;
+    uint64_t iterations = 0;
+    for(uint32_t c = 0; c < chains; c++) {
+        if(results[c].score > results[best].score) best = c;
+        iterations += results[c].iterations;
+    }
+
+    *out = results[best];
+    out->iterations = iterations;
+    out->time_ns = bs_time_ns() - start;
+
+    free(results);
+    free(ctx);
+    return true;
+}
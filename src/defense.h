@@ -0,0 +1,70 @@
+/*
+    BSBOT made by William Dawson (MrBisquit on GitHub)
+    https://wtdawson.info
+
+    --------------------------------------------------------------------------------------------
+
+    Fleet placement optimiser
+
+    Picks where the bot puts its own ships, so whoever's shooting at them takes as long as
+    possible. The opponent is modelled as an order they tend to shoot cells in (`heat`, the
+    higher the sooner), and a layout is scored by how long it'd take them to find every ship:
+    a ship is found at the first of its cells they'd shoot, and a ship touching one that's
+    already been found gets found straight after it (shooting around a hit finds it). A few
+    different orders are tried, with some noise added to each, so a layout that only just
+    dodges one exact order doesn't win.
+
+    Scoring a layout is a handful of table lookups (the first shot at every placement is
+    worked out beforehand), so simulated annealing can try a lot of them. Each worker runs
+    its own chain, and the best layout from any of them wins.
+
+    --------------------------------------------------------------------------------------------
+
+ *  License:    SPDX-License-Identifier: MIT
+ *              See LICENSE file in the project root for full license text.
+*/
+
+#ifndef BSBOT_DEFENSE_H
+#define BSBOT_DEFENSE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "bitboard.h"
+#include "knowledge.h"
+#include "placement.h"
+#include "pool.h"
+#include "prior.h"
+
+#define DEFENSE_ORDERS  16      // Shot orders each layout is scored against
+#define DEFENSE_NOISE   0.35f   // How much each order strays from the heat (1 = as much as the hottest and coldest cells differ)
+#define DEFENSE_TOUCH   3       // Shots to find a ship next to one that's been found
+#define DEFENSE_BUDGET  100000000ULL   // How long the game gives it at the start, in nanoseconds (100ms)
+
+/// @brief How the opponent is expected to shoot
+typedef struct {
+    float heat[BB_CELLS];       // Higher is shot sooner (only the order matters)
+} defense_model_t;
+
+/// @brief When to stop. Whichever is reached first wins, 0 means "don't use this one"
+typedef struct {
+    uint64_t max_time_ns;       // Stop after this long (the result won't be reproducible then)
+    uint64_t iterations;        // Layouts each worker tries
+    uint64_t seed;
+} defense_limits_t;
+
+typedef struct {
+    uint8_t picks[FLEET_SIZE];  // Each ship's placement (same order as the placement lists)
+    float score;                // Shots it expects the opponent to take to find every ship
+    uint64_t iterations;        // Layouts tried, across every worker
+    uint64_t time_ns;
+} defense_result_t;
+
+// Models
+void bs_defense_uniform(defense_model_t* model);
+void bs_defense_parity(defense_model_t* model);
+void bs_defense_density(defense_model_t* model);
+bool bs_defense_learned(defense_model_t* model, const prior_counts_t* counts);
+
+bool bs_defense_run(pool_t* pool, const defense_model_t* model, const defense_limits_t* limits, defense_result_t* out);
+
+#endif
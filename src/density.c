@@ -0,0 +1,146 @@
+/*
+    BSBOT made by William Dawson (MrBisquit on GitHub)
+    https://wtdawson.info
+
+    --------------------------------------------------------------------------------------------
+
+    Incremental placement density (See density.h)
+
+    --------------------------------------------------------------------------------------------
+
+ *  License:    SPDX-License-Identifier: MIT
+ *              See LICENSE file in the project root for full license text.
+*/
+
+#include <string.h>
+#include "density.h"
+
+static inline bool bs_density_valid(const density_t* d, uint8_t ship, uint8_t p) {
+    return (d->valid[ship][p / 64] >> (p % 64)) & 1;
+}
+
+/// @brief Adds an amount to every cell of a placement (times its weight)
+static inline void bs_density_add(density_t* d, uint8_t ship, uint8_t p, int64_t amount) {
+    if(d->weights != NULL) amount *= d->weights[ship][p];
+
+    bb_t mask = bs_ship_placements[ship].list[p].mask;
+    while(!bs_bb_is_empty(mask)) d->counts[bs_bb_pop_lsb(&mask)] += (uint32_t)amount;
+}
+
+/// @brief Takes a placement out (if it's still in)
+static void bs_density_remove(density_t* d, uint8_t ship, uint8_t p) {
+    if(!bs_density_valid(d, ship, p)) return;
+
+    d->valid[ship][p / 64] &= ~(1ULL << (p % 64));
+    bs_density_add(d, ship, p, -(int64_t)bs_density_weights[d->hits[ship][p]]);
+}
+
+/// @brief Starts again with every placement possible
+/// @param d The density
+/// @param weights Each placement's weight (NULL = all the same, see `prior_weights_t`), it's kept, not copied
+void bs_density_init(density_t* d, const uint8_t (*weights)[PLACEMENT_MAX]) {
+    bs_placement_init();
+    memset(d, 0, sizeof(density_t));
+    d->afloat = FLEET_ALL;
+    d->weights = weights;
+
+    for(uint8_t s = 0; s < FLEET_SIZE; s++) {
+        const ship_placements_t* table = &bs_ship_placements[s];
+        for(uint8_t p = 0; p < table->count; p++) {
+            d->valid[s][p / 64] |= 1ULL << (p % 64);
+            bs_density_add(d, s, p, bs_density_weights[0]);
+        }
+    }
+}
+
+/// @brief A shot missed, so nothing can be on that cell
+/// @param d The density
+/// @param cell The cell
+void bs_density_miss(density_t* d, uint8_t cell) {
+    bs_bb_set(&d->shot, cell);
+
+    for(uint8_t s = 0; s < FLEET_SIZE; s++) {
+        if(!(d->afloat & (1 << s))) continue;
+
+        const ship_placements_t* table = &bs_ship_placements[s];
+        for(uint8_t i = 0; i < table->covering_count[cell]; i++) bs_density_remove(d, s, table->covering[cell][i]);
+    }
+}
+
+/// @brief A shot hit (without sinking anything), so placements over it count for more
+/// @param d The density
+/// @param cell The cell
+void bs_density_hit(density_t* d, uint8_t cell) {
+    bs_bb_set(&d->shot, cell);
+    bs_bb_set(&d->hitmap, cell);
+
+    for(uint8_t s = 0; s < FLEET_SIZE; s++) {
+        if(!(d->afloat & (1 << s))) continue;
+
+        const ship_placements_t* table = &bs_ship_placements[s];
+        for(uint8_t i = 0; i < table->covering_count[cell]; i++) {
+            uint8_t p = table->covering[cell][i];
+            if(!bs_density_valid(d, s, p)) continue;
+
+            uint8_t hits = d->hits[s][p]++;
+            if(hits + 1 >= bs_fleet_lengths[s]) {
+                // Every cell's a hit, but it wasn't sunk, so it isn't this ship
+                d->hits[s][p] = hits;
+                bs_density_remove(d, s, p);
+                continue;
+            }
+
+            bs_density_add(d, s, p, (int64_t)bs_density_weights[hits + 1] - (int64_t)bs_density_weights[hits]);
+        }
+    }
+}
+
+/// @brief A ship was sunk, so it's gone, and nothing else can be on its cells
+/// @param d The density
+/// @param ship The ship (PLACE_x - 1)
+/// @param cells Its cells
+void bs_density_sunk(density_t* d, uint8_t ship, bb_t cells) {
+    if(ship >= FLEET_SIZE || !(d->afloat & (1 << ship))) return;
+
+    for(uint8_t w = 0; w < 3; w++) {
+        uint64_t left = d->valid[ship][w];
+        while(left) {
+            bs_density_remove(d, ship, (uint8_t)((w * 64) + bs_ctz64(left)));
+            left &= left - 1;
+        }
+    }
+
+    d->afloat &= ~(1 << ship);
+    d->shot = bs_bb_or(d->shot, cells);
+    d->hitmap = bs_bb_andnot(d->hitmap, cells);
+
+    while(!bs_bb_is_empty(cells)) {
+        uint8_t cell = bs_bb_pop_lsb(&cells);
+        for(uint8_t s = 0; s < FLEET_SIZE; s++) {
+            if(!(d->afloat & (1 << s))) continue;
+
+            const ship_placements_t* table = &bs_ship_placements[s];
+            for(uint8_t i = 0; i < table->covering_count[cell]; i++) bs_density_remove(d, s, table->covering[cell][i]);
+        }
+    }
+}
+
+/// @brief Turns the counts into a possibility grid (the busiest cell is `POSS_ONE`)
+/// @param d The density
+/// @param grid Where it goes (cells that have been shot come out as 0)
+void bs_density_possibilities(const density_t* d, poss_row_t* grid) {
+    uint32_t most = 0;
+    for(uint8_t cell = 0; cell < BB_CELLS; cell++) {
+        if(!bs_bb_test(d->shot, cell) && d->counts[cell] > most) most = d->counts[cell];
+    }
+
+    // No count's bigger than `most`, so multiplying by a 24-bit fixed point reciprocal can't overflow
+    uint64_t scale = most != 0 ? ((uint64_t)POSS_ONE << 24) / most : 0;
+    for(uint8_t y = 0; y < BB_SIZE; y++) {
+        for(uint8_t x = 0; x < BB_SIZE; x++) {
+            uint8_t cell = bs_bb_index(x, y);
+            if(bs_bb_test(d->shot, cell)) grid[y][x] = 0;
+            else grid[y][x] = (uint16_t)(((d->counts[cell] * scale) + (1 << 23)) >> 24);
+        }
+    }
+}
@@ -0,0 +1,55 @@
+/*
+    BSBOT made by William Dawson (MrBisquit on GitHub)
+    https://wtdawson.info
+
+    --------------------------------------------------------------------------------------------
+
+    Incremental placement density
+
+    Keeps a running count, for every cell, of how many placements of the ships still afloat
+    could be on it (placements that cover hits count for a lot more). Instead of working it all
+    out again after every shot, a shot only touches the placements that cover that cell, which
+    are at most the row and column either side of it, as far as the ship is long.
+
+    It doesn't check that the ships fit together (that's what `enumerate.c` is for), so it's
+    a lot cheaper but only a guide.
+
+    Placements can also be weighted by how often players actually use them (see prior.h), in
+    which case every placement's count is multiplied by its weight.
+
+    --------------------------------------------------------------------------------------------
+
+ *  License:    SPDX-License-Identifier: MIT
+ *              See LICENSE file in the project root for full license text.
+*/
+
+#ifndef BSBOT_DENSITY_H
+#define BSBOT_DENSITY_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "bitboard.h"
+#include "knowledge.h"
+#include "placement.h"
+#include "possibilities.h"
+
+/// @brief How much a placement counts for, by how many hits it covers (one that's all hits is gone, it'd be sunk)
+static const uint32_t bs_density_weights[6] = { 1, 16, 256, 4096, 65536, 0 };
+
+typedef struct {
+    uint64_t valid[FLEET_SIZE][3];                  // Placements still possible (bit per entry in the ship's placement list)
+    uint8_t hits[FLEET_SIZE][PLACEMENT_MAX];        // How many hits each placement covers
+    uint32_t counts[BB_CELLS];                      // Weighted placements on each cell
+    bb_t hitmap;                                    // Hits on ships that haven't been sunk
+    bb_t shot;                                      // Every cell that's been shot
+    uint8_t afloat;                                 // Ships that haven't been sunk (1 << (PLACE_x - 1))
+    const uint8_t (*weights)[PLACEMENT_MAX];        // Each placement's weight ([ship][placement], NULL = all the same)
+} density_t;
+
+void bs_density_init(density_t* d, const uint8_t (*weights)[PLACEMENT_MAX]);
+void bs_density_miss(density_t* d, uint8_t cell);
+void bs_density_hit(density_t* d, uint8_t cell);
+void bs_density_sunk(density_t* d, uint8_t ship, bb_t cells);
+void bs_density_possibilities(const density_t* d, poss_row_t* grid);
+
+#endif
@@ -0,0 +1,505 @@
+/*
+    BSBOT made by William Dawson (MrBisquit on GitHub)
+    https://wtdawson.info
+
+    --------------------------------------------------------------------------------------------
+
+    Exact placement enumeration
+
+    Every placement (a ship length, a first cell and a rotation) gets a number, and sets of
+    placements are stored as bitsets of those numbers (`pset_t`). For every pair of placements
+    we precompute whether they overlap, so placing a ship is just AND-ing the other ships'
+    sets with a precomputed mask instead of checking every placement against the board.
+
+    The search works in two phases:
+    *   Hits first. The lowest hit that isn't covered yet must be covered by exactly one of
+        the remaining ships, so we branch on which ship (and which of its placements) covers
+        it. Every layout is found exactly once this way, and any branch that can't cover the
+        hits dies straight away.
+    *   Once every hit is covered, the rest of the ships can go anywhere that's left. The
+        last two ships are counted in one go with the overlap masks, rather than trying
+        every pair, which is where nearly all of the time would otherwise go.
+
+    Every node adds the number of layouts below it to the placement that led to it. Only at
+    the very end are those spread out onto the cells, so `counts` holds how many layouts have
+    a ship on each cell.
+
+    With placement weights (a prior, see prior.h), a layout counts as its placements' weights
+    multiplied together instead of 1. The last two ships can't be counted with a popcount
+    then, so for each placement it's the weight of all the other ship's placements, minus the
+    ones that overlap it (which are far fewer).
+
+    --------------------------------------------------------------------------------------------
+
+ *  License:    SPDX-License-Identifier: MIT
+ *              See LICENSE file in the project root for full license text.
+*/
+
+#include <string.h>
+#include "enumerate.h"
+#include "placement.h"
+#include "platform.h"
+
+#define ENUM_LENGTHS        4   // Ships are 2, 3, 4 or 5 long (index is length - 2)
+#define ENUM_MAX_PLACEMENTS PLACEMENT_MAX
+#define PSET_WORDS          3   // 192 bits, enough for every placement of one length
+#define ENUM_CANCEL_CHECK   16384 // Work between looking at the cancel flag (about 50us)
+
+typedef struct {
+    uint64_t w[PSET_WORDS];
+} pset_t;
+
+typedef struct {
+    bb_t mask;
+    uint8_t cells[5];
+} enum_placement_t;
+
+typedef struct {
+    uint64_t weights[ENUM_LENGTHS][ENUM_MAX_PLACEMENTS]; // Layouts using each placement (turned into cells at the end)
+    uint64_t nodes;
+    uint64_t work;
+    uint64_t max_work;
+    uint64_t next_check; // When to look at the cancel flag again
+    volatile int32_t* cancel;
+    const uint8_t (*prior)[PLACEMENT_MAX]; // Each ship's placement weights (NULL = every layout counts as 1)
+    uint64_t scale;     // The weights of the placements above this node multiplied (1 without a prior)
+    bool aborted;
+    uint8_t lengths[FLEET_SIZE]; // Table index (length - 2) of each ship afloat
+} enum_ctx_t;
+
+static enum_placement_t placements[ENUM_LENGTHS][ENUM_MAX_PLACEMENTS];
+static uint8_t placement_count[ENUM_LENGTHS];
+static pset_t conflicts[ENUM_LENGTHS][ENUM_MAX_PLACEMENTS][ENUM_LENGTHS]; // Placements of each length that overlap this one
+static pset_t covers[ENUM_LENGTHS][BB_CELLS]; // Placements of each length that cover a cell
+static bool initialised = false;
+
+static inline int pset_popcount(const pset_t* a) {
+    return bs_popcount64(a->w[0]) + bs_popcount64(a->w[1]) + bs_popcount64(a->w[2]);
+}
+
+static inline bool pset_is_empty(const pset_t* a) {
+    return (a->w[0] | a->w[1] | a->w[2]) == 0;
+}
+
+static inline pset_t pset_and(const pset_t* a, const pset_t* b) {
+    return (pset_t){ .w = { a->w[0] & b->w[0], a->w[1] & b->w[1], a->w[2] & b->w[2] } };
+}
+
+static inline pset_t pset_andnot(const pset_t* a, const pset_t* b) {
+    return (pset_t){ .w = { a->w[0] & ~b->w[0], a->w[1] & ~b->w[1], a->w[2] & ~b->w[2] } };
+}
+
+/// @brief Removes and returns the lowest placement in the set
+/// @note The set must not be empty
+static inline uint8_t pset_pop(pset_t* a) {
+    for(uint8_t i = 0; i < PSET_WORDS; i++) {
+        if(a->w[i]) {
+            uint8_t p = (uint8_t)((i * 64) + bs_ctz64(a->w[i]));
+            a->w[i] &= a->w[i] - 1;
+            return p;
+        }
+    }
+    return 0;
+}
+
+static inline void pset_add(pset_t* a, uint8_t p) {
+    a->w[p / 64] |= 1ULL << (p % 64);
+}
+
+static inline void bs_enum_add(enum_ctx_t* ctx, uint8_t l, uint8_t p, uint64_t amount) {
+    ctx->weights[l][p] += amount * ctx->scale;
+}
+
+/// @brief What one of a ship's placements counts as (1 without a prior)
+static inline uint64_t bs_enum_weight(const enum_ctx_t* ctx, uint8_t s, uint8_t p) {
+    return ctx->prior != NULL ? ctx->prior[s][p] : 1;
+}
+
+/// @brief Adds up the weights of a set of a ship's placements
+static uint64_t bs_enum_sum(const enum_ctx_t* ctx, uint8_t s, pset_t set) {
+    uint64_t total = 0;
+    while(!pset_is_empty(&set)) total += ctx->prior[s][pset_pop(&set)];
+    return total;
+}
+
+/// @brief Counts the layouts of the last two ships with a prior (see the top of the file)
+static uint64_t bs_enum_pair_weighted(enum_ctx_t* ctx, uint8_t s, uint8_t t, const pset_t valid[FLEET_SIZE]) {
+    uint8_t ls = ctx->lengths[s];
+    uint8_t lt = ctx->lengths[t];
+    uint64_t all_s = bs_enum_sum(ctx, s, valid[s]);
+    uint64_t all_t = bs_enum_sum(ctx, t, valid[t]);
+    uint64_t total = 0;
+    ctx->work += pset_popcount(&valid[s]) + pset_popcount(&valid[t]);
+
+    pset_t left = valid[s];
+    while(!pset_is_empty(&left)) {
+        uint8_t p = pset_pop(&left);
+        pset_t clashes = pset_and(&valid[t], &conflicts[ls][p][lt]);
+        ctx->work += pset_popcount(&clashes);
+        uint64_t n = (all_t - bs_enum_sum(ctx, t, clashes)) * ctx->prior[s][p];
+        if(n == 0) continue;
+
+        bs_enum_add(ctx, ls, p, n);
+        total += n;
+    }
+
+    left = valid[t];
+    while(!pset_is_empty(&left)) {
+        uint8_t q = pset_pop(&left);
+        pset_t clashes = pset_and(&valid[s], &conflicts[lt][q][ls]);
+        ctx->work += pset_popcount(&clashes);
+        uint64_t n = (all_s - bs_enum_sum(ctx, s, clashes)) * ctx->prior[t][q];
+        if(n > 0) bs_enum_add(ctx, lt, q, n);
+    }
+
+    return total;
+}
+
+/// @brief Counts the layouts of the last two ships (without trying every pair)
+/// @note Nearly all the time goes in here, and it's nearly all popcounts, so it's built twice,
+///       once with the popcount instruction (see `bs_enum_init`)
+static BS_ALWAYS_INLINE uint64_t bs_enum_pair_body(enum_ctx_t* ctx, uint8_t s, uint8_t t, const pset_t valid[FLEET_SIZE]) {
+    uint8_t ls = ctx->lengths[s];
+    uint8_t lt = ctx->lengths[t];
+    uint64_t total = 0;
+    ctx->work += pset_popcount(&valid[s]) + pset_popcount(&valid[t]); // One set operation per placement of each
+
+    // Every placement of one ship pairs with every placement of the other that doesn't overlap it
+    pset_t left = valid[s];
+    while(!pset_is_empty(&left)) {
+        uint8_t p = pset_pop(&left);
+        pset_t partners = pset_andnot(&valid[t], &conflicts[ls][p][lt]);
+        uint64_t n = pset_popcount(&partners);
+        if(n == 0) continue;
+
+        bs_enum_add(ctx, ls, p, n);
+        total += n;
+    }
+
+    left = valid[t];
+    while(!pset_is_empty(&left)) {
+        uint8_t q = pset_pop(&left);
+        pset_t partners = pset_andnot(&valid[s], &conflicts[lt][q][ls]);
+        uint64_t n = pset_popcount(&partners);
+        if(n > 0) bs_enum_add(ctx, lt, q, n);
+    }
+
+    return total;
+}
+
+typedef uint64_t (*enum_pair_fn)(enum_ctx_t* ctx, uint8_t s, uint8_t t, const pset_t valid[FLEET_SIZE]);
+
+static uint64_t bs_enum_pair_plain(enum_ctx_t* ctx, uint8_t s, uint8_t t, const pset_t valid[FLEET_SIZE]) {
+    return bs_enum_pair_body(ctx, s, t, valid);
+}
+
+#if BS_HAVE_TARGET
+static BS_TARGET("popcnt") uint64_t bs_enum_pair_popcnt(enum_ctx_t* ctx, uint8_t s, uint8_t t, const pset_t valid[FLEET_SIZE]) {
+    return bs_enum_pair_body(ctx, s, t, valid);
+}
+#endif
+
+static enum_pair_fn bs_enum_pair = bs_enum_pair_plain; // The fastest one this CPU can run
+
+/// @brief Builds the placement, overlap and cover tables
+/// @note This is called by `bs_enum_run`, but isn't thread-safe, so call it once at startup if threads are involved
+void bs_enum_init(void) {
+    if(initialised) return;
+    memset(conflicts, 0, sizeof(conflicts));
+    memset(covers, 0, sizeof(covers));
+
+    bs_placement_init();
+
+    for(uint8_t l = 0; l < ENUM_LENGTHS; l++) {
+        uint8_t places = l + 2;
+
+        // Ships of the same length have the same placements, so take them from any of them
+        uint8_t ship = 0;
+        while(bs_fleet_lengths[ship] != places) ship++;
+        const ship_placements_t* table = &bs_ship_placements[ship];
+
+        for(uint8_t n = 0; n < table->count; n++) {
+            placements[l][n].mask = table->list[n].mask;
+            bb_t cells = table->list[n].mask;
+            for(uint8_t i = 0; i < places; i++) {
+                placements[l][n].cells[i] = bs_bb_pop_lsb(&cells);
+                pset_add(&covers[l][placements[l][n].cells[i]], n);
+            }
+        }
+
+        placement_count[l] = table->count;
+    }
+
+    for(uint8_t a = 0; a < ENUM_LENGTHS; a++) {
+        for(uint8_t p = 0; p < placement_count[a]; p++) {
+            for(uint8_t b = 0; b < ENUM_LENGTHS; b++) {
+                for(uint8_t q = 0; q < placement_count[b]; q++) {
+                    if(bs_bb_intersects(placements[a][p].mask, placements[b][q].mask)) pset_add(&conflicts[a][p][b], q);
+                }
+            }
+        }
+    }
+
+#if BS_HAVE_TARGET
+    // Without the popcount instruction each one's a dozen or so instructions
+    if(bs_cpu_features() & BS_CPU_POPCNT) bs_enum_pair = bs_enum_pair_popcnt;
+#endif
+
+    initialised = true;
+}
+
+/// @brief Counts the layouts of the remaining ships
+/// @param ctx The search
+/// @param remaining The ships that still need placing (bit per ship afloat)
+/// @param valid Where each remaining ship can still go
+/// @param uncovered Hits that no placed ship covers yet
+/// @return How many layouts there are
+static uint64_t bs_enum_node(enum_ctx_t* ctx, uint8_t remaining, const pset_t valid[FLEET_SIZE], bb_t uncovered) {
+    if(ctx->aborted) return 0;
+    ctx->nodes++;
+    if(++ctx->work > ctx->max_work && ctx->max_work != 0) {
+        ctx->aborted = true;
+        return 0;
+    }
+    if(ctx->cancel != NULL && ctx->work >= ctx->next_check) {
+        ctx->next_check = ctx->work + ENUM_CANCEL_CHECK;
+        if(bs_atomic_load32(ctx->cancel)) {
+            ctx->aborted = true;
+            return 0;
+        }
+    }
+
+    if(remaining == 0) return bs_bb_is_empty(uncovered) ? 1 : 0;
+
+    uint8_t count = 0;
+    uint8_t room = 0; // How many hits the remaining ships could still cover
+    uint8_t slots[FLEET_SIZE];
+    for(uint8_t s = 0; s < FLEET_SIZE; s++) {
+        if(!(remaining & (1 << s))) continue;
+        if(pset_is_empty(&valid[s])) return 0; // Nowhere left for this one
+        slots[count++] = s;
+        room += ctx->lengths[s] + 2;
+    }
+
+    uint64_t total = 0;
+    pset_t next[FLEET_SIZE];
+
+    if(!bs_bb_is_empty(uncovered)) {
+        if(bs_bb_popcount(uncovered) > room) return 0;
+
+        // Exactly one ship covers this hit, so try each one that could
+        uint8_t h = bs_bb_lsb(uncovered);
+        for(uint8_t i = 0; i < count; i++) {
+            uint8_t s = slots[i];
+            uint8_t ls = ctx->lengths[s];
+            pset_t options = pset_and(&valid[s], &covers[ls][h]);
+
+            while(!pset_is_empty(&options)) {
+                uint8_t p = pset_pop(&options);
+                for(uint8_t j = 0; j < count; j++) {
+                    uint8_t t = slots[j];
+                    if(t != s) next[t] = pset_andnot(&valid[t], &conflicts[ls][p][ctx->lengths[t]]);
+                }
+
+                uint64_t w = bs_enum_weight(ctx, s, p);
+                uint64_t scale = ctx->scale;
+                ctx->scale = scale * w;
+                uint64_t n = bs_enum_node(ctx, remaining & ~(1 << s), next, bs_bb_andnot(uncovered, placements[ls][p].mask));
+                ctx->scale = scale;
+                if(n == 0) continue;
+                n *= w;
+
+                bs_enum_add(ctx, ls, p, n);
+                total += n;
+            }
+        }
+
+        return total;
+    }
+
+    if(count == 1) {
+        uint8_t s = slots[0];
+        pset_t left = valid[s];
+        ctx->work += pset_popcount(&left);
+        while(!pset_is_empty(&left)) {
+            uint8_t p = pset_pop(&left);
+            uint64_t w = bs_enum_weight(ctx, s, p);
+            bs_enum_add(ctx, ctx->lengths[s], p, w);
+            total += w;
+        }
+        return total;
+    }
+
+    if(count == 2) {
+        if(ctx->prior != NULL) return bs_enum_pair_weighted(ctx, slots[0], slots[1], valid);
+        return bs_enum_pair(ctx, slots[0], slots[1], valid);
+    }
+
+    // Branch on whichever ship has the fewest places left, to keep the tree narrow
+    uint8_t s = slots[0];
+    int fewest = pset_popcount(&valid[s]);
+    for(uint8_t i = 1; i < count; i++) {
+        int n = pset_popcount(&valid[slots[i]]);
+        if(n < fewest) {
+            fewest = n;
+            s = slots[i];
+        }
+    }
+
+    uint8_t ls = ctx->lengths[s];
+    pset_t left = valid[s];
+    while(!pset_is_empty(&left)) {
+        uint8_t p = pset_pop(&left);
+        for(uint8_t j = 0; j < count; j++) {
+            uint8_t t = slots[j];
+            if(t != s) next[t] = pset_andnot(&valid[t], &conflicts[ls][p][ctx->lengths[t]]);
+        }
+
+        uint64_t w = bs_enum_weight(ctx, s, p);
+        uint64_t scale = ctx->scale;
+        ctx->scale = scale * w;
+        uint64_t n = bs_enum_node(ctx, remaining & ~(1 << s), next, uncovered);
+        ctx->scale = scale;
+        if(n == 0) continue;
+        n *= w;
+
+        bs_enum_add(ctx, ls, p, n);
+        total += n;
+    }
+
+    return total;
+}
+
+/// @brief Guesses how much work placing ships anywhere that's left would take (no hits to cover)
+/// @note The search branches on the ships with the fewest places first, and counts the last two
+///       in one go, so it's the product of all but the two biggest, times the two biggest added
+///       (it doesn't know which placements overlap, so it's a bit over)
+static uint64_t bs_enum_estimate_free(uint8_t remaining, const pset_t valid[FLEET_SIZE]) {
+    uint64_t counts[FLEET_SIZE];
+    uint8_t n = 0;
+    for(uint8_t s = 0; s < FLEET_SIZE; s++) {
+        if(!(remaining & (1 << s))) continue;
+
+        // Biggest first
+        uint64_t c = (uint64_t)pset_popcount(&valid[s]);
+        uint8_t i = n++;
+        while(i > 0 && counts[i - 1] < c) {
+            counts[i] = counts[i - 1];
+            i--;
+        }
+        counts[i] = c;
+    }
+
+    if(n == 0) return 1;
+    if(n == 1) return counts[0];
+
+    uint64_t estimate = counts[0] + counts[1];
+    for(uint8_t i = 2; i < n; i++) estimate *= counts[i];
+    return estimate;
+}
+
+/// @brief Guesses how much work counting the layouts would take, without doing any of it
+/// @note With a hit, the search tries each placement that covers the lowest one, and then the
+///       rest of the ships, so that's what this adds up (any other hits are ignored, so it's over)
+static uint64_t bs_enum_estimate(const enum_ctx_t* ctx, uint8_t remaining, const pset_t valid[FLEET_SIZE], bb_t uncovered) {
+    if(bs_bb_is_empty(uncovered)) return bs_enum_estimate_free(remaining, valid);
+
+    uint8_t h = bs_bb_lsb(uncovered);
+    uint64_t estimate = 1;
+    for(uint8_t s = 0; s < FLEET_SIZE; s++) {
+        if(!(remaining & (1 << s))) continue;
+
+        pset_t options = pset_and(&valid[s], &covers[ctx->lengths[s]][h]);
+        uint64_t n = (uint64_t)pset_popcount(&options);
+        if(n > 0) estimate += n * bs_enum_estimate_free(remaining & ~(1 << s), valid);
+    }
+
+    return estimate;
+}
+
+/// @brief Counts every layout that agrees with what's known
+/// @param k What's known about the board
+/// @param limits Limits on the search (can be NULL)
+/// @param out The result
+/// @return Returns `true` if it finished, `false` if it hit a limit
+bool bs_enum_run(const knowledge_t* k, const enum_limits_t* limits, enum_result_t* out) {
+    bs_enum_init();
+    memset(out, 0, sizeof(enum_result_t));
+
+    enum_ctx_t ctx; // ~6KB, but it has to be per call so threads can each run their own
+    memset(&ctx, 0, sizeof(enum_ctx_t));
+    ctx.max_work = limits ? limits->max_work : 0;
+    ctx.cancel = limits ? limits->cancel : NULL;
+    ctx.prior = limits ? limits->weights : NULL;
+    ctx.scale = 1;
+
+    bb_t blocked = bs_bb_or(k->misses, k->sunk);
+    pset_t valid[FLEET_SIZE];
+    memset(valid, 0, sizeof(valid));
+
+    for(uint8_t s = 0; s < FLEET_SIZE; s++) {
+        uint8_t l = bs_fleet_lengths[s] - 2;
+        ctx.lengths[s] = l;
+        if(!(k->afloat & (1 << s))) continue;
+
+        for(uint8_t p = 0; p < placement_count[l]; p++) {
+            bb_t mask = placements[l][p].mask;
+            if(bs_bb_intersects(mask, blocked)) continue;
+            // If every cell were a hit it would have been sunk already
+            if(bs_bb_is_empty(bs_bb_andnot(mask, k->hits))) continue;
+            pset_add(&valid[s], p);
+        }
+    }
+
+    // Weighted counts could go past 64 bits (a whole board is about 2^35 layouts, and weights
+    // multiply up to 2^30), so anything that could is left to the sampler
+    if(ctx.prior != NULL) {
+        double most = 1.0;
+        for(uint8_t s = 0; s < FLEET_SIZE; s++) {
+            if(!(k->afloat & (1 << s))) continue;
+
+            uint8_t heaviest = 0;
+            pset_t left = valid[s];
+            while(!pset_is_empty(&left)) {
+                uint8_t w = ctx.prior[s][pset_pop(&left)];
+                if(w > heaviest) heaviest = w;
+            }
+            most *= (double)pset_popcount(&valid[s]) * (double)heaviest;
+        }
+        if(most >= 9.2e18) return false;
+    }
+
+    // Not worth starting if even the guess is way over (it's never been more than about 40x
+    // too high, so nothing that would have fitted gets skipped)
+    out->estimate = bs_enum_estimate(&ctx, k->afloat & FLEET_ALL, valid, k->hits);
+    if(ctx.max_work != 0 && out->estimate / ENUM_HOPELESS > ctx.max_work) return false;
+    out->layouts = bs_enum_node(&ctx, k->afloat & FLEET_ALL, valid, k->hits);
+    out->nodes = ctx.nodes;
+    out->work = ctx.work;
+    out->complete = !ctx.aborted;
+
+    if(out->complete) {
+        for(uint8_t l = 0; l < ENUM_LENGTHS; l++) {
+            for(uint8_t p = 0; p < placement_count[l]; p++) {
+                uint64_t w = ctx.weights[l][p];
+                if(w == 0) continue;
+                for(uint8_t i = 0; i < l + 2; i++) out->counts[placements[l][p].cells[i]] += w;
+            }
+        }
+    }
+
+    return out->complete;
+}
+
+/// @brief Turns the counts into the chance of each cell being a hit
+/// @param r The result of `bs_enum_run`
+/// @param k What's known about the board (cells that have been shot come out as 0)
+/// @param out The chance of each cell (index is the cell)
+void bs_enum_probabilities(const enum_result_t* r, const knowledge_t* k, float out[BB_CELLS]) {
+    bb_t shot = bs_bb_or(bs_bb_or(k->hits, k->misses), k->sunk);
+
+    for(uint8_t cell = 0; cell < BB_CELLS; cell++) {
+        if(r->layouts == 0 || bs_bb_test(shot, cell)) out[cell] = 0.0f;
+        else out[cell] = (float)((double)r->counts[cell] / (double)r->layouts);
+    }
+}
@@ -0,0 +1,55 @@
+/*
+    BSBOT made by William Dawson (MrBisquit on GitHub)
+    https://wtdawson.info
+
+    --------------------------------------------------------------------------------------------
+
+    Exact placement enumeration
+
+    Counts every legal layout of the ships that are still afloat that agrees with what's
+    known (hits, misses and sunk ships), and how many of those layouts have a ship on each
+    cell. Dividing the two gives the exact chance of each cell being a hit.
+
+    How long that takes goes from microseconds late in the game to seconds at the start, so
+    it's given a budget of work rather than nodes (a node that counts the last two ships does
+    a set operation for every placement of both, a few hundred times what the rest do). It
+    guesses the work before it starts, and if that's hopeless it gives up straight away.
+
+    --------------------------------------------------------------------------------------------
+
+ *  License:    SPDX-License-Identifier: MIT
+ *              See LICENSE file in the project root for full license text.
+*/
+
+#ifndef BSBOT_ENUMERATE_H
+#define BSBOT_ENUMERATE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "bitboard.h"
+#include "knowledge.h"
+#include "placement.h"
+
+#define ENUM_WORK_PER_MS    50000   // Roughly how much work one core gets through in a millisecond
+#define ENUM_HOPELESS       64      // Don't even start if the guess is more than this times `max_work`
+
+typedef struct {
+    uint64_t max_work;  // Give up after this much work (0 = never give up), see `ENUM_WORK_PER_MS`
+    volatile int32_t* cancel; // Give up as soon as this is set, from any thread (NULL = never)
+    const uint8_t (*weights)[PLACEMENT_MAX]; // How likely each ship's placements are (NULL = all the same, see `prior_weights_t`)
+} enum_limits_t;
+
+typedef struct {
+    uint64_t layouts;           // How many layouts agree with what's known (with `weights`, each one counts as its placements' weights multiplied)
+    uint64_t counts[BB_CELLS];  // How many of those have a ship on each cell (weighted the same way)
+    uint64_t nodes;             // How many nodes were visited
+    uint64_t work;              // How much work that was (a node, or one placement set operation)
+    uint64_t estimate;          // How much work it guessed it'd be before it started
+    bool complete;              // `false` if it gave up (the counts are then meaningless)
+} enum_result_t;
+
+void bs_enum_init(void);
+bool bs_enum_run(const knowledge_t* k, const enum_limits_t* limits, enum_result_t* out);
+void bs_enum_probabilities(const enum_result_t* r, const knowledge_t* k, float out[BB_CELLS]);
+
+#endif
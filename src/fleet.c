@@ -0,0 +1,170 @@
+/*
+    BSBOT made by William Dawson (MrBisquit on GitHub)
+    https://wtdawson.info
+
+    --------------------------------------------------------------------------------------------
+
+    Random fleets (See fleet.h)
+
+    --------------------------------------------------------------------------------------------
+
+ *  License:    SPDX-License-Identifier: MIT
+ *              See LICENSE file in the project root for full license text.
+*/
+
+#include <string.h>
+#include "fleet.h"
+
+#define FLEET_WEIGHT 1024 // Weight of a placement with no bias (so a bias can be a fraction of it)
+
+/// @brief Builds one ship's alias table (Vose's method), so a weighted pick is one lookup and a coin flip
+/// @return Returns `false` if every weight is 0
+static bool bs_fleet_alias(fleet_gen_t* gen, uint8_t ship, const uint32_t* weights) {
+    uint8_t n = gen->count[ship];
+    uint64_t total = 0;
+    for(uint8_t p = 0; p < n; p++) total += weights[p];
+    if(total == 0) return false;
+
+    // Everything's scaled by n, so the average is `total`
+    uint64_t scaled[PLACEMENT_MAX];
+    uint8_t small[PLACEMENT_MAX], large[PLACEMENT_MAX];
+    uint8_t small_count = 0, large_count = 0;
+
+    for(uint8_t p = 0; p < n; p++) {
+        scaled[p] = (uint64_t)weights[p] * n;
+        if(scaled[p] < total) small[small_count++] = p;
+        else large[large_count++] = p;
+    }
+
+    while(small_count > 0 && large_count > 0) {
+        uint8_t s = small[--small_count];
+        uint8_t l = large[--large_count];
+
+        gen->threshold[ship][s] = (scaled[s] << 32) / total;
+        gen->alias[ship][s] = l;
+
+        scaled[l] = (scaled[l] + scaled[s]) - total;
+        if(scaled[l] < total) small[small_count++] = l;
+        else large[large_count++] = l;
+    }
+
+    // Whatever's left is (within rounding) exactly average, so it always keeps itself
+    while(large_count > 0) {
+        uint8_t p = large[--large_count];
+        gen->threshold[ship][p] = 1ULL << 32;
+        gen->alias[ship][p] = p;
+    }
+    while(small_count > 0) {
+        uint8_t p = small[--small_count];
+        gen->threshold[ship][p] = 1ULL << 32;
+        gen->alias[ship][p] = p;
+    }
+
+    return true;
+}
+
+/// @brief Works out the tables for a set of rules
+/// @param gen The generator
+/// @param rules The rules (NULL = none, every legal layout equally likely)
+/// @return Returns `false` if the rules rule out a ship completely
+bool bs_fleet_init(fleet_gen_t* gen, const fleet_rules_t* rules) {
+    bs_placement_init();
+    memset(gen, 0, sizeof(fleet_gen_t));
+    if(rules != NULL) gen->rules = *rules;
+
+    float bias = gen->rules.edge_bias;
+    if(bias < -1.0f) bias = -1.0f;
+    gen->weighted = bias != 0.0f;
+
+    bb_t edge = bs_bb_or(bs_bb_or(bs_bb_row(0), bs_bb_row(BB_SIZE - 1)), bs_bb_or(bs_bb_col(0), bs_bb_col(BB_SIZE - 1)));
+    uint32_t edge_weight = (uint32_t)((FLEET_WEIGHT * (1.0f + bias)) + 0.5f);
+
+    for(uint8_t s = 0; s < FLEET_SIZE; s++) {
+        const ship_placements_t* table = &bs_ship_placements[s];
+        uint32_t weights[PLACEMENT_MAX];
+        gen->count[s] = table->count;
+
+        for(uint8_t p = 0; p < table->count; p++) {
+            const placement_t* placement = &table->list[p];
+            gen->mask[s][p] = placement->mask;
+            gen->blocks[s][p] = gen->rules.no_touch ? bs_bb_or(placement->mask, placement->halo) : placement->mask;
+            weights[p] = bs_bb_intersects(placement->mask, edge) ? edge_weight : FLEET_WEIGHT;
+        }
+
+        if(gen->weighted && !bs_fleet_alias(gen, s, weights)) return false;
+    }
+
+    return true;
+}
+
+/// @brief Picks a placement for every ship
+/// @param gen The generator (NULL = no rules, straight from the placement lists)
+/// @param rng The random number generator
+/// @param picks Each ship's placement (index into `bs_ship_placements[ship].list`)
+/// @return Returns `false` if nothing fitted after `FLEET_MAX_TRIES` goes
+bool bs_fleet_pick(const fleet_gen_t* gen, rng_t* rng, uint8_t picks[FLEET_SIZE]) {
+    if(gen == NULL) {
+        bs_placement_init();
+        for(uint32_t tries = 0; tries < FLEET_MAX_TRIES; tries++) {
+            bb_t occupied = bs_bb_empty();
+            uint8_t s = 0;
+
+            for(; s < FLEET_SIZE; s++) {
+                const ship_placements_t* table = &bs_ship_placements[s];
+                picks[s] = (uint8_t)bs_rng_below(rng, table->count);
+
+                bb_t mask = table->list[picks[s]].mask;
+                if(bs_bb_intersects(mask, occupied)) break;
+                occupied = bs_bb_or(occupied, mask);
+            }
+
+            if(s == FLEET_SIZE) return true;
+        }
+        return false;
+    }
+
+    for(uint32_t tries = 0; tries < FLEET_MAX_TRIES; tries++) {
+        bb_t blocked = bs_bb_empty();
+        uint8_t s = 0;
+
+        for(; s < FLEET_SIZE; s++) {
+            uint8_t p = (uint8_t)bs_rng_below(rng, gen->count[s]);
+            if(gen->weighted && (bs_rng_next(rng) & 0xFFFFFFFFULL) >= gen->threshold[s][p]) p = gen->alias[s][p];
+
+            // Only its own cells have to be clear, its halo just rules out the ones after it
+            if(bs_bb_intersects(gen->mask[s][p], blocked)) break;
+            blocked = bs_bb_or(blocked, gen->blocks[s][p]);
+            picks[s] = p;
+        }
+
+        if(s == FLEET_SIZE) return true;
+    }
+
+    return false;
+}
+
+/// @brief Generates one layout
+/// @param gen The generator (NULL = no rules)
+/// @param rng The random number generator
+/// @param places Each ship's cells (index is PLACE_x - 1)
+/// @return Returns `false` if nothing fitted (see `bs_fleet_pick`)
+bool bs_fleet_generate(const fleet_gen_t* gen, rng_t* rng, bb_t places[FLEET_SIZE]) {
+    uint8_t picks[FLEET_SIZE];
+    if(!bs_fleet_pick(gen, rng, picks)) return false;
+
+    for(uint8_t s = 0; s < FLEET_SIZE; s++) places[s] = gen != NULL ? gen->mask[s][picks[s]] : bs_ship_placements[s].list[picks[s]].mask;
+    return true;
+}
+
+/// @brief Generates lots of layouts into a buffer
+/// @param gen The generator (NULL = no rules)
+/// @param rng The random number generator
+/// @param out Where they go (`count` layouts)
+/// @param count How many to generate
+/// @return How many were generated (less than `count` only if the rules can't be met)
+uint32_t bs_fleet_generate_batch(const fleet_gen_t* gen, rng_t* rng, bb_t (*out)[FLEET_SIZE], uint32_t count) {
+    for(uint32_t i = 0; i < count; i++) {
+        if(!bs_fleet_generate(gen, rng, out[i])) return i;
+    }
+    return count;
+}
@@ -0,0 +1,56 @@
+/*
+    BSBOT made by William Dawson (MrBisquit on GitHub)
+    https://wtdawson.info
+
+    --------------------------------------------------------------------------------------------
+
+    Random fleets
+
+    Picks a placement for every ship (biggest first) and starts again if one doesn't fit, so
+    every legal layout is exactly as likely as it should be. Each pick is a single lookup (an
+    alias table when the placements aren't all equally likely), and a layout that's gone wrong
+    is thrown away as soon as a ship doesn't fit, so even with no-touch turned on it's well over
+    a million layouts a second.
+
+    Rules are worked out once into a `fleet_gen_t`, which is only read afterwards, so any
+    number of threads can share one (each with its own `rng_t`).
+
+    --------------------------------------------------------------------------------------------
+
+ *  License:    SPDX-License-Identifier: MIT
+ *              See LICENSE file in the project root for full license text.
+*/
+
+#ifndef BSBOT_FLEET_H
+#define BSBOT_FLEET_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "bitboard.h"
+#include "knowledge.h"
+#include "placement.h"
+#include "rng.h"
+
+#define FLEET_MAX_TRIES (1 << 20) // Layouts to try before giving up (only possible with rules nothing can meet)
+
+typedef struct {
+    bool no_touch;      // Ships can't be next to each other (diagonals included)
+    float edge_bias;    // How much more likely a ship touching the edge is (0 = no different, 1 = twice as likely, -1 = never)
+} fleet_rules_t;
+
+typedef struct {
+    fleet_rules_t rules;
+    bool weighted;                                  // Some placements are more likely than others (so the alias tables are used)
+    uint8_t count[FLEET_SIZE];
+    bb_t mask[FLEET_SIZE][PLACEMENT_MAX];           // Cells each placement covers (same order as the placement lists)
+    bb_t blocks[FLEET_SIZE][PLACEMENT_MAX];         // Cells it rules out for the rest (its own, and its halo with no-touch)
+    uint64_t threshold[FLEET_SIZE][PLACEMENT_MAX];  // Alias table: keep it if the next 32 bits are under this...
+    uint8_t alias[FLEET_SIZE][PLACEMENT_MAX];       // ...otherwise use this one
+} fleet_gen_t;
+
+bool bs_fleet_init(fleet_gen_t* gen, const fleet_rules_t* rules);
+bool bs_fleet_pick(const fleet_gen_t* gen, rng_t* rng, uint8_t picks[FLEET_SIZE]);
+bool bs_fleet_generate(const fleet_gen_t* gen, rng_t* rng, bb_t places[FLEET_SIZE]);
+uint32_t bs_fleet_generate_batch(const fleet_gen_t* gen, rng_t* rng, bb_t (*out)[FLEET_SIZE], uint32_t count);
+
+#endif
@@ -0,0 +1,554 @@
+/*
+    BSBOT made by William Dawson (MrBisquit on GitHub)
+    https://wtdawson.info
+
+    --------------------------------------------------------------------------------------------
+
+    The game itself (boards, ships, shooting) and the bot, without any graphics (See game.h)
+
+    --------------------------------------------------------------------------------------------
+
+ *  License:    SPDX-License-Identifier: MIT
+ *              See LICENSE file in the project root for full license text.
+*/
+
+#include <string.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "game.h"
+#include "enumerate.h"
+#include "placement.h"
+#include "prior.h"
+#include "layout.h"
+
+// Utils
+/// @brief Generates a new board
+/// @return The new board
+board_t bs_new_board(void) {
+    board_t b;
+    bs_new_board_ptr(&b);
+    return b;
+}
+/// @brief Generates a new board (Or clears an existing one)
+/// @param ptr The pointer to the board
+void bs_new_board_ptr(board_t* ptr) {
+    // Every bitboard being empty is the same as every place being PLACE_BLANK/HIT_BLANK
+    memset(ptr, 0, sizeof(board_t));
+
+    for(uint8_t i = 0; i < 5; i++) {
+        ptr->a_items[i].type = PLACE_HIT_INVALID;
+        ptr->b_items[i].type = PLACE_HIT_INVALID;
+    }
+}
+
+/// @brief Converts Vector2 coodinates to a string (E.g. A1)
+/// @param coords Vector2 coordinates
+/// @return The string (3 characters)
+const char* bs_coords_to_string(Vector2 coords) {
+    char* str = malloc(sizeof(char) * 3);
+    if(coords.x == 10) {
+        const char* text = (char[]){ 'A' + coords.y, '1', '0' };
+        strcpy(str, text);
+    } else {
+        const char* text = (char[]){ 'A' + coords.y, '1' + coords.x + 1, ' ' };
+        strcpy(str, text);
+    }
+    return str;
+}
+
+/// @brief Checks which squares in the grid the rectangle is in
+/// @param rect The rectangle
+/// @param offset_x X offset (Top-left X coordinate)
+/// @param offset_y Y offset (Top-left Y coordinate)
+/// @return The squares in the grid that the rectangle is in (touching an edge counts)
+grid_check_return_t bs_grid_check(Rectangle rect, uint32_t offset_x, uint32_t offset_y) {
+    layout_t layout = bs_layout((float)offset_x, (float)offset_y, 1.0f);
+
+    grid_check_return_t grid;
+    grid.grid = bs_layout_cells_in(&layout, rect);
+    grid.total = bs_bb_popcount(grid.grid);
+    return grid;
+}
+
+/// @brief Every item, as it starts off (index is `game_item_t`)
+static const item_t bs_items[5] = {
+    { .type = PLACE_AC, .places = 5, .size_normal = { .x = 32 / 2, .y = (32 * 5) - (32 / 2) }, .size_hovering = { .x = 10, .y = 135 } },
+    { .type = PLACE_BS, .places = 4, .size_normal = { .x = 32 / 2, .y = (32 * 4) - (32 / 2) }, .size_hovering = { .x = 10, .y = 100 } },
+    { .type = PLACE_DS, .places = 3, .size_normal = { .x = 32 / 2, .y = (32 * 3) - (32 / 2) }, .size_hovering = { .x = 10, .y = 65 } },
+    { .type = PLACE_SB, .places = 3, .size_normal = { .x = 32 / 2, .y = (32 * 3) - (32 / 2) }, .size_hovering = { .x = 10, .y = 65 } },
+    { .type = PLACE_PB, .places = 2, .size_normal = { .x = 32 / 2, .y = (32 * 2) - (32 / 2) }, .size_hovering = { .x = 10, .y = 35 } }
+};
+
+/// @brief Gets an item
+/// @param type The type of item
+/// @return The item
+item_t bs_get_item(game_item_t type) {
+    return bs_items[type];
+}
+
+/// @brief Check if 2 rectangles overlap
+/// @param a Rectangle A
+/// @param b Rectangle B
+/// @return If the 2 rectangles overlap
+bool bs_rect_overlap(Rectangle a, Rectangle b) {
+    float a_x1 = a.x;
+    float a_y1 = a.y;
+    float a_x2 = a.x + a.width;
+    float a_y2 = a.y + a.height;
+
+    float b_x1 = b.x;
+    float b_y1 = b.y;
+    float b_x2 = b.x + b.width;
+    float b_y2 = b.y + b.height;
+
+    /* This only selects the top and bottom squares
+    bool tl, tr, bl, br = false;
+    tl = bs_point_in_rect((Vector2){ .x = b_x1, .y = b_y1 }, a);
+    tr = bs_point_in_rect((Vector2){ .x = b_x2, .y = b_y1 }, a);
+    bl = bs_point_in_rect((Vector2){ .x = b_x1, .y = b_y2 }, a);
+    br = bs_point_in_rect((Vector2){ .x = b_x2, .y = b_y2 }, a);
+
+    if((tl && tr) || (tl && bl) || (bl && br) || (br && tr))
+        return true;
+    else
+        return false;*/
+
+    /*if(a_x1 < b_x2 && a_x2 > b_x1 && a_y1 > b_y2 && a_y2 < b_y1) {
+        return true;
+    } else {
+        return false;
+    }*/
+
+    if(a_x1 <= b_x2 && a_x2 >= b_x1 && a_y1 <= b_y2 && a_y2 >= b_y1) {
+        return true;
+    } else {
+        return false;
+    }
+
+    // indicates whether or not the specified rectangle intersects with this rectangle
+/*constexpr bool intersects(const rectx& rect) const {
+    return (left() <= rect.right() && right()>= rect.left() &&
+        top() <= rect.bottom() && bottom() >= rect.top() ); 
+}*/
+}
+
+/// @brief Check is a point is inside a rectangle
+/// @param point The point to check
+/// @param rect The rectangle
+/// @return If the point is inside the rectangle
+bool bs_point_in_rect(Vector2 point, Rectangle rect) {
+    float px = point.x;
+    float py = point.y;
+
+    float x1 = rect.x;
+    float y1 = rect.y;
+    float x2 = rect.x + rect.width;
+    float y2 = rect.y + rect.height;
+
+    if(px >= x1 && px <= x2 && py >= y1 && py <= y2) {
+        return true;
+    } else {
+        return false;
+    }
+}
+
+/// @brief Adds an item into the array (if it can fit)
+/// @param array The array
+/// @param item The item to add into the array
+/// @return Returns `true` if it could fit it into the array, `false` if not
+bool bs_add_item(item_t array[5], item_t item) {
+    for(uint8_t i = 0; i < 5; i++) {
+        if(array[i].type == PLACE_HIT_INVALID) {
+            memcpy(&array[i], &item, sizeof(item_t));
+
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/// @brief Checks if the player can place something on the grid
+/// @param occupied The cells that already have something on them
+/// @param item The item to check (`relative_pos` is the first cell it takes up)
+/// @return Returns `true` if it can fit on the grid, `false` if not
+bool bs_check_add_item(bb_t occupied, item_t item) {
+    bb_t mask = bs_item_mask(item);
+    if(bs_bb_is_empty(mask)) return false; // Goes off the edge of the grid
+
+    return !bs_bb_intersects(mask, occupied);
+}
+
+/// @brief Gets the cells an item takes up on the grid
+/// @param item The item (`relative_pos` is the first cell it takes up)
+/// @return The cells, or an empty bitboard if it doesn't fit on the grid
+bb_t bs_item_mask(item_t item) {
+    uint32_t x = (uint32_t)(int32_t)item.relative_pos.x; // Negative ends up huge, so one check covers both ends
+    uint32_t y = (uint32_t)(int32_t)item.relative_pos.y;
+    uint32_t ship = (uint32_t)item.type - PLACE_AC;
+    if(ship >= FLEET_SIZE || item.rotation > 1 || x >= BB_SIZE || y >= BB_SIZE) return bs_bb_empty();
+
+    bs_placement_init();
+    return bs_placement(ship, item.rotation, bs_bb_index(x, y))->mask;
+}
+
+/// @brief Places an item onto one side of the board
+/// @param side The side of the board
+/// @param item The item to place
+/// @return Returns `true` if it was placed, `false` if it doesn't fit
+bool bs_place_item(side_t* side, item_t item) {
+    if(item.type < PLACE_AC || item.type > PLACE_PB) return false;
+    if(!bs_check_add_item(side->occupied, item)) return false;
+
+    bb_t mask = bs_item_mask(item);
+    side->places[item.type - 1] = mask;
+    side->occupied = bs_bb_or(side->occupied, mask);
+
+    return true;
+}
+
+/// @brief Fires a shot at one side of the board
+/// @param side The side being shot at
+/// @param cell The cell index (See `bs_bb_index`)
+/// @return `HIT_BLANK` for a miss, `HIT_x` for a hit (with `HIT_SUNK` if that sunk it), or `PLACE_HIT_INVALID` if it's already been shot
+uint8_t bs_fire(side_t* side, uint8_t cell) {
+    if(cell >= BB_CELLS) return PLACE_HIT_INVALID;
+
+    bb_t shot = bs_bb_cell(cell);
+    if(bs_bb_intersects(shot, bs_bb_or(side->hitmap, side->missmap))) return PLACE_HIT_INVALID;
+
+    if(!bs_bb_intersects(shot, side->occupied)) {
+        side->missmap = bs_bb_or(side->missmap, shot);
+        return HIT_BLANK;
+    }
+
+    side->hitmap = bs_bb_or(side->hitmap, shot);
+
+    for(uint8_t i = 0; i < 5; i++) {
+        if(!bs_bb_intersects(shot, side->places[i])) continue;
+
+        // Sunk once every cell of the ship has been hit
+        if(bs_bb_is_empty(bs_bb_andnot(side->places[i], side->hitmap))) {
+            side->sunk |= 1 << i;
+            return (i + 1) | HIT_SUNK;
+        }
+
+        return i + 1;
+    }
+
+    return PLACE_HIT_INVALID; // Shouldn't be possible, occupied is made from places
+}
+
+/// @brief Gets what the other player knows about one side of the board
+/// @param side The side of the board
+/// @return The hits, misses and sunk ships (sunk ships are revealed, the rest aren't)
+knowledge_t bs_side_knowledge(const side_t* side) {
+    knowledge_t k;
+    k.sunk = bs_bb_empty();
+    k.afloat = FLEET_ALL & ~side->sunk;
+
+    for(uint8_t i = 0; i < FLEET_SIZE; i++) {
+        if(side->sunk & (1 << i)) k.sunk = bs_bb_or(k.sunk, side->places[i]);
+    }
+
+    k.hits = bs_bb_andnot(side->hitmap, k.sunk);
+    k.misses = side->missmap;
+
+    return k;
+}
+
+/// @brief Places every ship at random
+/// @note Every legal layout is equally likely (or as likely as the rules make it, see fleet.h)
+/// @param side The side of the board to place them on (anything already there is cleared)
+/// @param items Filled with the placed items (can be NULL)
+/// @param gen The rules to place them by (NULL = none)
+/// @param rng The random number generator
+/// @return Returns `false` if the rules couldn't be met (the side is left alone)
+bool bs_random_fleet(side_t* side, item_t items[5], const fleet_gen_t* gen, rng_t* rng) {
+    uint8_t picks[FLEET_SIZE];
+    if(!bs_fleet_pick(gen, rng, picks)) return false;
+
+    bs_place_fleet(side, items, picks);
+    return true;
+}
+
+/// @brief Places every ship where it's been picked to go
+/// @note Nothing's checked, the picks have to fit together (like `bs_fleet_pick` or `bs_defense_run` gives)
+/// @param side The side of the board to place them on (anything already there is cleared)
+/// @param items Filled with the placed items (can be NULL)
+/// @param picks Each ship's placement (see placement.h)
+void bs_place_fleet(side_t* side, item_t items[5], const uint8_t picks[FLEET_SIZE]) {
+    memset(side, 0, sizeof(side_t));
+    for(uint8_t i = 0; i < 5; i++) {
+        const placement_t* placed = &bs_ship_placements[i].list[picks[i]];
+        side->places[i] = placed->mask;
+        side->occupied = bs_bb_or(side->occupied, placed->mask);
+
+        if(items != NULL) {
+            items[i] = bs_get_item((game_item_t)i);
+            items[i].rotation = placed->rotation;
+            items[i].relative_pos.x = placed->cell % BB_SIZE;
+            items[i].relative_pos.y = placed->cell / BB_SIZE;
+            items[i].pos = items[i].relative_pos;
+        }
+    }
+}
+
+/// @brief Gets the relative coordinates of a position on a grid from the provided position
+/// @param offset_x X offset (Top-left X coordinate)
+/// @param offset_y Y offset (Top-left Y coordinate)
+/// @param pos The position
+/// @return The relative grid coordinates to the provided position (-1, -1 if it's not on a cell)
+Vector2 bs_get_grid_pos(int32_t offset_x, int32_t offset_y, Vector2 pos) {
+    layout_t layout = bs_layout((float)offset_x, (float)offset_y, 1.0f);
+
+    uint8_t cell = bs_layout_cell_at(&layout, pos);
+    if(cell == LAYOUT_OUTSIDE) return (Vector2){ .x = -1, .y = -1 };
+    return (Vector2){ .x = cell % BB_SIZE, .y = cell / BB_SIZE };
+}
+
+/*
+    Bot functionality
+*/
+
+/*
+    The bot is (probably) the most complex part of this project.
+    All 100 (10x10) squares start on a fair possibility (0.5), and (for obvious reasons)
+    the player has to place first.
+
+    Unlike what I did for nacbot, which was to basically simulate every possible win and find
+    the most likely move that would win and place there, it would be too computationally heavy,
+    and time consuming to that for battleship. So it'll be a similar set up, but modifying the
+    values as the game progresses.
+
+    (Update: the exact mode in `enumerate.c` does count every layout now, but it prunes hard
+    and gives up after `max_work`, a millisecond by default (or straight away if it can tell it
+    won't fit). It's only really too heavy near the start of the game, so then it samples
+    random layouts instead (`montecarlo.c`), and if even that finds nothing it
+    falls back to the values below. The density mode (`density.c`) is the cheap one, it just
+    counts where each ship could still go, and only touches what a shot changes.)
+
+    The possibilities go up and down based on both boards, since if the player attacks somewhere
+    and hits nothing, we can vaguely guess that it may be somewhere around where they placed one
+    of theirs. So we increment everything within a 3x3 area of that with some amount. Since it's
+    a guess, we don't increment it by much.
+
+    When we hit something, we can use an algorithm to guess where to place next, also incrementing
+    values in a sort of 3x3 area. It's actually more of a diamond shape that a square. Since it's
+    middle gets set to 0, since it's a hit, meaning ignore that value, then the top, left, right,
+    and bottom all increment significantly.
+    
+    When a ship is destroyed, we can decrement the possibility of everything around it by some
+    small amount, since I doubt players are likely to place them directly next to each other.
+    (Though this may be a bad idea)
+*/
+
+/// @brief Initialise the bot
+/// @param ptr The pointer to the bot
+void bs_bot_init(bot_t* ptr) {
+    memset(ptr, 0, sizeof(bot_t));
+
+    bs_poss_fill(ptr->possibilities, POSS_FIXED(0.5f));
+
+    ptr->mode = BOT_MODE_EXACT;
+    ptr->max_work = ENUM_WORK_PER_MS; // 1ms, anything longer goes to the sampler
+    ptr->sampling.max_samples = 1 << 18;
+    ptr->sampling.max_time_ns = 50000000; // 50ms
+    ptr->sampling.confidence = 0.005f;
+    ptr->search.max_time_ns = 5000000; // 5ms
+    ptr->search.max_depth = 4;
+    ptr->search.width = 4;
+    ptr->pool = NULL;
+    ptr->randomness = true;
+    bs_density_init(&ptr->density, NULL);
+    ptr->book = NULL;
+    ptr->book_node = 0;
+    ptr->planned = BB_CELLS;
+    bs_bot_seed(ptr, 0);
+}
+
+/// @brief Seeds everything random the bot does (which of the top moves it picks, and the sampling)
+/// @param ptr The pointer to the bot
+/// @param seed The seed (the same seed always plays the same way)
+void bs_bot_seed(bot_t* ptr, uint64_t seed) {
+    ptr->sampling.seed = bs_splitmix64(&seed);
+    bs_rng_seed(&ptr->rng, bs_splitmix64(&seed));
+}
+
+/// @brief Starts the bot off from what players usually do, instead of every cell being the same
+/// @note Set it before the first shot. The weights are used where they are (usually a mapped
+///       prior file), so they have to stay there until the game's over.
+/// @param ptr The pointer to the bot
+/// @param prior The weights (NULL to go back to none)
+void bs_bot_prior(bot_t* ptr, const prior_weights_t* prior) {
+    ptr->prior = prior;
+    ptr->prior_hash = 0;
+
+    if(prior == NULL) {
+        bs_poss_fill(ptr->possibilities, POSS_FIXED(0.5f));
+        bs_density_init(&ptr->density, NULL);
+        return;
+    }
+
+    // Already in the same layout as the possibilities
+    memcpy(ptr->possibilities, prior->cells, sizeof(ptr->possibilities));
+    bs_density_init(&ptr->density, prior->placements);
+
+    // The file's topped up after every game, so it's what's in it that goes in the cache key
+    // (FNV-1a, it's only done once a game)
+    uint64_t hash = 0xCBF29CE484222325ULL;
+    for(uint8_t s = 0; s < FLEET_SIZE; s++) {
+        for(uint8_t p = 0; p < PLACEMENT_MAX; p++) hash = (hash ^ prior->placements[s][p]) * 0x100000001B3ULL;
+    }
+    ptr->prior_hash = hash;
+}
+
+/// @brief Updates the bot after one of its own shots
+/// @param ptr The pointer to the bot
+/// @param cell The cell it shot at
+/// @param result The result from `bs_fire`
+/// @param sunk The cells of the ship that was sunk (only used if `result` has `HIT_SUNK`)
+void bs_bot_observe(bot_t* ptr, uint8_t cell, uint8_t result, bb_t sunk) {
+    if(result == PLACE_HIT_INVALID) return;
+
+    bb_t shot = bs_bb_cell(cell);
+    bs_poss_set(ptr->possibilities, cell, 0); // Either way it's been shot now
+
+    if(ptr->book != NULL) {
+        if(result & HIT_SUNK) ptr->book_node = BOOK_OUT;
+        else ptr->book_node = bs_book_next(ptr->book, ptr->book_node, result != HIT_BLANK);
+    }
+
+    if(result == HIT_BLANK) bs_density_miss(&ptr->density, cell);
+    else if(result & HIT_SUNK) bs_density_sunk(&ptr->density, (result & ~HIT_SUNK) - 1, sunk);
+    else bs_density_hit(&ptr->density, cell);
+
+    if(result & HIT_SUNK) {
+        // Players probably don't put their ships right next to each other
+        const placement_t* p = bs_placement_find((result & ~HIT_SUNK) - 1, sunk);
+        bs_poss_sub(ptr->possibilities, p != NULL ? p->halo : bs_bb_neighbours8(sunk), POSS_FIXED(0.1f));
+    } else if(result != HIT_BLANK) {
+        // The rest of the ship has to be above, below, left or right of it
+        bs_poss_add(ptr->possibilities, bs_bb_neighbours4(shot), POSS_FIXED(0.4f));
+    }
+}
+
+/// @brief Updates the bot after the player shoots at it
+/// @param ptr The pointer to the bot
+/// @param cell The cell the player shot at
+/// @param result The result from `bs_fire`
+void bs_bot_observe_opponent(bot_t* ptr, uint8_t cell, uint8_t result) {
+    if(result != HIT_BLANK) return;
+
+    // A miss is a (vague) hint that one of their own ships is nearby
+    bs_poss_add(ptr->possibilities, bs_bb_neighbours8(bs_bb_cell(cell)), POSS_FIXED(0.02f));
+}
+
+/// @brief Hashes everything that changes what `bs_bot_think` works out (apart from the position)
+static uint64_t bs_bot_settings_hash(const bot_t* ptr) {
+    uint32_t confidence;
+    memcpy(&confidence, &ptr->sampling.confidence, sizeof(confidence));
+
+    uint64_t x = ptr->mode;
+    uint64_t hash = bs_splitmix64(&x);
+    x = hash ^ ptr->max_work;
+    hash = bs_splitmix64(&x);
+    x = hash ^ ptr->sampling.max_samples;
+    hash = bs_splitmix64(&x);
+    x = hash ^ ptr->sampling.max_time_ns ^ ((uint64_t)confidence << 32);
+    hash = bs_splitmix64(&x);
+    x = hash ^ ptr->sampling.seed;
+    hash = bs_splitmix64(&x);
+    x = hash ^ ptr->prior_hash;
+    return bs_splitmix64(&x);
+}
+
+/// @brief Works out the possibilities before the bot's next shot
+/// @param ptr The pointer to the bot
+/// @param k What the bot knows about the player's side of the board
+void bs_bot_think(bot_t* ptr, const knowledge_t* k) {
+    ptr->planned = BB_CELLS;
+    if(ptr->book != NULL && ptr->book_node != BOOK_OUT) {
+        uint8_t move = bs_book_move(ptr->book, ptr->book_node);
+        if(move < BB_CELLS) {
+            ptr->planned = move; // Already worked out, nothing to do
+            return;
+        }
+    }
+
+    if(ptr->mode == BOT_MODE_HEURISTIC) return;
+
+    if(ptr->mode == BOT_MODE_DENSITY) {
+        bs_density_possibilities(&ptr->density, ptr->possibilities);
+        return;
+    }
+
+    // The other engines work in floats, then it's squashed into the grid
+    float p[BB_CELLS];
+
+    // The lookahead picks its own move (it's not always the most likely cell), the grid's only for show
+    if(ptr->mode == BOT_MODE_LOOKAHEAD) {
+        search_limits_t limits = ptr->search;
+        limits.cancel = ptr->cancel;
+        if(bs_search_run(k, &limits, &ptr->searched, p)) {
+            bs_poss_from_float(ptr->possibilities, p);
+            ptr->planned = ptr->searched.move;
+        }
+        return;
+    }
+
+    // Only the slow modes are worth caching
+    uint64_t key = 0;
+    if(ptr->cache != NULL) {
+        key = bs_zobrist_hash(k) ^ bs_bot_settings_hash(ptr);
+        if(key == 0) key = 1;
+        if(bs_cache_get(ptr->cache, key, p)) {
+            bs_poss_from_float(ptr->possibilities, p);
+            return;
+        }
+    }
+
+    if(ptr->mode == BOT_MODE_EXACT) {
+        enum_result_t result;
+        enum_limits_t limits = { .max_work = ptr->max_work, .cancel = ptr->cancel };
+        if(ptr->prior != NULL) limits.weights = ptr->prior->placements;
+
+        if(bs_enum_run(k, &limits, &result) && result.layouts > 0) {
+            bs_enum_probabilities(&result, k, p);
+            bs_poss_from_float(ptr->possibilities, p);
+            if(ptr->cache != NULL) bs_cache_put(ptr->cache, key, p);
+            return;
+        }
+    }
+
+    // Too many layouts to count (or asked to sample), so sample some instead
+    mc_limits_t limits = ptr->sampling;
+    mc_result_t result;
+    limits.seed += bs_bb_popcount(bs_bb_or(bs_bb_or(k->hits, k->misses), k->sunk));
+    limits.cancel = ptr->cancel;
+    if(ptr->prior != NULL) limits.weights = ptr->prior->placements;
+
+    // If nothing fits either, the heuristic values are left as they were
+    if(bs_mc_run(ptr->pool, k, &limits, &result, p)) {
+        bs_poss_from_float(ptr->possibilities, p);
+        // Anything that was cut short (by the time limit or cancelling) isn't what working it
+        // out again would give, so it'd be wrong for every later game that looked it up
+        if(ptr->cache != NULL && !result.cut_short) bs_cache_put(ptr->cache, key, p);
+    }
+}
+
+/// @brief Picks the next cell for the bot to shoot at
+/// @note If the opening book (or the lookahead) has a move, that's the one
+/// @param ptr The pointer to the bot
+/// @param shot The cells that have already been shot at
+/// @return The cell index, or `BB_CELLS` if there's nowhere left
+uint8_t bs_bot_pick(bot_t* ptr, bb_t shot) {
+    if(ptr->planned < BB_CELLS && !bs_bb_test(shot, ptr->planned)) return ptr->planned;
+
+    uint8_t best[POSS_TOP];
+    uint8_t found = bs_poss_top(ptr->possibilities, shot, best, ptr->randomness ? POSS_TOP : 1);
+
+    if(found == 0) return BB_CELLS;
+    return best[ptr->randomness ? bs_rng_below(&ptr->rng, found) : 0];
+}
@@ -0,0 +1,170 @@
+/*
+    BSBOT made by William Dawson (MrBisquit on GitHub)
+    https://wtdawson.info
+
+    --------------------------------------------------------------------------------------------
+
+    The game itself (boards, ships, shooting) and the bot, without any graphics.
+
+    None of this needs raylib, so the headless tools (like bsbot_sim) can use it too. If raylib
+    has been included first, its Vector2 and Rectangle are used, otherwise identical ones are
+    defined here.
+
+    --------------------------------------------------------------------------------------------
+
+ *  License:    SPDX-License-Identifier: MIT
+ *              See LICENSE file in the project root for full license text.
+*/
+
+#ifndef BSBOT_GAME_H
+#define BSBOT_GAME_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "bitboard.h"
+#include "knowledge.h"
+#include "montecarlo.h"
+#include "search.h"
+#include "density.h"
+#include "possibilities.h"
+#include "cache.h"
+#include "book.h"
+#include "pool.h"
+#include "rng.h"
+#include "fleet.h"
+
+#ifndef RAYLIB_H
+typedef struct Vector2 {
+    float x;
+    float y;
+} Vector2;
+
+typedef struct Rectangle {
+    float x;
+    float y;
+    float width;
+    float height;
+} Rectangle;
+#endif
+
+#define PLACE_BLANK 0
+#define PLACE_AC    1 // Aircraft carrier
+#define PLACE_BS    2 // Battleship
+#define PLACE_DS    3 // Destroyer
+#define PLACE_SB    4 // Submarine
+#define PLACE_PB    5 // Patrol Boat
+#define HIT_BLANK   0
+#define HIT_AC      1 // Aircraft carrier
+#define HIT_BS      2 // Battleship
+#define HIT_DS      3 // Destroyer
+#define HIT_SB      4 // Submarine
+#define HIT_PB      5 // Patrol Boat
+
+#define HIT_SUNK    0x80 // OR'd into the result of `bs_fire` when the shot sinks the ship
+
+#define PLACE_HIT_INVALID 0xFF
+
+typedef enum {
+    BOT_MODE_HEURISTIC,     // Only nudge the possibilities around each shot
+    BOT_MODE_EXACT,         // Count every layout that fits (falls back to sampling if it's too slow)
+    BOT_MODE_MONTE_CARLO,   // Sample random layouts that fit
+    BOT_MODE_DENSITY,       // Count placements that fit, updated a shot at a time (cheap, but ignores overlaps)
+    BOT_MODE_LOOKAHEAD      // Look a few shots ahead, as far as it can in the time it has
+} bot_mode_t;
+
+typedef struct {
+    poss_row_t possibilities[BB_SIZE]; // [y][x] in fixed point (see possibilities.h)
+
+    bot_mode_t mode;
+    uint64_t max_work;      // How much work the exact mode can do before giving up (0 = no limit, see enumerate.h)
+    mc_limits_t sampling;   // When Monte Carlo sampling stops (the seed is mixed with the move number)
+    search_limits_t search; // When the lookahead stops
+    search_result_t searched; // How far the last lookahead got
+    pool_t* pool;           // Threads to sample on (NULL = only the calling thread)
+    bool randomness;        // Pick randomly between the top 3 moves
+    rng_t rng;              // For picking between them (see `bs_bot_seed`)
+    density_t density;      // Kept up to date by `bs_bot_observe` in every mode
+    cache_t* cache;         // Positions it's already worked out (NULL = don't cache)
+    const book_t* book;     // Opening book (NULL = none, set it before the first shot)
+    uint64_t book_node;     // Where it is in the book (`BOOK_OUT` once it's left)
+    uint8_t planned;        // The book's (or the lookahead's) move for this turn (`BB_CELLS` = none)
+    const struct prior_weights* prior; // What players usually do (NULL = none, see `bs_bot_prior`)
+    uint64_t prior_hash;    // Hash of its placement weights, so cached positions from a different prior aren't used
+    volatile int32_t* cancel; // Stops thinking part way through when it's set (NULL = never, see thinker.h)
+} bot_t;
+
+/// @brief This is either an aircraft carrier, battleship, destroyer, submarine, or patrol boat
+typedef struct {
+    uint8_t type;
+    uint8_t rotation; // 0 = Horizontal, 1 = Vertical
+    uint8_t places; // How many places it takes up (horizontally or vertically)
+
+    // These are defined for easily working things out during rendering
+    Vector2 size_normal;
+    Vector2 size_hovering;
+
+    // Position (This can be ignored unless used in rendering)
+    Vector2 pos;
+    Vector2 relative_pos;
+} item_t;
+
+/// @brief One player's half of the board (their ships, and the shots fired at them)
+typedef struct {
+    bb_t places[5];     // Each ship's cells (index is PLACE_x - 1)
+    bb_t occupied;      // Every cell with a ship on it
+    bb_t hitmap;        // Shots that hit something
+    bb_t missmap;       // Shots that missed
+    uint8_t sunk;       // One bit per ship (1 << (PLACE_x - 1))
+} side_t;
+
+typedef struct {
+    side_t a;
+    side_t b;
+
+    item_t a_items[5];
+    item_t b_items[5];
+} board_t;
+
+/// @brief Return value for a grid check
+typedef struct {
+    bb_t grid;
+    uint8_t total;
+} grid_check_return_t;
+
+typedef enum {
+    BS_Aircraft_Carrier,
+    BS_Battleship,
+    BS_Destroyer,
+    BS_Submarine,
+    BS_Patrol_Boat
+} game_item_t;
+
+// Utils
+board_t bs_new_board(void);
+void bs_new_board_ptr(board_t* ptr); // Usually just used to clear the board
+const char* bs_coords_to_string(Vector2 coords);
+grid_check_return_t bs_grid_check(Rectangle rect, uint32_t offset_x, uint32_t offset_y);
+item_t bs_get_item(game_item_t type);
+bool bs_rect_overlap(Rectangle a, Rectangle b);
+bool bs_point_in_rect(Vector2 point, Rectangle rect);
+bool bs_add_item(item_t array[5], item_t item);
+bool bs_check_add_item(bb_t occupied, item_t item);
+bb_t bs_item_mask(item_t item);
+bool bs_place_item(side_t* side, item_t item);
+uint8_t bs_fire(side_t* side, uint8_t cell);
+knowledge_t bs_side_knowledge(const side_t* side);
+Vector2 bs_get_grid_pos(int32_t offset_x, int32_t offset_y, Vector2 pos);
+bool bs_random_fleet(side_t* side, item_t items[5], const fleet_gen_t* gen, rng_t* rng);
+void bs_place_fleet(side_t* side, item_t items[5], const uint8_t picks[FLEET_SIZE]);
+
+// Bot
+void bs_bot_init(bot_t* ptr);
+void bs_bot_seed(bot_t* ptr, uint64_t seed);
+void bs_bot_prior(bot_t* ptr, const struct prior_weights* prior);
+void bs_bot_observe(bot_t* ptr, uint8_t cell, uint8_t result, bb_t sunk);
+void bs_bot_observe_opponent(bot_t* ptr, uint8_t cell, uint8_t result);
+void bs_bot_think(bot_t* ptr, const knowledge_t* k);
+uint8_t bs_bot_pick(bot_t* ptr, bb_t shot);
+
+#endif
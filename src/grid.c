@@ -0,0 +1,268 @@
+/*
+    BSBOT made by William Dawson (MrBisquit on GitHub)
+    https://wtdawson.info
+
+    --------------------------------------------------------------------------------------------
+
+    Boards of any size (See grid.h)
+
+    --------------------------------------------------------------------------------------------
+
+ *  License:    SPDX-License-Identifier: MIT
+ *              See LICENSE file in the project root for full license text.
+*/
+
+#include <string.h>
+#include "grid.h"
+
+/// @brief Gets the bits for `length` cells in a row, starting at `x`
+static inline uint32_t bs_grid_run(uint8_t x, uint8_t length) {
+    return (uint32_t)((((uint64_t)1 << length) - 1) << x);
+}
+
+static inline bool bs_grid_test(const grid_bits_t* bits, uint8_t x, uint8_t y) {
+    return (bits->rows[y] >> x) & 1;
+}
+
+static inline void bs_grid_set(grid_bits_t* bits, uint8_t x, uint8_t y) {
+    bits->rows[y] |= 1u << x;
+}
+
+/// @brief How much a placement counts for, by how many hits it covers (like `bs_density_weights`)
+static inline uint64_t bs_grid_weight(uint8_t hits, uint8_t length) {
+    if(hits >= length) return 0; // It'd be sunk
+    return 1ULL << (4 * (hits < GRID_HIT_MAX ? hits : GRID_HIT_MAX));
+}
+
+/// @brief Sets up the rules for a game
+/// @param rules The rules
+/// @param width How wide the board is (1 to GRID_MAX)
+/// @param height How tall the board is (1 to GRID_MAX)
+/// @param lengths How long each ship is
+/// @param count How many ships (1 to GRID_MAX_SHIPS)
+/// @return Returns `false` if the board's too big, or a ship can't fit on it at all
+bool bs_grid_rules(grid_rules_t* rules, uint8_t width, uint8_t height, const uint8_t* lengths, uint8_t count) {
+    memset(rules, 0, sizeof(grid_rules_t));
+    if(width == 0 || height == 0 || width > GRID_MAX || height > GRID_MAX) return false;
+    if(count == 0 || count > GRID_MAX_SHIPS) return false;
+
+    uint32_t total = 0;
+    for(uint8_t s = 0; s < count; s++) {
+        if(lengths[s] == 0 || (lengths[s] > width && lengths[s] > height)) return false;
+        total += lengths[s];
+    }
+    if(total > (uint32_t)width * height) return false;
+
+    rules->width = width;
+    rules->height = height;
+    rules->count = count;
+    rules->cells = (uint16_t)(width * height);
+    memcpy(rules->lengths, lengths, count);
+    return true;
+}
+
+/// @brief Places a fleet at random (every ship is placed somewhere random that it fits, in order)
+/// @param side The side (cleared first)
+/// @param rules The rules (kept, so they have to stay around)
+/// @param rng Where the randomness comes from
+/// @return Returns `false` if no fleet fit after `GRID_MAX_TRIES` tries
+bool bs_grid_random_fleet(grid_side_t* side, const grid_rules_t* rules, rng_t* rng) {
+    for(uint32_t tries = 0; tries < GRID_MAX_TRIES; tries++) {
+        memset(side, 0, sizeof(grid_side_t));
+        memset(side->ship, GRID_NONE, sizeof(side->ship));
+        side->rules = rules;
+
+        uint8_t placed = 0;
+        for(; placed < rules->count; placed++) {
+            uint8_t length = rules->lengths[placed];
+            bool fits = false;
+
+            // A few goes at this ship, if it doesn't fit the whole fleet starts again
+            for(uint32_t attempt = 0; attempt < 64 && !fits; attempt++) {
+                uint8_t rotation = (uint8_t)bs_rng_below(rng, 2);
+                if(length > (rotation ? rules->width : rules->height)) rotation ^= 1;
+
+                uint8_t x = (uint8_t)bs_rng_below(rng, rules->width - (rotation ? length - 1 : 0));
+                uint8_t y = (uint8_t)bs_rng_below(rng, rules->height - (rotation ? 0 : length - 1));
+
+                fits = true;
+                if(rotation) fits = !(side->occupied.rows[y] & bs_grid_run(x, length));
+                else for(uint8_t i = 0; i < length && fits; i++) fits = !bs_grid_test(&side->occupied, x, y + i);
+                if(!fits) continue;
+
+                for(uint8_t i = 0; i < length; i++) {
+                    uint8_t cx = rotation ? x + i : x;
+                    uint8_t cy = rotation ? y : y + i;
+                    bs_grid_set(&side->occupied, cx, cy);
+                    side->ship[bs_grid_index(rules, cx, cy)] = placed;
+                }
+                side->start[placed] = bs_grid_index(rules, x, y);
+                side->rotation[placed] = rotation;
+                side->left[placed] = length;
+            }
+            if(!fits) break;
+        }
+
+        if(placed == rules->count) return true;
+    }
+
+    return false;
+}
+
+/// @brief Fires at a cell
+/// @param side The side
+/// @param cell The cell
+/// @return `HIT_BLANK`, the ship's number + 1 (OR'd with `HIT_SUNK` if that sank it), or `PLACE_HIT_INVALID` if it's already been shot
+uint8_t bs_grid_fire(grid_side_t* side, uint16_t cell) {
+    const grid_rules_t* rules = side->rules;
+    if(cell >= rules->cells) return PLACE_HIT_INVALID;
+
+    uint8_t x = cell % rules->width;
+    uint8_t y = cell / rules->width;
+    if(bs_grid_test(&side->shot, x, y)) return PLACE_HIT_INVALID;
+    bs_grid_set(&side->shot, x, y);
+
+    uint8_t ship = side->ship[cell];
+    if(ship == GRID_NONE) return HIT_BLANK;
+    if(--side->left[ship] > 0) return ship + 1;
+
+    side->sunk |= 1u << ship;
+    return (ship + 1) | HIT_SUNK;
+}
+
+/// @brief Gets the cells a ship is on
+/// @param side The side
+/// @param ship The ship
+/// @param cells Where they go
+void bs_grid_ship(const grid_side_t* side, uint8_t ship, grid_bits_t* cells) {
+    const grid_rules_t* rules = side->rules;
+    memset(cells, 0, sizeof(grid_bits_t));
+
+    uint8_t x = side->start[ship] % rules->width;
+    uint8_t y = side->start[ship] / rules->width;
+    uint8_t length = rules->lengths[ship];
+
+    if(side->rotation[ship]) cells->rows[y] = bs_grid_run(x, length);
+    else for(uint8_t i = 0; i < length; i++) bs_grid_set(cells, x, y + i);
+}
+
+/// @brief Initialise the bot for a game
+/// @param bot The bot
+/// @param rules The rules (kept, so they have to stay around)
+void bs_grid_bot_init(grid_bot_t* bot, const grid_rules_t* rules) {
+    memset(bot, 0, sizeof(grid_bot_t));
+    bot->rules = rules;
+    bot->afloat = (uint32_t)((1ULL << rules->count) - 1);
+}
+
+/// @brief Adds up every placement that fits along one line (a row, or a column)
+/// @param diff Each placement adds its weight where it starts, and takes it away again just after it ends
+static inline void bs_grid_line(uint64_t* diff, uint32_t blocked, uint32_t hits, uint8_t size, uint8_t length, uint64_t count) {
+    uint32_t run = bs_grid_run(0, length);
+    for(uint8_t i = 0; i + length <= size; i++, run <<= 1) {
+        if(blocked & run) continue;
+
+        // Unsigned, so taking it away wraps around, but it all adds back up
+        uint64_t weight = bs_grid_weight((uint8_t)bs_popcount64(hits & run), length) * count;
+        diff[i] += weight;
+        diff[i + length] -= weight;
+    }
+}
+
+/// @brief Counts every placement that fits and picks the cell with the most (like the density mode)
+/// @param bot The bot
+/// @return The cell, or `rules->cells` if there's nowhere left
+uint16_t bs_grid_bot_pick(grid_bot_t* bot) {
+    const grid_rules_t* rules = bot->rules;
+    uint64_t across[GRID_MAX][GRID_MAX + 1];
+    uint64_t down[GRID_MAX][GRID_MAX + 1];
+    memset(across, 0, sizeof(across));
+    memset(down, 0, sizeof(down));
+
+    // Ships the same length have the same placements, so they're counted together
+    uint8_t lengths[GRID_MAX + 1] = { 0 };
+    for(uint8_t s = 0; s < rules->count; s++) {
+        if(bot->afloat & (1u << s)) lengths[rules->lengths[s]]++;
+    }
+
+    for(uint8_t length = 1; length <= GRID_MAX; length++) {
+        if(lengths[length] == 0) continue;
+
+        for(uint8_t y = 0; y < rules->height; y++) {
+            bs_grid_line(across[y], bot->blocked[0].rows[y], bot->hits[0].rows[y], rules->width, length, lengths[length]);
+        }
+
+        // A ship that's one long is the same either way round
+        if(length == 1) continue;
+        for(uint8_t x = 0; x < rules->width; x++) {
+            bs_grid_line(down[x], bot->blocked[1].rows[x], bot->hits[1].rows[x], rules->height, length, lengths[length]);
+        }
+    }
+
+    // Running sums turn the starts and ends into counts, across then down
+    for(uint8_t y = 0; y < rules->height; y++) {
+        uint64_t sum = 0;
+        for(uint8_t x = 0; x < rules->width; x++) {
+            sum += across[y][x];
+            bot->counts[bs_grid_index(rules, x, y)] = sum;
+        }
+    }
+
+    uint16_t best = rules->cells;
+    uint64_t most = 0;
+    for(uint8_t x = 0; x < rules->width; x++) {
+        uint64_t sum = 0;
+        for(uint8_t y = 0; y < rules->height; y++) {
+            sum += down[x][y];
+            uint16_t cell = bs_grid_index(rules, x, y);
+            bot->counts[cell] += sum;
+
+            if(bs_grid_test(&bot->shot, x, y)) continue;
+            if(best == rules->cells || bot->counts[cell] > most || (bot->counts[cell] == most && cell < best)) {
+                best = cell;
+                most = bot->counts[cell];
+            }
+        }
+    }
+
+    return best;
+}
+
+/// @brief Updates the bot after one of its shots
+/// @param bot The bot
+/// @param cell The cell it shot at
+/// @param result The result from `bs_grid_fire`
+/// @param sunk The cells of the ship that was sunk (only used if `result` has `HIT_SUNK`)
+void bs_grid_bot_observe(grid_bot_t* bot, uint16_t cell, uint8_t result, const grid_bits_t* sunk) {
+    if(result == PLACE_HIT_INVALID) return;
+
+    const grid_rules_t* rules = bot->rules;
+    uint8_t x = cell % rules->width;
+    uint8_t y = cell / rules->width;
+    bs_grid_set(&bot->shot, x, y);
+
+    if(result == HIT_BLANK) {
+        bs_grid_set(&bot->blocked[0], x, y);
+        bs_grid_set(&bot->blocked[1], y, x);
+        return;
+    }
+
+    bs_grid_set(&bot->hits[0], x, y);
+    bs_grid_set(&bot->hits[1], y, x);
+    if(!(result & HIT_SUNK)) return;
+
+    // The ship's gone, so its cells stop counting as hits and nothing else can be there
+    bot->afloat &= ~(1u << ((result & ~HIT_SUNK) - 1));
+    for(uint8_t row = 0; row < rules->height; row++) {
+        uint32_t bits = sunk->rows[row];
+        bot->blocked[0].rows[row] |= bits;
+        bot->hits[0].rows[row] &= ~bits;
+
+        while(bits != 0) {
+            uint8_t col = (uint8_t)bs_ctz64(bits);
+            bits &= bits - 1;
+            bot->blocked[1].rows[col] |= 1u << row;
+            bot->hits[1].rows[col] &= ~(1u << row);
+        }
+    }
+}
@@ -0,0 +1,97 @@
+/*
+    BSBOT made by William Dawson (MrBisquit on GitHub)
+    https://wtdawson.info
+
+    --------------------------------------------------------------------------------------------
+
+    Boards of any size
+
+    Everything else is built around the standard game (10x10, ships of 5, 4, 3, 3 and 2), with
+    the board in a `bb_t` and the placements worked out ahead of time. This is the slower, more
+    general version of the same thing, for finding out how the bot scales: any board up to
+    32x32, and any fleet of up to 16 ships up to 32 long.
+
+    A board is a row of bits per line (`grid_bits_t`), so checking a ship across a row is one
+    AND. The bot is the density mode (see density.h) worked out again every turn, using
+    running sums along each row and column so it's a couple of additions a placement rather
+    than one per cell.
+
+    The standard game doesn't go through here, it stays on the fixed-size code.
+
+    --------------------------------------------------------------------------------------------
+
+ *  License:    SPDX-License-Identifier: MIT
+ *              See LICENSE file in the project root for full license text.
+*/
+
+#ifndef BSBOT_GRID_H
+#define BSBOT_GRID_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include "game.h"
+#include "rng.h"
+
+#define GRID_MAX        32  // Widest or tallest a board can be (a row has to fit in a uint32_t)
+#define GRID_MAX_CELLS  (GRID_MAX * GRID_MAX)
+#define GRID_MAX_SHIPS  16
+#define GRID_HIT_MAX    8   // Placements covering more hits than this don't count for any more
+#define GRID_NONE       0xFF
+#define GRID_MAX_TRIES  4096 // Fleets to try before giving up (only if they hardly fit)
+
+/// @brief One bit per cell, bit `x` of `rows[y]`
+typedef struct {
+    uint32_t rows[GRID_MAX];
+} grid_bits_t;
+
+typedef struct {
+    uint8_t width;
+    uint8_t height;
+    uint8_t count;                      // Ships in the fleet
+    uint8_t lengths[GRID_MAX_SHIPS];
+    uint16_t cells;                     // width * height
+} grid_rules_t;
+
+typedef struct {
+    const grid_rules_t* rules;
+    grid_bits_t occupied;
+    grid_bits_t shot;
+    uint16_t start[GRID_MAX_SHIPS];     // Each ship's first cell
+    uint8_t rotation[GRID_MAX_SHIPS];   // 0 = down, 1 = across (same as everywhere else)
+    uint8_t left[GRID_MAX_SHIPS];       // Cells of it that haven't been hit
+    uint8_t ship[GRID_MAX_CELLS];       // Which ship is on each cell (GRID_NONE = none)
+    uint32_t sunk;                      // 1 << ship for each one that's sunk
+} grid_side_t;
+
+typedef struct {
+    const grid_rules_t* rules;
+    grid_bits_t blocked[2];             // Misses and sunk ships, nothing afloat can be there ([0] by row, [1] by column)
+    grid_bits_t hits[2];                // Hits on ships that are still afloat (the same way round)
+    grid_bits_t shot;
+    uint32_t afloat;                    // 1 << ship for each one that isn't sunk
+    uint64_t counts[GRID_MAX_CELLS];    // Weighted placements on each cell (from the last `bs_grid_bot_pick`)
+} grid_bot_t;
+
+/// @brief Gets a cell's index
+static inline uint16_t bs_grid_index(const grid_rules_t* rules, uint8_t x, uint8_t y) {
+    return (uint16_t)(y * rules->width + x);
+}
+
+/// @brief Gets whether the rules are the standard game's (which should use the fixed-size code instead)
+static inline bool bs_grid_is_standard(const grid_rules_t* rules) {
+    static const uint8_t lengths[FLEET_SIZE] = { 5, 4, 3, 3, 2 };
+    return rules->width == BB_SIZE && rules->height == BB_SIZE && rules->count == FLEET_SIZE &&
+        memcmp(rules->lengths, lengths, FLEET_SIZE) == 0;
+}
+
+bool bs_grid_rules(grid_rules_t* rules, uint8_t width, uint8_t height, const uint8_t* lengths, uint8_t count);
+bool bs_grid_random_fleet(grid_side_t* side, const grid_rules_t* rules, rng_t* rng);
+uint8_t bs_grid_fire(grid_side_t* side, uint16_t cell);
+void bs_grid_ship(const grid_side_t* side, uint8_t ship, grid_bits_t* cells);
+
+void bs_grid_bot_init(grid_bot_t* bot, const grid_rules_t* rules);
+uint16_t bs_grid_bot_pick(grid_bot_t* bot);
+void bs_grid_bot_observe(grid_bot_t* bot, uint16_t cell, uint8_t result, const grid_bits_t* sunk);
+
+#endif
@@ -0,0 +1,38 @@
+/*
+    BSBOT made by William Dawson (MrBisquit on GitHub)
+    https://wtdawson.info
+
+    --------------------------------------------------------------------------------------------
+
+    Knowledge
+
+    What one player knows about the other's side of the board. This is everything the bot is
+    allowed to use to work out where the ships are, so the probability engines all take this
+    rather than a `board_t` (which would let them cheat).
+
+    --------------------------------------------------------------------------------------------
+
+ *  License:    SPDX-License-Identifier: MIT
+ *              See LICENSE file in the project root for full license text.
+*/
+
+#ifndef BSBOT_KNOWLEDGE_H
+#define BSBOT_KNOWLEDGE_H
+
+#include <stdint.h>
+#include "bitboard.h"
+
+#define FLEET_SIZE  5
+#define FLEET_ALL   0x1F // Every ship is afloat
+
+/// @brief How many places each ship takes up (index is PLACE_x - 1)
+static const uint8_t bs_fleet_lengths[FLEET_SIZE] = { 5, 4, 3, 3, 2 };
+
+typedef struct {
+    bb_t hits;      // Hits on ships that haven't been sunk yet
+    bb_t misses;    // Shots that missed
+    bb_t sunk;      // Every cell of every ship that has been sunk
+    uint8_t afloat; // Ships that haven't been sunk (1 << (PLACE_x - 1))
+} knowledge_t;
+
+#endif
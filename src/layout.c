@@ -0,0 +1,63 @@
+/*
+    BSBOT made by William Dawson (MrBisquit on GitHub)
+    https://wtdawson.info
+
+    --------------------------------------------------------------------------------------------
+
+    Board layout (See layout.h)
+
+    --------------------------------------------------------------------------------------------
+
+ *  License:    SPDX-License-Identifier: MIT
+ *              See LICENSE file in the project root for full license text.
+*/
+
+#include <math.h>
+#include "layout.h"
+
+/// @brief Gets the cell a point's on
+/// @param l The layout
+/// @param point The point (on the screen)
+/// @return The cell, or `LAYOUT_OUTSIDE` if it's off the board, on the labels or in a gap
+uint8_t bs_layout_cell_at(const layout_t* l, Vector2 point) {
+    float fx = floorf((point.x - l->x) / l->pitch);
+    float fy = floorf((point.y - l->y) / l->pitch);
+    if(fx < 1.0f || fy < 1.0f || fx > BB_SIZE || fy > BB_SIZE) return LAYOUT_OUTSIDE; // Column and row 0 are the labels
+
+    // The far edge counts as part of the cell, anything after it is the gap
+    if(point.x - l->x - (fx * l->pitch) > l->cell) return LAYOUT_OUTSIDE;
+    if(point.y - l->y - (fy * l->pitch) > l->cell) return LAYOUT_OUTSIDE;
+
+    return bs_bb_index((uint8_t)fx - 1, (uint8_t)fy - 1);
+}
+
+/// @brief Works out the first and last cell a span touches, along one side of the board
+/// @return Returns `false` if it doesn't touch any
+static bool bs_layout_span(float start, float end, float origin, float cell, float pitch, uint8_t* first, uint8_t* last) {
+    // Cell i (from 0) covers origin + pitch * (i + 1) to that plus `cell`, edges included
+    float low = ceilf((start - origin - cell) / pitch) - 1.0f;
+    float high = floorf((end - origin) / pitch) - 1.0f;
+    if(low < 0.0f) low = 0.0f;
+    if(high > BB_SIZE - 1) high = BB_SIZE - 1;
+    if(low > high) return false;
+
+    *first = (uint8_t)low;
+    *last = (uint8_t)high;
+    return true;
+}
+
+/// @brief Gets every cell a rectangle touches (even if it's only an edge)
+/// @param l The layout
+/// @param rect The rectangle (on the screen)
+/// @return The cells
+bb_t bs_layout_cells_in(const layout_t* l, Rectangle rect) {
+    uint8_t x0, x1, y0, y1;
+    if(!bs_layout_span(rect.x, rect.x + rect.width, l->x, l->cell, l->pitch, &x0, &x1)) return bs_bb_empty();
+    if(!bs_layout_span(rect.y, rect.y + rect.height, l->y, l->cell, l->pitch, &y0, &y1)) return bs_bb_empty();
+
+    // The same run of cells on every row it covers
+    bb_t run = { .lo = ((1ULL << (x1 - x0 + 1)) - 1) << x0, .hi = 0 };
+    bb_t cells = bs_bb_empty();
+    for(uint8_t y = y0; y <= y1; y++) cells = bs_bb_or(cells, bs_bb_shl(run, y * BB_SIZE));
+    return cells;
+}
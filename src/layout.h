@@ -0,0 +1,75 @@
+/*
+    BSBOT made by William Dawson (MrBisquit on GitHub)
+    https://wtdawson.info
+
+    --------------------------------------------------------------------------------------------
+
+    Board layout
+
+    Where everything on a board goes on the screen: the first row and column are the labels,
+    then it's 10x10 cells, 32 pixels each with a 1 pixel gap between them (all times the
+    scale). Drawing and the mouse both go through here, so they can't disagree.
+
+    The cells are evenly spaced, so which cell a point is in (or which cells a rectangle
+    touches) is just a division each way rather than checking every cell. Cells count as
+    including their edges, so a rectangle that only just touches one still counts, and a
+    point in a gap between cells (or off the board) is `LAYOUT_OUTSIDE`.
+
+    --------------------------------------------------------------------------------------------
+
+ *  License:    SPDX-License-Identifier: MIT
+ *              See LICENSE file in the project root for full license text.
+*/
+
+#ifndef BSBOT_LAYOUT_H
+#define BSBOT_LAYOUT_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "bitboard.h"
+#include "game.h"
+
+#define LAYOUT_CELL     32          // Pixels across a cell (at a scale of 1)
+#define LAYOUT_GAP      1           // Pixels between cells
+#define LAYOUT_OUTSIDE  BB_CELLS    // Not on any cell
+
+typedef struct {
+    float x;        // Top-left of the board (where the labels start)
+    float y;
+    float cell;     // Pixels across a cell
+    float pitch;    // From one cell to the next (a cell and a gap)
+} layout_t;
+
+/// @brief Lays a board out
+/// @param x Top-left X coordinate (the labels are in the first column)
+/// @param y Top-left Y coordinate (the labels are in the first row)
+/// @param scale How big it is (1 = 32 pixel cells)
+static inline layout_t bs_layout(float x, float y, float scale) {
+    return (layout_t){ .x = x, .y = y, .cell = LAYOUT_CELL * scale, .pitch = (LAYOUT_CELL + LAYOUT_GAP) * scale };
+}
+
+/// @brief Gets where a cell is drawn
+static inline Rectangle bs_layout_cell_rect(const layout_t* l, uint8_t cell) {
+    return (Rectangle){
+        .x = l->x + (l->pitch * ((cell % BB_SIZE) + 1)), // +1 to skip the labels
+        .y = l->y + (l->pitch * ((cell / BB_SIZE) + 1)),
+        .width = l->cell,
+        .height = l->cell
+    };
+}
+
+/// @brief Gets where the label for a column (`BB_SIZE + row` for a row) is drawn
+static inline Rectangle bs_layout_label_rect(const layout_t* l, uint8_t label) {
+    float along = l->pitch * ((label % BB_SIZE) + 1);
+    return (Rectangle){
+        .x = label < BB_SIZE ? l->x + along : l->x,
+        .y = label < BB_SIZE ? l->y : l->y + along,
+        .width = l->cell,
+        .height = l->cell
+    };
+}
+
+uint8_t bs_layout_cell_at(const layout_t* l, Vector2 point);
+bb_t bs_layout_cells_in(const layout_t* l, Rectangle rect);
+
+#endif
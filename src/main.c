@@ -14,8 +14,12 @@
     *   stdio.h
     *   stdint.h
     *   stdlib.h
-    *   time.h      This is used for the seed in the random algorithm
     *   raylib.h
+    *   rlgl.h      (Comes with raylib) Rectangles are drawn in batches, see quads.c
+    *   pthread.h   (windows.h on Windows) The bot thinks on every core
+
+    The game logic and the bot live in game.c (without raylib), and each game is a session
+    (session.c), this file is the graphics.
 
     This uses Raylib, which is defined below.
 
@@ -57,9 +61,18 @@
 #include <stdio.h>
 #include <stdint.h>
 #include <stdlib.h>
-#include <time.h>
 #include <raylib.h>
 
+#include "game.h"
+#include "enumerate.h"
+#include "session.h"
+#include "replay.h"
+#include "prior.h"
+#include "defense.h"
+#include "thinker.h"
+#include "layout.h"
+#include "quads.h"
+
 /*
     Below is the actual game, and the main functionality.
 */
@@ -68,57 +81,6 @@
     Pre-definitions
 */
 
-#define PLACE_BLANK 0
-#define PLACE_AC    1 // Aircraft carrier
-#define PLACE_BS    2 // Battleship
-#define PLACE_DS    3 // Destroyer
-#define PLACE_SB    4 // Submarine
-#define PLACE_PB    5 // Patrol Boat
-#define HIT_BLANK   0
-#define HIT_AC      1 // Aircraft carrier
-#define HIT_BS      2 // Battleship
-#define HIT_DS      3 // Destroyer
-#define HIT_SB      4 // Submarine
-#define HIT_PB      5 // Patrol Boat
-
-#define PLACE_HIT_INVALID 0xFF
-
-typedef struct {
-    float possibilities[10][10];
-} bot_t;
-
-/// @brief This is either an aircraft carrier, battleship, destroyer, submarine, or patrol boat
-typedef struct {
-    uint8_t type;
-    uint8_t rotation; // 0 = Horizontal, 1 = Vertical
-    uint8_t places; // How many places it takes up (horizontally or vertically)
-
-    // These are defined for easily working things out during rendering
-    Vector2 size_normal;
-    Vector2 size_hovering;
-
-    // Position (This can be ignored unless used in rendering)
-    Vector2 pos;
-    Vector2 relative_pos;
-} item_t;
-
-typedef struct {
-    uint8_t a_places[10][10];
-    uint8_t b_places[10][10];
-
-    uint8_t a_hitmap[10][10];
-    uint8_t b_hitmap[10][10];
-
-    item_t a_items[5];
-    item_t b_items[5];
-} board_t;
-
-/// @brief Return value for a grid check
-typedef struct {
-    uint8_t grid[10][10];
-    uint8_t total;
-} grid_check_return_t;
-
 typedef enum {
     GAME_STATE_MENU,
     GAME_STATE_SELECTION,
@@ -126,38 +88,51 @@ typedef enum {
     GAME_STATE_END
 } game_state_t;
 
+/// @brief A board that's been drawn into a texture, and what was on it when it was (see `bs_render_board_cached`)
+typedef struct {
+    RenderTexture2D texture;    // The size of the window
+    bool valid;                 // `false` = draw all of it again
+    layout_t layout;
+    bb_t selection;
+    bb_t hits;
+    bb_t misses;
+    bool has_items;
+    item_t items[5];
+} board_cache_t;
+
+/// @brief How fast the window's being drawn (see `bs_pace`)
+typedef struct {
+    double last_active;         // When something last happened (`GetTime`)
+    bool idle;                  // `true` = only drawing when there's an event
+} pace_t;
+
+/// @brief What the thinker's doing for the window, besides the bot's moves (see `bs_jobs`)
+typedef enum {
+    JOB_NONE,
+    JOB_PLACE,                  // Placing the bot's ships for a new game
+    JOB_LEARN                   // Topping up the prior with the last game
+} job_t;
+
+#define PACE_LINGER     0.5     // Seconds it keeps going at full speed after the last thing that happened
+#define PACE_FALLBACK   60      // Frames a second if the monitor's refresh rate can't be found
+
 typedef enum {
     BS_RENDER_FLAG_SELECTION,
     BS_RENDER_FLAG_DESTRUCTION,
     BS_RENDER_FLAG_WIN
 } game_render_flag_t;
 
-typedef enum {
-    BS_Aircraft_Carrier,
-    BS_Battleship,
-    BS_Destroyer,
-    BS_Submarine,
-    BS_Patrol_Boat
-} game_item_t;
-
-// Utils
-board_t bs_new_board(void);
-void bs_new_board_ptr(board_t* ptr); // Usually just used to clear the board
-const char* bs_coords_to_string(Vector2 coords);
-int bs_rand(int from, int to);
-grid_check_return_t bs_grid_check(Rectangle rect, uint32_t offset_x, uint32_t offset_y);
-item_t bs_get_item(game_item_t type);
-bool bs_rect_overlap(Rectangle a, Rectangle b);
-bool bs_point_in_rect(Vector2 point, Rectangle rect);
-bool bs_add_item(item_t array[5], item_t item);
-bool bs_check_add_item(uint8_t grid[10][10], item_t item);
-Vector2 bs_get_grid_pos(int32_t offset_x, int32_t offset_y, Vector2 pos);
-
 // Graphics
 void bs_render_base_menu(void);
 void bs_render_board(board_t* ptr, game_render_flag_t flag);
-void bs_render_board_base(int32_t offset_x, int32_t offset_y);
-void bs_render_board_selection(uint32_t offset_x, uint32_t offset_y, uint8_t selection[10][10]);
+layout_t bs_board_layout(uint8_t board);
+void bs_render_board_base(const layout_t* layout);
+void bs_render_board_cached(board_cache_t* cache, const layout_t* layout, bb_t selection, const side_t* side, const item_t items[5]);
+void bs_render_cell(const layout_t* layout, uint8_t cell, bool selected);
+void bs_render_board_selection(const layout_t* layout, bb_t selection);
+void bs_render_shots(const layout_t* layout, const side_t* side);
+void bs_render_shot(const layout_t* layout, const side_t* side, uint8_t cell);
+void bs_render_placed(const item_t items[5]);
 // The "r" variable in these mean either (0) placed, or (1) hovering (selection)
 void bs_render_ac(int32_t offset_x, int32_t offset_y, uint8_t r, uint8_t rot);  // Aicraft carrier
 void bs_render_bs(int32_t offset_x, int32_t offset_y, uint8_t r, uint8_t rot);  // Battleship
@@ -170,14 +145,24 @@ void bs_render_btn(Rectangle rect, Color normal, Color hover, Color clicked);
 // Functionality
 void bs_menu(void);
 void bs_selection(void);
+void bs_destruction(void);
+void bs_end(void);
+void bs_new_game(uint64_t seed);
+bool bs_update(void);
+
+// Jobs (on the thinker)
+bool bs_jobs(bool wait);
+void bs_place_job(void* arg);
+void bs_learn_job(void* arg);
+
+// Frame pacing
+bool bs_pace_input(void);
+void bs_pace(pace_t* pace, bool active);
 
 // Debug
 void bs_debug_render(void);
 void bs_debug_enable(bool enable);
 
-// Bot
-void bs_bot_init(bot_t* ptr);
-
 // Colours
 #define SEABLUE     CLITERAL(Color){ 0, 105, 148, 255 }
 #define UNSELECTED  CLITERAL(Color){ 80, 80, 80, 128 }
@@ -186,11 +171,25 @@ void bs_bot_init(bot_t* ptr);
 
 // Game definitions
 game_state_t bs_state = GAME_STATE_MENU;
-board_t* bs_game_board;
-bot_t* bs_bot;
+session_pool_t bs_sessions; // Room for 2, so a new game can take the old one's settings
+session_t* bs_session = NULL;
+pool_t bs_pool;
+cache_t bs_cache;
+book_t bs_book;
+replay_writer_t bs_record; // Every finished game goes in here with --record FILE
+bool bs_recording = false;
+prior_t bs_prior; // What the bot's learned about where players put their ships (see prior.h)
+thinker_t bs_thinker; // The bot thinks on here, so the window never waits for it
+job_t bs_job = JOB_NONE; // What it's doing for the window otherwise (one thing at a time)
+bool bs_placing = false; // The new game's bot ships still need placing, once it's free
+uint64_t bs_place_seed;
+defense_result_t bs_placed;
+bool bs_placed_ok;
+replay_game_t bs_learning; // The game being learnt from (a copy, the session's gone by the time it's done)
+board_cache_t bs_board_caches[2]; // Your board on the left, the bot's on the right
+quads_t bs_quads; // Rectangles waiting to be drawn in one go (see quads.h)
 
 bool debug = false;
-bool randomness = true;
 
 /// @brief The main function
 /// @param argc Args count
@@ -198,21 +197,48 @@ bool randomness = true;
 /// @return Return code (0 = Success, anything else = issue/error - e.g. 1)
 int main(int argc, char* argv[]) {
     InitWindow(800, 450, "BSBOT (Battleship Bot)");
-    SetTargetFPS(20); // Doesn't need to be anything good
     SetWindowMinSize(800, 450);
 
-    bs_game_board = malloc(sizeof(board_t));
-    bs_bot = malloc(sizeof(bot_t));
-
-    bs_new_board_ptr(bs_game_board);
-    bs_bot_init(bs_bot);
-
-    srand(time(0));
+    // Pass --seed N to play the same way every time, otherwise it's different each run
+    uint64_t seed = bs_time_ns();
+    const char* record_path = NULL;
+    uint64_t lookahead_ms = 0; // --lookahead MS has the bot look ahead for that long each move
+    for(int i = 1; i + 1 < argc; i++) {
+        if(strcmp(argv[i], "--seed") == 0) seed = strtoull(argv[++i], NULL, 10);
+        else if(strcmp(argv[i], "--record") == 0) record_path = argv[++i];
+        else if(strcmp(argv[i], "--lookahead") == 0) lookahead_ms = strtoull(argv[++i], NULL, 10);
+    }
+    if(record_path != NULL) bs_recording = bs_replay_create(&bs_record, record_path, seed);
+
+    if(!bs_session_pool_init(&bs_sessions, 2)) return 1;
+    bs_prior_open(&bs_prior, "bsbot.prior"); // Optional, it's made after the first game
+
+    // Every core helps the bot think (and place its ships, so this has to be before the first game)
+    bs_enum_init();
+    bs_pool_init(&bs_pool, 0);
+    bs_thinker_init(&bs_thinker);
+    bs_new_game(seed);
+    bs_session->bot.pool = &bs_pool;
+    if(bs_cache_init(&bs_cache, 4 << 20)) bs_session->bot.cache = &bs_cache; // 4MB of positions it's already worked out
+    if(bs_book_open(&bs_book, "opening.book")) bs_session->bot.book = &bs_book; // Optional, see bsbot_book
+    if(lookahead_ms > 0) {
+        bs_session->bot.mode = BOT_MODE_LOOKAHEAD;
+        bs_session->bot.search.max_time_ns = lookahead_ms * 1000000;
+        bs_session->bot.search.max_depth = SEARCH_MAX_DEPTH; // As deep as the time allows
+    }
 
     // Load textures
     // LoadImageFromMemory()
 
+    // It starts at full speed (the first `bs_pace` sets the frame rate)
+    pace_t pace = { .last_active = GetTime(), .idle = true };
+
     while(!WindowShouldClose()) {
+        // The game moves on whether or not anything's being drawn, then it's drawn as fast as the
+        // screen goes while anything's happening, and only when there's an event once it's not
+        bool active = bs_update();
+        bs_pace(&pace, active || bs_pace_input());
+
         BeginDrawing();
         ClearBackground(BLACK);
 
@@ -232,11 +258,16 @@ int main(int argc, char* argv[]) {
                 bs_menu();
                 break;
             case GAME_STATE_SELECTION:
-                bs_render_board(bs_game_board, BS_RENDER_FLAG_SELECTION);
+                bs_render_board(&bs_session->board, BS_RENDER_FLAG_SELECTION);
                 bs_selection();
                 break;
             case GAME_STATE_DESTRUCTION:
-
+                bs_render_board(&bs_session->board, BS_RENDER_FLAG_DESTRUCTION);
+                bs_destruction();
+                break;
+            case GAME_STATE_END:
+                bs_render_board(&bs_session->board, BS_RENDER_FLAG_DESTRUCTION);
+                bs_end();
                 break;
         }
 
@@ -258,9 +289,22 @@ int main(int argc, char* argv[]) {
 
         if(debug) bs_debug_render();
 
+        bs_quads_flush(&bs_quads); // Anything that's still waiting
         EndDrawing();
     }
 
+    bs_thinker_destroy(&bs_thinker); // Before anything it could be using goes
+    bs_session_close(&bs_sessions, bs_session);
+    bs_session_pool_destroy(&bs_sessions);
+    if(bs_recording) bs_replay_finish(&bs_record);
+    bs_pool_destroy(&bs_pool);
+    bs_cache_destroy(&bs_cache);
+    bs_book_close(&bs_book);
+    bs_prior_close(&bs_prior);
+    for(uint8_t i = 0; i < 2; i++) {
+        if(bs_board_caches[i].texture.id != 0) UnloadRenderTexture(bs_board_caches[i].texture);
+    }
+
     CloseWindow();
     return 0;
 }
@@ -269,263 +313,6 @@ int main(int argc, char* argv[]) {
     Function declarations
 */
 
-// Utils
-/// @brief Generates a new board
-/// @return The new board
-board_t bs_new_board(void) {
-    board_t b;
-    for(uint8_t x = 0; x < 10; x++) {
-        for(uint8_t y = 0; y < 10; y++) {
-            b.a_places[x][y] = PLACE_BLANK;
-            b.b_places[x][y] = PLACE_BLANK;
-            b.a_hitmap[x][y] = HIT_BLANK;
-            b.b_hitmap[x][y] = HIT_BLANK;
-        }
-    }
-
-    for(uint8_t i = 0; i < 5; i++) {
-        b.a_items[i].type = PLACE_HIT_INVALID;
-        b.b_items[i].type = PLACE_HIT_INVALID;
-    }
-
-    return b;
-}
-/// @brief Generates a new board (Or clears an existing one)
-/// @param ptr The pointer to the board
-void bs_new_board_ptr(board_t* ptr) {
-    board_t b = bs_new_board();
-    memcpy(ptr, &b, sizeof(board_t));
-}
-
-/// @brief Converts Vector2 coodinates to a string (E.g. A1)
-/// @param coords Vector2 coordinates
-/// @return The string (3 characters)
-const char* bs_coords_to_string(Vector2 coords) {
-    char* str = malloc(sizeof(char) * 3);
-    if(coords.x == 10) {
-        const char* text = (char[]){ 'A' + coords.y, '1', '0' };
-        strcpy(str, text);
-    } else {
-        const char* text = (char[]){ 'A' + coords.y, '1' + coords.x + 1, ' ' };
-        strcpy(str, text);
-    }
-    return str;
-}
-
-/// @brief Generates a random number between 2 numbers
-/// @param from From
-/// @param to To
-/// @return A number between the 2 numbers provided
-int bs_rand(int from, int to) {
-    return (rand() % to) + from;
-}
-
-/// @brief Checks which squares in the grid the rectangle is in
-/// @param rect The rectangle
-/// @param offset_x X offset (Top-left X coordinate)
-/// @param offset_y Y offset (Top-left Y coordinate)
-/// @return The squares in the grid that the rectangle is in
-grid_check_return_t bs_grid_check(Rectangle rect, uint32_t offset_x, uint32_t offset_y) {
-    grid_check_return_t grid;
-    memset(&grid, 0, sizeof(grid_check_return_t));
-
-    for(uint8_t y = 0; y < 10; y++) {
-        for(uint8_t x = 0; x < 10; x++) {
-            Rectangle a = {
-                .x = offset_x + 33 + (33 * x),
-                .y = offset_y + 33 + (33 * y),
-                .width = 32,
-                .height = 32
-            };
-
-            if(bs_rect_overlap(a, rect)) {
-                grid.grid[x][y] = true;
-                grid.total++;
-                //DrawRectangle(a.x, a.y, a.width, a.height, GREEN);
-            } else if(bs_point_in_rect((Vector2) { .x = rect.x, .y = rect.y }, a)) {
-                grid.grid[x][y] = true;
-                grid.total++;
-                //DrawRectangle(a.x, a.y, a.width, a.height, GREEN);
-            }
-        }
-    }
-
-    //DrawRectangle(rect.x, rect.y, rect.width + 5, rect.height + 5, BLUE);
-
-    return grid;
-}
-
-/// @brief Gets an item
-/// @param type The type of item
-/// @return The item
-item_t bs_get_item(game_item_t type) {
-    item_t item;
-
-    switch(type) {
-        case BS_Aircraft_Carrier:
-            item.type = PLACE_AC;
-            item.places = 5;
-            item.rotation = 0;
-            item.size_normal = (Vector2){ .x = 32 / 2, .y = (32 * 5) - (32 / 2) };
-            item.size_hovering = (Vector2){ .x = 10, .y = 135 };
-            break;
-        case BS_Battleship:
-            item.type = PLACE_BS;
-            item.places = 4;
-            item.rotation = 0;
-            item.size_normal = (Vector2){ .x = 32 / 2, .y = (32 * 4) - (32 / 2) };
-            item.size_hovering = (Vector2){ .x = 10, .y = 100 };
-            break;
-        case BS_Destroyer:
-            item.type = PLACE_DS;
-            item.places = 3;
-            item.rotation = 0;
-            item.size_normal = (Vector2){ .x = 32 / 2, .y = (32 * 3) - (32 / 2) };
-            item.size_hovering = (Vector2){ .x = 10, .y = 65 };
-            break;
-        case BS_Submarine:
-            item.type = PLACE_SB;
-            item.places = 3;
-            item.rotation = 0;
-            item.size_normal = (Vector2){ .x = 32 / 2, .y = (32 * 3) - (32 / 2) };
-            item.size_hovering = (Vector2){ .x = 10, .y = 65 };
-            break;
-        case BS_Patrol_Boat:
-            item.type = PLACE_PB;
-            item.places = 2;
-            item.rotation = 0;
-            item.size_normal = (Vector2){ .x = 32 / 2, .y = (32 * 2) - (32 / 2) };
-            item.size_hovering = (Vector2){ .x = 10, .y = 35 };
-            break;
-    }
-
-    return item;
-}
-
-/// @brief Check if 2 rectangles overlap
-/// @param a Rectangle A
-/// @param b Rectangle B
-/// @return If the 2 rectangles overlap
-bool bs_rect_overlap(Rectangle a, Rectangle b) {
-    float a_x1 = a.x;
-    float a_y1 = a.y;
-    float a_x2 = a.x + a.width;
-    float a_y2 = a.y + a.height;
-
-    float b_x1 = b.x;
-    float b_y1 = b.y;
-    float b_x2 = b.x + b.width;
-    float b_y2 = b.y + b.height;
-
-    /* This only selects the top and bottom squares
-    bool tl, tr, bl, br = false;
-    tl = bs_point_in_rect((Vector2){ .x = b_x1, .y = b_y1 }, a);
-    tr = bs_point_in_rect((Vector2){ .x = b_x2, .y = b_y1 }, a);
-    bl = bs_point_in_rect((Vector2){ .x = b_x1, .y = b_y2 }, a);
-    br = bs_point_in_rect((Vector2){ .x = b_x2, .y = b_y2 }, a);
-
-    if((tl && tr) || (tl && bl) || (bl && br) || (br && tr))
-        return true;
-    else
-        return false;*/
-
-    /*if(a_x1 < b_x2 && a_x2 > b_x1 && a_y1 > b_y2 && a_y2 < b_y1) {
-        return true;
-    } else {
-        return false;
-    }*/
-
-    if(a_x1 <= b_x2 && a_x2 >= b_x1 && a_y1 <= b_y2 && a_y2 >= b_y1) {
-        return true;
-    } else {
-        return false;
-    }
-
-    // indicates whether or not the specified rectangle intersects with this rectangle
-/*constexpr bool intersects(const rectx& rect) const {
-    return (left() <= rect.right() && right()>= rect.left() &&
-        top() <= rect.bottom() && bottom() >= rect.top() ); 
-}*/
-}
-
-/// @brief Check is a point is inside a rectangle
-/// @param point The point to check
-/// @param rect The rectangle
-/// @return If the point is inside the rectangle
-bool bs_point_in_rect(Vector2 point, Rectangle rect) {
-    float px = point.x;
-    float py = point.y;
-
-    float x1 = rect.x;
-    float y1 = rect.y;
-    float x2 = rect.x + rect.width;
-    float y2 = rect.y + rect.height;
-
-    if(px >= x1 && px <= x2 && py >= y1 && py <= y2) {
-        return true;
-    } else {
-        return false;
-    }
-}
-
-/// @brief Adds an item into the array (if it can fit)
-/// @param array The array
-/// @param item The item to add into the array
-/// @return Returns `true` if it could fit it into the array, `false` if not
-bool bs_add_item(item_t array[5], item_t item) {
-    for(uint8_t i = 0; i < 5; i++) {
-        if(array[i].type == PLACE_HIT_INVALID) {
-            memcpy(&array[i], &item, sizeof(item_t));
-
-            return true;
-        }
-    }
-
-    return false;
-}
-
-/// @brief Checks if the player can place something on the grid
-/// @param grid The grid
-/// @param item The item to check
-/// @return Returns `true` if it can fit on the grid, `false` if not
-bool bs_check_add_item(uint8_t grid[10][10], item_t item) {
-    if(item.rotation == 0) {
-        if(item.pos.y + item.places > 10) return false;
-    } else if(item.rotation == 1) {
-        if(item.pos.x + item.places > 10) return false;
-    }
-}
-
-/// @brief Gets the relative coordinates of a position on a grid from the provided position
-/// @param offset_x X offset (Top-left X coordinate)
-/// @param offset_y Y offset (Top-left Y coordinate)
-/// @param pos The position
-/// @return The relative grid coordinates to the provided position
-Vector2 bs_get_grid_pos(int32_t offset_x, int32_t offset_y, Vector2 pos) {
-    for(uint8_t y = 0; y < 10; y++) {
-        for(uint8_t x = 0; x < 10; x++) {
-            int32_t start_x = offset_x + ((x * 32) + (x * 1));
-            int32_t start_y = offset_y + ((y * 32) + (y * 1));
-            int32_t end_x = start_x + 32;
-            int32_t end_y = start_y + 32;
-
-            Rectangle rect = (Rectangle) {
-                .x = start_x,
-                .y = start_y,
-                .width = 32,
-                .height = 32
-            };
-
-            if(bs_point_in_rect(pos, rect)) {
-                return (Vector2) {
-                    .x = x,
-                    .y = y
-                };
-            }
-        }
-    }
-}
-
 // Graphics
 /// @brief Renders the main menu
 void bs_render_base_menu(void) {
@@ -546,8 +333,11 @@ void bs_render_board(board_t* ptr, game_render_flag_t flag) {
     int w = GetScreenWidth();
     int h = GetScreenHeight();
 
-    bs_render_board_base(20, 50);
-    if(flag == BS_RENDER_FLAG_DESTRUCTION) bs_render_board_base((w / 2) + 20, 50);
+    // Your ships and where the bot's shot on the left, where you've shot on the right
+    layout_t yours = bs_board_layout(0);
+    layout_t theirs = bs_board_layout(1);
+    bs_render_board_cached(&bs_board_caches[0], &yours, ptr->a.occupied, &ptr->a, ptr->a_items);
+    if(flag == BS_RENDER_FLAG_DESTRUCTION) bs_render_board_cached(&bs_board_caches[1], &theirs, bs_bb_empty(), &ptr->b, NULL);
     else {
         DrawText("Select below, then place on the board\non the left. Use your arrow keys, and\npress 'R' to rotate!", (w / 2) + 20, 50, 17, WHITE);
 
@@ -557,46 +347,141 @@ void bs_render_board(board_t* ptr, game_render_flag_t flag) {
     DrawLine(w / 2, 50, w / 2, h - 38, WHITE);
 }
 
+/// @brief Gets where a board goes on the screen (drawing it and clicking on it both go by this)
+/// @param board 0 = yours (on the left), 1 = the bot's (on the right)
+/// @return The layout
+layout_t bs_board_layout(uint8_t board) {
+    float x = board == 0 ? 20.0f : (float)((GetScreenWidth() / 2) + 20);
+    return bs_layout(x, 50.0f, 1.0f);
+}
+
 /// @brief Renders the base of a board
-/// @param offset_x X offset (Top-left X coordinate)
-/// @param offset_y Y offset (Top-left Y coordinate)
-void bs_render_board_base(int32_t offset_x, int32_t offset_y) {
-    DrawRectangle(offset_x + 32, offset_y + 32, 320 + 10, 320 + 10, SEABLUE);
-    for (uint8_t i = 0; i < 11; i++)
-    {
-        for(uint8_t j = 0; j < 11; j++) {
-            if(i == 0 && j != 0) {
-                const char* text = (char[]){ 'A' + j - 1, ' ', ' ', ' ', ' ' };
-                DrawText(text, offset_x + 12, offset_y + ((j * 32) + (j * 1)) + 10, 12, WHITE); // Letters
-                continue;
-            } else if(j == 0 && i != 0) {
-                if(i == 10) {
-                    DrawText("10", offset_x + ((i * 32) + (i * 1)) + 12, offset_y + 10, 12, WHITE); // Numbers
-                } else {
-                    const char* text = (char[]){ '1' + i - 1, ' ', ' ', ' ', ' ' };
-                    DrawText(text, offset_x + ((i * 32) + (i * 1)) + 12, offset_y + 10, 12, WHITE); // Numbers
-                }
-                continue;
-            }
-
-            DrawRectangle(offset_x + ((i * 32) + (i * 1)), offset_y + ((j * 32) + (j * 1)), 32, 32, UNSELECTED);
+/// @note Nothing it draws is see-through, so it can go in a texture (see `bs_render_board_cached`)
+/// @param layout Where the board is
+void bs_render_board_base(const layout_t* layout) {
+    bs_quads_add(&bs_quads, (Rectangle){ .x = layout->x + layout->cell, .y = layout->y + layout->cell, .width = layout->pitch * 10, .height = layout->pitch * 10 }, SEABLUE);
+
+    for(uint8_t i = 0; i < 10; i++) {
+        const char* letter = (char[]){ 'A' + i, '\0' };
+        const char* number = i == 9 ? "10" : (char[]){ '1' + i, '\0' };
+
+        Rectangle row = bs_layout_label_rect(layout, BB_SIZE + i);
+        Rectangle column = bs_layout_label_rect(layout, i);
+        DrawText(letter, row.x + 12, row.y + 10, 12, WHITE); // Letters
+        DrawText(number, column.x + 12, column.y + 10, 12, WHITE); // Numbers
+    }
+
+    for(uint8_t cell = 0; cell < BB_CELLS; cell++) bs_render_cell(layout, cell, false);
+}
+
+/// @brief Renders one cell of a board, empty or selected
+/// @note The colours are blended with the sea here rather than by the GPU, so it's the same on the
+///       screen, but it's solid in a texture (blending there would leave it half see-through)
+/// @param layout Where the board is
+/// @param cell The cell
+/// @param selected Whether it's selected
+void bs_render_cell(const layout_t* layout, uint8_t cell, bool selected) {
+    Color c = ColorAlphaBlend(SEABLUE, UNSELECTED, WHITE);
+    if(selected) c = ColorAlphaBlend(c, SELECTED, WHITE);
+    bs_quads_add(&bs_quads, bs_layout_cell_rect(layout, cell), c);
+}
+
+/// @brief Renders a board from a texture, only drawing into it again where something's changed
+/// @note It's all drawn again if the window's changed size, it's moved, or the ships have (they
+///       aren't lined up with the cells, so they could be over anything)
+/// @param cache The cache
+/// @param layout Where the board is
+/// @param selection The selected cells (where the ships are)
+/// @param side The side, for the shots fired at it
+/// @param items The placed ships (NULL = none)
+void bs_render_board_cached(board_cache_t* cache, const layout_t* layout, bb_t selection, const side_t* side, const item_t items[5]) {
+    int w = GetScreenWidth();
+    int h = GetScreenHeight();
+
+    if(cache->texture.id == 0 || cache->texture.texture.width != w || cache->texture.texture.height != h) {
+        if(cache->texture.id != 0) UnloadRenderTexture(cache->texture);
+        cache->texture = LoadRenderTexture(w, h);
+        cache->valid = false;
+    }
+
+    bool same_items = items == NULL ? !cache->has_items : (cache->has_items && memcmp(cache->items, items, sizeof(cache->items)) == 0);
+    bool moved = memcmp(&cache->layout, layout, sizeof(layout_t)) != 0;
+
+    BeginTextureMode(cache->texture);
+    if(!cache->valid || moved || !same_items) {
+        ClearBackground(BLANK);
+        bs_render_board_base(layout);
+
+        bb_t selected = selection;
+        while(!bs_bb_is_empty(selected)) bs_render_cell(layout, bs_bb_pop_lsb(&selected), true);
+        if(items != NULL) bs_render_placed(items);
+        bs_quads_flush(&bs_quads); // The shots go over all of that
+        bs_render_shots(layout, side);
+    } else {
+        // Just the cells that have changed, with anything that's over them drawn again on top
+        bb_t dirty = bs_bb_or(bs_bb_xor(selection, cache->selection), bs_bb_or(bs_bb_xor(side->hitmap, cache->hits), bs_bb_xor(side->missmap, cache->misses)));
+        while(!bs_bb_is_empty(dirty)) {
+            uint8_t cell = bs_bb_pop_lsb(&dirty);
+            Rectangle rect = bs_layout_cell_rect(layout, cell);
+
+            BeginScissorMode((int)rect.x, (int)rect.y, (int)rect.width, (int)rect.height);
+            bs_render_cell(layout, cell, bs_bb_test(selection, cell));
+            if(items != NULL) bs_render_placed(items);
+            bs_quads_flush(&bs_quads); // Before the shot, and while it's still cut to this cell
+            bs_render_shot(layout, side, cell);
+            EndScissorMode();
         }
     }
+    EndTextureMode();
+
+    cache->valid = true;
+    cache->layout = *layout;
+    cache->selection = selection;
+    cache->hits = side->hitmap;
+    cache->misses = side->missmap;
+    cache->has_items = items != NULL;
+    if(items != NULL) memcpy(cache->items, items, sizeof(cache->items));
+
+    // Textures are upside down, so it's flipped back
+    DrawTextureRec(cache->texture.texture, (Rectangle){ .x = 0, .y = 0, .width = (float)w, .height = (float)-h }, (Vector2){ .x = 0, .y = 0 }, WHITE);
 }
 
 /// @brief Renders a highlighted selection of the grid (for selection)
 /// @note This is designed to be layered on top of `bs_render_board_base`
-/// @param offset_x  X offset (Top-left X coordinate)
-/// @param offset_y Y offset (Top-left Y coordinate)
+/// @param layout Where the board is
 /// @param selection The selected grid
-void bs_render_board_selection(uint32_t offset_x, uint32_t offset_y, uint8_t selection[10][10]) {
-    for(uint8_t y = 0; y < 11; y++) {
-        for(uint8_t x = 0; x < 11; x++) {
-            if(y == 0 || x == 0) continue; // Skip
-
-            if(selection[y - 1][x - 1] == true) {
-                DrawRectangle(offset_x + ((y * 32) + (y * 1)), offset_y + ((x * 32) + (x * 1)), 32, 32, SELECTED);
-            }
+void bs_render_board_selection(const layout_t* layout, bb_t selection) {
+    // Only visit the selected cells instead of the whole grid
+    while(!bs_bb_is_empty(selection)) bs_quads_add(&bs_quads, bs_layout_cell_rect(layout, bs_bb_pop_lsb(&selection)), SELECTED);
+}
+
+/// @brief Renders the shots fired at a side (hits in red, misses in white)
+/// @note This is designed to be layered on top of `bs_render_board_base`
+/// @param layout Where the board is
+/// @param side The side that's been shot at
+void bs_render_shots(const layout_t* layout, const side_t* side) {
+    bb_t shots = bs_bb_or(side->hitmap, side->missmap);
+    while(!bs_bb_is_empty(shots)) bs_render_shot(layout, side, bs_bb_pop_lsb(&shots));
+}
+
+/// @brief Renders the shot fired at one cell, if there's been one
+/// @param layout Where the board is
+/// @param side The side that's been shot at
+/// @param cell The cell
+void bs_render_shot(const layout_t* layout, const side_t* side, uint8_t cell) {
+    if(!bs_bb_test(bs_bb_or(side->hitmap, side->missmap), cell)) return;
+
+    Rectangle rect = bs_layout_cell_rect(layout, cell);
+    Color c = bs_bb_test(side->hitmap, cell) ? RED : WHITE;
+    DrawCircle(rect.x + (rect.width / 2), rect.y + (rect.height / 2), rect.width / 4, c);
+}
+
+/// @brief Renders the ships that have been placed (where they were dropped)
+/// @param items The items
+void bs_render_placed(const item_t items[5]) {
+    for(uint8_t i = 0; i < 5; i++) {
+        if(items[i].type != PLACE_HIT_INVALID) {
+            bs_render_item(items[i].type, items[i].pos.x, items[i].pos.y, 0, items[i].rotation);
         }
     }
 }
@@ -612,16 +497,16 @@ void bs_render_ac(int32_t offset_x, int32_t offset_y, uint8_t r, uint8_t rot) {
         uint8_t width = item.size_normal.x;
         uint8_t height = item.size_normal.y;
         if(rot == 0)
-            DrawRectangle(offset_x, offset_y, width, height, RED);
+            bs_quads_add(&bs_quads, (Rectangle){ .x = offset_x, .y = offset_y, .width = width, .height = height }, RED);
         else
-            DrawRectangle(offset_x, offset_y, height, width, RED);
+            bs_quads_add(&bs_quads, (Rectangle){ .x = offset_x, .y = offset_y, .width = height, .height = width }, RED);
     } else if(r == 1) {
         uint8_t width = item.size_hovering.x;
         uint8_t height = item.size_hovering.y;
         if(rot == 0)
-            DrawRectangle(offset_x, offset_y, width, height, RED);
+            bs_quads_add(&bs_quads, (Rectangle){ .x = offset_x, .y = offset_y, .width = width, .height = height }, RED);
         else
-            DrawRectangle(offset_x, offset_y, height, width, RED);
+            bs_quads_add(&bs_quads, (Rectangle){ .x = offset_x, .y = offset_y, .width = height, .height = width }, RED);
     }
 }
 
@@ -636,16 +521,16 @@ void bs_render_bs(int32_t offset_x, int32_t offset_y, uint8_t r, uint8_t rot) {
         uint8_t width = item.size_normal.x;
         uint8_t height = item.size_normal.y;
         if(rot == 0)
-            DrawRectangle(offset_x, offset_y, width, height, GREEN);
+            bs_quads_add(&bs_quads, (Rectangle){ .x = offset_x, .y = offset_y, .width = width, .height = height }, GREEN);
         else
-            DrawRectangle(offset_x, offset_y, height, width, GREEN);
+            bs_quads_add(&bs_quads, (Rectangle){ .x = offset_x, .y = offset_y, .width = height, .height = width }, GREEN);
     } else if(r == 1) {
         uint8_t width = item.size_hovering.x;
         uint8_t height = item.size_hovering.y;
         if(rot == 0)
-            DrawRectangle(offset_x, offset_y, width, height, GREEN);
+            bs_quads_add(&bs_quads, (Rectangle){ .x = offset_x, .y = offset_y, .width = width, .height = height }, GREEN);
         else
-            DrawRectangle(offset_x, offset_y, height, width, GREEN);
+            bs_quads_add(&bs_quads, (Rectangle){ .x = offset_x, .y = offset_y, .width = height, .height = width }, GREEN);
     }
 }
 
@@ -660,16 +545,16 @@ void bs_render_ds(int32_t offset_x, int32_t offset_y, uint8_t r, uint8_t rot) {
         uint8_t width = item.size_normal.x;
         uint8_t height = item.size_normal.y;
         if(rot == 0)
-            DrawRectangle(offset_x, offset_y, width, height, PURPLE);
+            bs_quads_add(&bs_quads, (Rectangle){ .x = offset_x, .y = offset_y, .width = width, .height = height }, PURPLE);
         else
-            DrawRectangle(offset_x, offset_y, height, width, PURPLE);
+            bs_quads_add(&bs_quads, (Rectangle){ .x = offset_x, .y = offset_y, .width = height, .height = width }, PURPLE);
     } else if(r == 1) {
         uint8_t width = item.size_hovering.x;
         uint8_t height = item.size_hovering.y;
         if(rot == 0)
-            DrawRectangle(offset_x, offset_y, width, height, PURPLE);
+            bs_quads_add(&bs_quads, (Rectangle){ .x = offset_x, .y = offset_y, .width = width, .height = height }, PURPLE);
         else
-            DrawRectangle(offset_x, offset_y, height, width, PURPLE);
+            bs_quads_add(&bs_quads, (Rectangle){ .x = offset_x, .y = offset_y, .width = height, .height = width }, PURPLE);
     }
 }
 
@@ -684,16 +569,16 @@ void bs_render_sb(int32_t offset_x, int32_t offset_y, uint8_t r, uint8_t rot) {
         uint8_t width = item.size_normal.x;
         uint8_t height = item.size_normal.y;
         if(rot == 0)
-            DrawRectangle(offset_x, offset_y, width, height, YELLOW);
+            bs_quads_add(&bs_quads, (Rectangle){ .x = offset_x, .y = offset_y, .width = width, .height = height }, YELLOW);
         else
-            DrawRectangle(offset_x, offset_y, height, width, YELLOW);
+            bs_quads_add(&bs_quads, (Rectangle){ .x = offset_x, .y = offset_y, .width = height, .height = width }, YELLOW);
     } else if(r == 1) {
         uint8_t width = item.size_hovering.x;
         uint8_t height = item.size_hovering.y;
         if(rot == 0)
-            DrawRectangle(offset_x, offset_y, width, height, YELLOW);
+            bs_quads_add(&bs_quads, (Rectangle){ .x = offset_x, .y = offset_y, .width = width, .height = height }, YELLOW);
         else
-            DrawRectangle(offset_x, offset_y, height, width, YELLOW);
+            bs_quads_add(&bs_quads, (Rectangle){ .x = offset_x, .y = offset_y, .width = height, .height = width }, YELLOW);
     }
 }
 
@@ -709,16 +594,16 @@ void bs_render_pb(int32_t offset_x, int32_t offset_y, uint8_t r, uint8_t rot) {
         uint8_t width = item.size_normal.x;
         uint8_t height = item.size_normal.y;
         if(rot == 0)
-            DrawRectangle(offset_x, offset_y, width, height, BLUE);
+            bs_quads_add(&bs_quads, (Rectangle){ .x = offset_x, .y = offset_y, .width = width, .height = height }, BLUE);
         else
-            DrawRectangle(offset_x, offset_y, height, width, BLUE);
+            bs_quads_add(&bs_quads, (Rectangle){ .x = offset_x, .y = offset_y, .width = height, .height = width }, BLUE);
     } else if(r == 1) {
         uint8_t width = item.size_hovering.x;
         uint8_t height = item.size_hovering.y;
         if(rot == 0)
-            DrawRectangle(offset_x, offset_y, width, height, BLUE);
+            bs_quads_add(&bs_quads, (Rectangle){ .x = offset_x, .y = offset_y, .width = width, .height = height }, BLUE);
         else
-            DrawRectangle(offset_x, offset_y, height, width, BLUE);
+            bs_quads_add(&bs_quads, (Rectangle){ .x = offset_x, .y = offset_y, .width = height, .height = width }, BLUE);
     }
 }
 
@@ -844,8 +729,8 @@ void bs_menu(void) {
         if(IsMouseButtonDown(MOUSE_LEFT_BUTTON)) {
             DrawRectangle(rand_btn.x, rand_btn.y, rand_btn.width, rand_btn.height, SELECTING);
         } else if(IsMouseButtonReleased(MOUSE_LEFT_BUTTON)) {
-            if(randomness == true) randomness = false;
-            else randomness = true;
+            if(bs_session->bot.randomness == true) bs_session->bot.randomness = false;
+            else bs_session->bot.randomness = true;
         } else {
             DrawRectangle(rand_btn.x, rand_btn.y, rand_btn.width, rand_btn.height, SELECTED);
             DrawRectangle(rand_btn.x + rand_btn.width, rand_btn.y, 250, 50, SELECTED);
@@ -856,19 +741,16 @@ void bs_menu(void) {
     }
 
     DrawRectangleLines(rand_btn.x + 5, rand_btn.y + 5, 15, 15, WHITE);
-    if(randomness) {
+    if(bs_session->bot.randomness) {
         DrawRectangle(rand_btn.x + 7, rand_btn.y + 7, 11, 11, WHITE);
     }
 
     DrawText("Randomness", rand_btn.x + 5 + 20, rand_btn.y + 6, 12, WHITE);
 }
 
-/// @brief This is the functionality for the selection
+/// @brief This is the functionality for the selection (where it's up to is kept in the session)
 void bs_selection(void) {
-    static uint8_t selected_vehicle = 0;
-    static Vector2 selected_vec = { .x = 0, .y = 0 };
-    static uint8_t selected_rot = 0; // 0 = Horizontal, 1 = Vertical
-    static item_t item;
+    session_setup_t* setup = &bs_session->setup;
 
     int w = GetScreenWidth();
     int h = GetScreenHeight();
@@ -882,119 +764,247 @@ void bs_selection(void) {
 
     bs_render_btn(continue_btn, UNSELECTED, SELECTED, SELECTING);
     DrawText("Continue", continue_btn.x + (continue_btn.width / 2.25), continue_btn.y + 7, 12, WHITE); // This still feels off slightly and it's bugging me
-    if(bs_point_in_rect(GetMousePosition(), continue_btn) && IsMouseButtonReleased(MOUSE_LEFT_BUTTON)) {
-        // TODO: Add checks first
-
-        bs_state = GAME_STATE_DESTRUCTION;
+    bool continue_clicked = bs_point_in_rect(GetMousePosition(), continue_btn) && IsMouseButtonReleased(MOUSE_LEFT_BUTTON);
+    if(continue_clicked || IsKeyPressed(KEY_ENTER)) {
+        // Only once every ship's been placed, the bot's have to be down too (they're usually
+        // long done by now, otherwise it's only the rest of `DEFENSE_BUDGET`)
+        bs_jobs(true);
+        if(bs_session_start(bs_session)) bs_state = GAME_STATE_DESTRUCTION;
+        return;
     }
 
-    if(IsKeyPressed(KEY_ONE)) {
-        selected_vehicle = PLACE_AC;
-        item = bs_get_item(BS_Aircraft_Carrier);
-        goto prepare;
-    } else if(IsKeyPressed(KEY_TWO)) {
-        selected_vehicle = PLACE_BS;
-        item = bs_get_item(BS_Battleship);
-        goto prepare;
-    } else if(IsKeyPressed(KEY_THREE)) {
-        selected_vehicle = PLACE_DS;
-        item = bs_get_item(BS_Destroyer);
-        goto prepare;
-    } else if(IsKeyPressed(KEY_FOUR)) {
-        selected_vehicle = PLACE_SB;
-        item = bs_get_item(BS_Submarine);
-        goto prepare;
-    } else if(IsKeyPressed(KEY_FIVE)) {
-        selected_vehicle = PLACE_PB;
-        item = bs_get_item(BS_Patrol_Boat);
-        goto prepare;
-    } else if(IsKeyPressed(KEY_R)) {
-        if(selected_rot == 0) {
-            selected_rot = 1;
-            item.rotation = 1;
-        } else {
-            selected_rot = 0;
-            item.rotation = 0;
+    const int keys[5] = { KEY_ONE, KEY_TWO, KEY_THREE, KEY_FOUR, KEY_FIVE };
+    for(uint8_t i = 0; i < 5; i++) {
+        if(IsKeyPressed(keys[i])) {
+            setup->selected = PLACE_AC + i;
+            setup->rotation = 0;
+            setup->item = bs_get_item((game_item_t)i);
         }
-    } else if(IsMouseButtonReleased(MOUSE_BUTTON_LEFT)) {
-        bs_add_item(bs_game_board->a_items, item);
-
-        selected_vehicle = 0;
-        goto prepare;
     }
 
-    // Render any pre-existing items on the board
-    for(uint8_t i = 0; i < 5; i++) {
-        if(bs_game_board->a_items[i].type != PLACE_HIT_INVALID) {
-            // TODO: Change this so instead of having the X and Y coordinates
-            //       be actual coordinates, make it so it's 0-10
-
-            Rectangle _rect = (Rectangle) {
-                .x = bs_game_board->a_items[i].pos.x,
-                .y = bs_game_board->a_items[i].pos.y,
-                .width = item.size_normal.x,
-                .width = item.size_normal.y
-            };
-
-            if(bs_game_board->a_items[i].rotation == 1) {
-                _rect.x = bs_game_board->a_items[i].pos.y;
-                _rect.y = bs_game_board->a_items[i].pos.x;
-                _rect.width = bs_game_board->a_items[i].size_normal.y;
-                _rect.height = bs_game_board->a_items[i].size_normal.x;
-            }
-
-            grid_check_return_t _result = bs_grid_check(_rect, 20, 50);
-            bs_render_board_selection(20, 50, _result.grid);
-
-            bs_render_item(bs_game_board->a_items[i].type, _rect.x, _rect.y, 0, bs_game_board->a_items[i].rotation);
-        }
+    if(IsKeyPressed(KEY_R)) {
+        setup->rotation = setup->rotation == 0 ? 1 : 0;
+        setup->item.rotation = setup->rotation;
+    } else if(IsMouseButtonReleased(MOUSE_BUTTON_LEFT) && setup->selected != 0) {
+        // Only kept if it actually fits where it's hovering (and that ship isn't already down)
+        bs_session_place(bs_session, setup->item);
+        setup->selected = 0;
+        setup->rotation = 0;
     }
 
+    // Anything that's already been placed is in the board's texture (see `bs_render_board`)
+    if(setup->selected == 0) return;
+
+    item_t* item = &setup->item;
     int cx = GetMouseX();
     int cy = GetMouseY();
-    Vector2 c = (Vector2) { .x = cx, .y = cy };
-
-    uint32_t offset_x = cx - (item.size_hovering.x / 2);
-    uint32_t offset_y = cy - (item.size_hovering.y / 2);
 
     Rectangle rect = (Rectangle) {
-        .x = cx - (item.size_hovering.x / 2),
-        .y = cy - (item.size_hovering.y / 2),
-        .width = item.size_hovering.x,
-        .height = item.size_hovering.y
+        .x = cx - (item->size_hovering.x / 2),
+        .y = cy - (item->size_hovering.y / 2),
+        .width = item->size_hovering.x,
+        .height = item->size_hovering.y
     };
 
-    if(selected_rot == 1) {
-        rect.x = cx - (item.size_hovering.y / 2);
-        rect.y = cy - (item.size_hovering.x / 2);
-        rect.width = item.size_hovering.y;
-        rect.height = item.size_hovering.x;
+    if(setup->rotation == 1) {
+        rect.x = cx - (item->size_hovering.y / 2);
+        rect.y = cy - (item->size_hovering.x / 2);
+        rect.width = item->size_hovering.y;
+        rect.height = item->size_hovering.x;
+    }
+
+    item->pos.x = rect.x;
+    item->pos.y = rect.y;
+
+    layout_t layout = bs_board_layout(0);
+    bb_t over = bs_layout_cells_in(&layout, rect);
 
-        offset_x = cx - (item.size_hovering.y / 2);
-        offset_y = cy - (item.size_hovering.x / 2);
+    // The first cell it's over is where it gets placed from
+    if(!bs_bb_is_empty(over)) {
+        uint8_t first = bs_bb_lsb(over);
+        item->relative_pos.x = first % 10;
+        item->relative_pos.y = first / 10;
+    } else {
+        item->relative_pos.x = -1;
+        item->relative_pos.y = -1;
     }
+    bs_render_board_selection(&layout, over);
 
-    item.pos.x = rect.x;
-    item.pos.y = rect.y;
+    bs_render_item(setup->selected, rect.x, rect.y, 1, setup->rotation);
+    bs_quads_flush(&bs_quads);
+}
 
-    Vector2 coords = bs_get_grid_pos(20, 50, c);
-    item.relative_pos.x = coords.x;
-    item.relative_pos.y = coords.y;
+/// @brief This is the functionality for the destruction (taking turns to shoot)
+void bs_destruction(void) {
+    // Both boards (with their ships and shots) have already been rendered by `bs_render_board`
+    if(bs_session->state == SESSION_PLAYER_TURN && IsMouseButtonReleased(MOUSE_BUTTON_LEFT)) {
+        layout_t layout = bs_board_layout(1);
+        uint8_t cell = bs_layout_cell_at(&layout, GetMousePosition());
+        if(cell != LAYOUT_OUTSIDE && bs_session_fire(bs_session, cell) != PLACE_HIT_INVALID) { // Cells already shot are ignored
+            bs_thinker_show(&bs_thinker, &bs_session->bot); // The heuristic mode moves its possibilities around the player's shots
+        }
+    }
+}
 
-    grid_check_return_t result = bs_grid_check(rect, 20, 50);
-    bs_render_board_selection(20, 50, result.grid);
+/// @brief Moves the game on, separately from drawing it (the bot's moves, and the end of the game)
+/// @note This is called every time round, even when nothing's being drawn
+/// @return Returns `true` while anything's happening that the window should keep up with
+bool bs_update(void) {
+    bool active = bs_jobs(false); // Nothing wakes the window when they're done either
+    if(bs_state != GAME_STATE_DESTRUCTION) return active;
+    board_t* board = &bs_session->board;
+
+    // The bot thinks on its own thread, and shoots back once it's done (the window carries on meanwhile)
+    if(bs_session->state == SESSION_BOT_TURN) {
+        knowledge_t k = bs_side_knowledge(&board->a);
+        bs_thinker_start(&bs_thinker, &bs_session->bot, &k); // Does nothing if it's already going
+
+        if(bs_thinker_done(&bs_thinker)) {
+            bs_session_bot_move(bs_session);
+            bs_thinker_show(&bs_thinker, &bs_session->bot);
+        }
+        active = true; // Nothing wakes the window up when it's done, so it has to keep checking
+    }
+    if(bs_session->state == SESSION_OVER) {
+        if(bs_recording) bs_replay_append(&bs_record, &bs_session->replay);
+
+        // Learn from the player's fleet and shots on the thinker (the file's rewritten, which
+        // can take a while). It's unmapped meanwhile, so the bot can't be left pointing into
+        // it (it gets the new one next game, see `bs_jobs`).
+        bs_bot_prior(&bs_session->bot, NULL);
+        memcpy(&bs_learning, &bs_session->replay, sizeof(replay_game_t));
+        if(bs_thinker_run(&bs_thinker, bs_learn_job, &bs_learning)) bs_job = JOB_LEARN;
+
+        bs_state = GAME_STATE_END;
+        active = true;
+    }
 
-    bs_render_item(selected_vehicle, offset_x, offset_y, 1, selected_rot);
+    return active;
+}
 
-    goto end;
+/// @brief This is the functionality for the end of the game
+void bs_end(void) {
+    int w = GetScreenWidth();
 
-prepare:
-    selected_vec.x = 0;
-    selected_vec.y = 0;
-    selected_rot = 0;
+    if(bs_session->winner == SESSION_WINNER_PLAYER) {
+        DrawText(TextFormat("You won in %u shots! Press Space to play again.", bs_session->shots[0]), (w / 2) + 20, 30, 12, GREEN);
+    } else {
+        DrawText(TextFormat("The bot won in %u shots! Press Space to play again.", bs_session->shots[1]), (w / 2) + 20, 30, 12, RED);
+    }
 
-end:
-    return;
+    if(IsKeyReleased(KEY_SPACE)) {
+        bs_new_game(bs_rng_next(&bs_session->rng));
+        bs_state = GAME_STATE_SELECTION;
+    }
+}
+
+/// @brief Starts a new game, the bot keeps its settings and everything it's been given
+/// @param seed The seed for the new game
+void bs_new_game(uint64_t seed) {
+    if(bs_job == JOB_NONE) bs_thinker_cancel(&bs_thinker); // It could still be thinking for the old game
+    session_t* old = bs_session;
+    bs_session = bs_session_open(&bs_sessions, seed);
+
+    // The bot's ships are placed on the thinker (the session starts with a random fleet until
+    // then), and it gets the prior then too, it could still be learning from the last game
+    bs_placing = true;
+    bs_place_seed = seed;
+    bs_thinker_show(&bs_thinker, &bs_session->bot);
+    if(old == NULL) return;
+
+    bs_session->bot.mode = old->bot.mode;
+    bs_session->bot.search = old->bot.search;
+    bs_session->bot.randomness = old->bot.randomness;
+    bs_session->bot.pool = old->bot.pool;
+    bs_session->bot.cache = old->bot.cache;
+    bs_session->bot.book = old->bot.book;
+    bs_session_close(&bs_sessions, old);
+}
+
+// Jobs (on the thinker)
+/// @brief Picks up anything the thinker's finished doing for the window, and gives it the next thing
+/// @param wait `true` = wait until it's all done (the bot's ships are needed now)
+/// @return Returns `true` while there's anything left
+bool bs_jobs(bool wait) {
+    do {
+        if(bs_job != JOB_NONE) {
+            if(wait) bs_thinker_wait(&bs_thinker);
+            if(!bs_thinker_done(&bs_thinker)) return true;
+            if(bs_job == JOB_PLACE && bs_placed_ok) bs_session_place_bot(bs_session, bs_placed.picks);
+            bs_job = JOB_NONE;
+        }
+
+        if(bs_placing) {
+            // Any learning's finished, so the prior's the new one now
+            if(bs_prior.weights != NULL) bs_bot_prior(&bs_session->bot, bs_prior.weights);
+            if(!bs_thinker_run(&bs_thinker, bs_place_job, NULL)) return true; // Still busy with the bot, try again next time
+            bs_placing = false;
+            bs_job = JOB_PLACE;
+        }
+    } while(wait && bs_job != JOB_NONE);
+
+    return bs_job != JOB_NONE;
+}
+
+/// @brief Puts the bot's ships wherever they'd take the player longest to find, going by how
+/// they've opened before if it knows, otherwise assuming they go for the middle
+/// @param arg Nothing (it's `bs_place_seed`, into `bs_placed`)
+void bs_place_job(void* arg) {
+    (void)arg;
+    defense_model_t model;
+    if(bs_prior.counts == NULL || !bs_defense_learned(&model, bs_prior.counts)) bs_defense_density(&model);
+
+    defense_limits_t limits = { .max_time_ns = DEFENSE_BUDGET, .seed = bs_place_seed };
+    bs_placed_ok = bs_defense_run(&bs_pool, &model, &limits, &bs_placed);
+}
+
+/// @brief Learns from the player's fleet and shots. The file gets replaced, so it's let go of first
+/// @param arg The game (`replay_game_t`)
+void bs_learn_job(void* arg) {
+    bs_prior_close(&bs_prior);
+    bs_prior_update("bsbot.prior", arg, PRIOR_SIDE_A);
+    bs_prior_open(&bs_prior, "bsbot.prior");
+}
+
+// Frame pacing
+/// @brief Checks if the player's done anything since the last frame
+/// @note This takes any key presses out of the queue (`GetKeyPressed`), nothing else uses it
+/// @return Returns `true` if they have
+bool bs_pace_input(void) {
+    Vector2 delta = GetMouseDelta();
+    if(delta.x != 0 || delta.y != 0 || GetMouseWheelMove() != 0) return true;
+    if(IsMouseButtonDown(MOUSE_BUTTON_LEFT) || IsMouseButtonReleased(MOUSE_BUTTON_LEFT)) return true;
+    if(IsMouseButtonDown(MOUSE_BUTTON_RIGHT) || IsMouseButtonReleased(MOUSE_BUTTON_RIGHT)) return true;
+    if(IsWindowResized()) return true;
+
+    bool pressed = false;
+    while(GetKeyPressed() != 0) pressed = true;
+    return pressed;
+}
+
+/// @brief Works out how fast to draw, while anything's happening it's as fast as the screen goes,
+///        and once nothing has for `PACE_LINGER` it waits for an event before each frame (so it
+///        uses next to no CPU when nobody's playing)
+/// @note Anything that animates should count as active, nothing will draw it otherwise
+/// @param pace The pacing
+/// @param active Whether anything's happening (input, the bot thinking, anything moving)
+void bs_pace(pace_t* pace, bool active) {
+    double now = GetTime();
+    if(active) pace->last_active = now;
+
+    bool idle = now - pace->last_active > PACE_LINGER;
+    if(idle == pace->idle) return;
+    pace->idle = idle;
+
+    if(idle) {
+        EnableEventWaiting();
+        return;
+    }
+
+    // It's checked every time it wakes up, in case the window's been moved to another monitor
+    int hz = GetMonitorRefreshRate(GetCurrentMonitor());
+    SetTargetFPS(hz > 0 ? hz : PACE_FALLBACK);
+    DisableEventWaiting();
 }
 
 // Debug
@@ -1002,46 +1012,49 @@ void bs_debug_render(void) {
     int w = GetScreenWidth();
     int h = GetScreenHeight();
 
-    DrawRectangle(10, h - 225, w - 20, 200, BLUE);
     int offset_x = 10;
     int offset_y = h - 225;
 
-    DrawText("Debug Mode", offset_x + 10, offset_y + 10, 20, PINK);
-    DrawText("Bot (CPU, AI)", offset_x + 10, offset_y + 10 + 40, 10, WHITE);
+    // All the rectangles go out together, then the text goes over them
+    bs_quads_add(&bs_quads, (Rectangle){ .x = 10, .y = h - 225, .width = w - 20, .height = 200 }, BLUE);
+    const thinker_shown_t* shown = bs_thinker_shown(&bs_thinker); // Not the bot's own, it could be thinking
     for(uint8_t y = 0; y < 10; y++) {
         for(uint8_t x = 0; x < 10; x++) {
-            uint8_t v = (uint8_t)(255 * (uint8_t)(bs_bot->possibilities[x][y] * 100) / 100);
+            uint8_t v = (uint8_t)(shown->possibilities[y][x] >> 8); // Top 8 bits of the fixed point value
             Color c = (Color){ .r = v, .g = v, .b = v, .a = 255 };
 
-            DrawRectangle(offset_x + 10 + (11 * x), offset_y + 50 + (11 * y) + 15, 10, 10, c);
+            bs_quads_add(&bs_quads, (Rectangle){ .x = offset_x + 10 + (11 * x), .y = offset_y + 50 + (11 * y) + 15, .width = 10, .height = 10 }, c);
         }
     }
-    DrawText("Player A", offset_x + 10 + (11 * 11), offset_y + 10 + 40, 10, WHITE);
-    for(uint8_t y = 0; y < 10; y++) {
-        for(uint8_t x = 0; x < 10; x++) {
-            Color c = (Color){ .r = 0, .g = 0, .b = 0, .a = 255 };
-
-            switch(bs_game_board->a_places[y][x]) {
-                case 1:
-                    c = RED;
-                    break;
-                case 2:
-                    c = GREEN;
-                    break;
-                case 3:
-                    c = PURPLE;
-                    break;
-                case 4:
-                    c = YELLOW;
-                    break;
-                case 5:
-                    c = BLUE;
-                    break;
-            }
-
-            DrawRectangle(offset_x + 10 + (11 * x) + (11 * 11), offset_y + 50 + (11 * y) + 15, 10, 10, c);
+    bs_quads_add(&bs_quads, (Rectangle){ .x = offset_x + 10 + (11 * 11), .y = offset_y + 50 + 15, .width = (11 * 10) - 1, .height = (11 * 10) - 1 }, BLACK);
+    const Color ship_colours[5] = { RED, GREEN, PURPLE, YELLOW, BLUE };
+    for(uint8_t i = 0; i < 5; i++) {
+        // Just draw the cells each ship is on, rather than checking every cell
+        bb_t cells = bs_session->board.a.places[i];
+        while(!bs_bb_is_empty(cells)) {
+            uint8_t cell = bs_bb_pop_lsb(&cells);
+            uint8_t x = cell % 10;
+            uint8_t y = cell / 10;
+
+            bs_quads_add(&bs_quads, (Rectangle){ .x = offset_x + 10 + (11 * x) + (11 * 11), .y = offset_y + 50 + (11 * y) + 15, .width = 10, .height = 10 }, ship_colours[i]);
         }
     }
+    bs_quads_flush(&bs_quads);
+
+    DrawText("Debug Mode", offset_x + 10, offset_y + 10, 20, PINK);
+    DrawText("Bot (CPU, AI)", offset_x + 10, offset_y + 10 + 40, 10, WHITE);
+    DrawText("Player A", offset_x + 10 + (11 * 11), offset_y + 10 + 40, 10, WHITE);
+
+    DrawText("Cache", offset_x + 10 + (11 * 22), offset_y + 10 + 40, 10, WHITE);
+    DrawText(TextFormat("Hits: %llu", (unsigned long long)shown->cache_hits), offset_x + 10 + (11 * 22), offset_y + 50 + 15, 10, WHITE);
+    DrawText(TextFormat("Misses: %llu", (unsigned long long)shown->cache_misses), offset_x + 10 + (11 * 22), offset_y + 50 + 30, 10, WHITE);
+    DrawText(TextFormat("Evictions: %llu", (unsigned long long)shown->cache_evictions), offset_x + 10 + (11 * 22), offset_y + 50 + 45, 10, WHITE);
+
+    const search_result_t* searched = &shown->searched;
+    DrawText("Lookahead", offset_x + 10 + (11 * 33), offset_y + 10 + 40, 10, WHITE);
+    DrawText(TextFormat("Depth: %u", searched->depth), offset_x + 10 + (11 * 33), offset_y + 50 + 15, 10, WHITE);
+    DrawText(TextFormat("Nodes: %llu", (unsigned long long)searched->nodes), offset_x + 10 + (11 * 33), offset_y + 50 + 30, 10, WHITE);
+    DrawText(TextFormat("Time: %.2fms", (double)searched->time_ns / 1e6), offset_x + 10 + (11 * 33), offset_y + 50 + 45, 10, WHITE);
     //DrawText(bs_coords_to_string((Vector2){ .x = 1, .y = 1 }), offset_x + 10, offset_y + 50, 15, PINK);
 }
 
@@ -1054,46 +1067,3 @@ void bs_debug_enable(bool enable) {
         SetWindowSize(800, 450);
     }
 }
-
-/*
-    Bot functionality
-*/
-
-/*
-    The bot is (probably) the most complex part of this project.
-    All 100 (10x10) squares start on a fair possibility (0.5), and (for obvious reasons)
-    the player has to place first.
-
-    Unlike what I did for nacbot, which was to basically simulate every possible win and find
-    the most likely move that would win and place there, it would be too computationally heavy,
-    and time consuming to that for battleship. So it'll be a similar set up, but modifying the
-    values as the game progresses.
-
-    The possibilities go up and down based on both boards, since if the player attacks somewhere
-    and hits nothing, we can vaguely guess that it may be somewhere around where they placed one
-    of theirs. So we increment everything within a 3x3 area of that with some amount. Since it's
-    a guess, we don't increment it by much.
-
-    When we hit something, we can use an algorithm to guess where to place next, also incrementing
-    values in a sort of 3x3 area. It's actually more of a diamond shape that a square. Since it's
-    middle gets set to 0, since it's a hit, meaning ignore that value, then the top, left, right,
-    and bottom all increment significantly.
-    
-    When a ship is destroyed, we can decrement the possibility of everything around it by some
-    small amount, since I doubt players are likely to place them directly next to each other.
-    (Though this may be a bad idea)
-*/
-
-/// @brief Initialise the bot
-/// @param ptr The pointer to the bot
-void bs_bot_init(bot_t* ptr) {
-    memset(ptr, 0, sizeof(bot_t));
-
-    for(uint8_t x = 0; x < 10; x++) {
-        for(uint8_t y = 0; y < 10; y++) {
-            // Accidentally made a gradient while testing
-            //ptr->possibilities[x][y] = ((float)x / (float)18) + ((float)y / (float)18);
-            ptr->possibilities[x][y] = 0.5f;
-        }
-    }
-}
\ No newline at end of file
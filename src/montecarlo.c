@@ -0,0 +1,339 @@
+/*
+    BSBOT made by William Dawson (MrBisquit on GitHub)
+    https://wtdawson.info
+
+    --------------------------------------------------------------------------------------------
+
+    Monte Carlo sampler (See montecarlo.h)
+
+    Each sample picks a placement for every ship afloat at random (from the placements that
+    don't touch a miss or a sunk ship), and throws the whole layout away if any ships overlap
+    or a hit is left uncovered. That keeps every agreeing layout equally likely.
+
+    Once there's a hit, almost every random layout would miss it and get thrown away, so one
+    ship is forced onto the lowest hit instead. That makes some layouts more likely than
+    others, so the samples are kept in a separate group for whichever ship was forced onto
+    the hit, and each group is weighted back (by how many of that ship's placements cover
+    the hit, out of all of them) when the groups are added up.
+
+    With placement weights (a prior, see prior.h) each placement is drawn in proportion to its
+    weight instead (with an alias table, so it's still one lookup), so the layouts that are kept come out as likely as their weights
+    multiplied together, which is what the exact count gives them too. The groups are then
+    weighted by the weight of the placements that cover the hit, rather than how many.
+
+    Sampling is split into chunks, one task each, done in rounds of `MC_ROUND_FIRST` doubling
+    up to `MC_ROUND` (or all at once if there's no confidence to check). A chunk's random
+    numbers come from the seed and the chunk's number only, and every worker keeps its own
+    (integer) totals, which are added up exactly before anything's turned into a double. So
+    it doesn't matter how many threads there are or which one ran which chunk: the same seed
+    gives the same answer, including where it stops on confidence.
+
+    --------------------------------------------------------------------------------------------
+
+ *  License:    SPDX-License-Identifier: MIT
+ *              See LICENSE file in the project root for full license text.
+*/
+
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "montecarlo.h"
+#include "rng.h"
+#include "placement.h"
+#include "platform.h"
+
+#define MC_MAX_PLACEMENTS   PLACEMENT_MAX
+#define MC_SAFETY_SAMPLES   (1ULL << 24) // If only a confidence is given, don't go on forever
+
+/// @brief One worker's totals (each group is the ship that was forced onto the hit)
+typedef struct {
+    uint64_t counts[FLEET_SIZE][BB_CELLS];
+    uint64_t accepted[FLEET_SIZE];
+    uint64_t samples;
+    uint8_t padding[64]; // Keep neighbouring workers off each other's cache lines
+} mc_accumulator_t;
+
+/// @brief For drawing from a list by weight in one go (Walker's alias method)
+typedef struct {
+    uint32_t cut[MC_MAX_PLACEMENTS];    // Out of `total`, below this it's this entry...
+    uint8_t alias[MC_MAX_PLACEMENTS];   // ...and above it's this one
+    uint32_t total;
+} mc_alias_t;
+
+typedef struct {
+    bb_t hits;
+    bb_t unknown;       // Cells that haven't been shot
+    uint8_t count;      // Ships afloat
+    uint8_t ships[FLEET_SIZE];
+    bb_t valid[FLEET_SIZE][MC_MAX_PLACEMENTS];
+    uint16_t valid_count[FLEET_SIZE];
+
+    bool targeting;     // There's a hit to force a ship onto
+    uint8_t coverers[FLEET_SIZE];
+    uint8_t coverer_count;
+    bb_t cover[FLEET_SIZE][10]; // Placements of each ship that cover the hit (at most 2 * length)
+    uint8_t cover_count[FLEET_SIZE];
+
+    bool weighted;      // Placements are drawn by weight, with these alias tables (see `bs_mc_alias`)
+    mc_alias_t valid_alias[FLEET_SIZE];
+    mc_alias_t cover_alias[FLEET_SIZE];
+
+    uint64_t seed;
+    uint64_t base;      // Chunk number of this round's first task
+    uint64_t deadline;  // 0 = none
+    volatile int32_t* cancel; // NULL = none
+    mc_accumulator_t* acc;
+} mc_ctx_t;
+
+/// @brief Builds an alias table, so drawing by weight is picking an entry and then which half
+/// @note It's all integers, so it comes out exactly the same everywhere
+/// @param table The table
+/// @param weights Each entry's weight (at least 1)
+/// @param count How many entries
+static void bs_mc_alias(mc_alias_t* table, const uint32_t* weights, uint16_t count) {
+    // Every entry gets a slot that holds `total`, the light ones are topped up from the heavy ones
+    uint32_t scaled[MC_MAX_PLACEMENTS];
+    uint8_t light[MC_MAX_PLACEMENTS], heavy[MC_MAX_PLACEMENTS];
+    uint16_t lights = 0, heavies = 0;
+
+    table->total = 0;
+    for(uint16_t i = 0; i < count; i++) table->total += weights[i];
+    for(uint16_t i = 0; i < count; i++) {
+        scaled[i] = weights[i] * count;
+        table->cut[i] = table->total;
+        table->alias[i] = (uint8_t)i;
+        if(scaled[i] < table->total) light[lights++] = (uint8_t)i;
+        else heavy[heavies++] = (uint8_t)i;
+    }
+
+    while(lights > 0 && heavies > 0) {
+        uint8_t l = light[--lights];
+        uint8_t h = heavy[heavies - 1];
+        table->cut[l] = scaled[l];
+        table->alias[l] = h;
+        scaled[h] -= table->total - scaled[l];
+        if(scaled[h] < table->total) {
+            heavies--;
+            light[lights++] = h;
+        }
+    }
+}
+
+static inline uint16_t bs_mc_pick(rng_t* rng, const mc_alias_t* table, uint16_t count) {
+    uint16_t i = (uint16_t)bs_rng_below(rng, count);
+    return bs_rng_below(rng, table->total) < table->cut[i] ? i : table->alias[i];
+}
+
+static void bs_mc_task(void* arg, uint32_t task, uint32_t worker) {
+    mc_ctx_t* ctx = arg;
+    if(ctx->deadline != 0 && bs_time_ns() > ctx->deadline) return;
+    if(ctx->cancel != NULL && bs_atomic_load32(ctx->cancel)) return;
+
+    mc_accumulator_t* acc = &ctx->acc[worker];
+    rng_t rng;
+    bs_rng_seed(&rng, ctx->seed ^ ((ctx->base + task + 1) * 0xD1B54A32D192ED03ULL));
+
+    for(uint32_t n = 0; n < MC_CHUNK; n++) {
+        bb_t occupied = bs_bb_empty();
+        uint8_t group = 0;
+        uint8_t forced = FLEET_SIZE;
+
+        if(ctx->targeting) {
+            forced = ctx->coverers[bs_rng_below(&rng, ctx->coverer_count)];
+            uint16_t i = ctx->weighted ? bs_mc_pick(&rng, &ctx->cover_alias[forced], ctx->cover_count[forced]) : bs_rng_below(&rng, ctx->cover_count[forced]);
+            occupied = ctx->cover[forced][i];
+            group = forced;
+        }
+
+        bool ok = true;
+        for(uint8_t i = 0; i < ctx->count; i++) {
+            uint8_t s = ctx->ships[i];
+            if(s == forced) continue;
+
+            uint16_t n = ctx->weighted ? bs_mc_pick(&rng, &ctx->valid_alias[s], ctx->valid_count[s]) : bs_rng_below(&rng, ctx->valid_count[s]);
+            bb_t p = ctx->valid[s][n];
+            if(bs_bb_intersects(p, occupied)) {
+                ok = false;
+                break;
+            }
+            occupied = bs_bb_or(occupied, p);
+        }
+
+        if(!ok || !bs_bb_is_empty(bs_bb_andnot(ctx->hits, occupied))) continue;
+
+        acc->accepted[group]++;
+        bb_t cells = bs_bb_and(occupied, ctx->unknown);
+        while(!bs_bb_is_empty(cells)) acc->counts[group][bs_bb_pop_lsb(&cells)]++;
+    }
+
+    acc->samples += MC_CHUNK;
+}
+
+/// @brief Adds up every worker's totals and turns them into probabilities
+/// @return The largest standard error of any cell
+static float bs_mc_merge(const mc_ctx_t* ctx, uint32_t workers, mc_result_t* out, float probabilities[BB_CELLS]) {
+    // The integers are added up first (that's exact in any order), so how the chunks were
+    // shared out between the workers can't change the rounding below
+    mc_accumulator_t sum;
+    memset(&sum, 0, sizeof(mc_accumulator_t));
+    for(uint32_t w = 0; w < workers; w++) {
+        const mc_accumulator_t* acc = &ctx->acc[w];
+        sum.samples += acc->samples;
+        for(uint8_t g = 0; g < FLEET_SIZE; g++) {
+            if(acc->accepted[g] == 0) continue;
+            sum.accepted[g] += acc->accepted[g];
+            for(uint8_t c = 0; c < BB_CELLS; c++) sum.counts[g][c] += acc->counts[g][c];
+        }
+    }
+
+    double weight[FLEET_SIZE];
+    double total = 0.0;
+    double total_sq = 0.0;
+    double cells[BB_CELLS];
+    memset(cells, 0, sizeof(cells));
+    out->samples = sum.samples;
+    out->accepted = 0;
+
+    for(uint8_t g = 0; g < FLEET_SIZE; g++) {
+        weight[g] = 1.0;
+        if(ctx->targeting && ctx->valid_count[g] > 0) {
+            if(ctx->weighted) weight[g] = ctx->cover_count[g] ? (double)ctx->cover_alias[g].total / (double)ctx->valid_alias[g].total : 0.0;
+            else weight[g] = (double)ctx->cover_count[g] / (double)ctx->valid_count[g];
+        }
+        if(sum.accepted[g] == 0) continue;
+
+        out->accepted += sum.accepted[g];
+        total += weight[g] * (double)sum.accepted[g];
+        total_sq += weight[g] * weight[g] * (double)sum.accepted[g];
+        for(uint8_t c = 0; c < BB_CELLS; c++) cells[c] += weight[g] * (double)sum.counts[g][c];
+    }
+
+    if(total <= 0.0) {
+        for(uint8_t c = 0; c < BB_CELLS; c++) probabilities[c] = 0.0f;
+        return 1.0f;
+    }
+
+    // Weighted samples aren't worth as much as plain ones (Kish's effective sample size)
+    double effective = (total * total) / total_sq;
+    double worst = 0.0;
+    for(uint8_t c = 0; c < BB_CELLS; c++) {
+        double p = cells[c] / total;
+        probabilities[c] = (float)p;
+        if(bs_bb_test(ctx->unknown, c)) {
+            double error = sqrt((p * (1.0 - p)) / effective);
+            if(error > worst) worst = error;
+        }
+    }
+
+    return (float)worst;
+}
+
+/// @brief Estimates the chance of each cell being a hit
+/// @param pool The pool to sample on (NULL to only use this thread)
+/// @param k What's known about the board
+/// @param limits When to stop
+/// @param out Stats about the run
+/// @param probabilities The chance of each cell (cells that have been shot come out as 0)
+/// @return Returns `true` if any layout agreed with what's known
+bool bs_mc_run(pool_t* pool, const knowledge_t* k, const mc_limits_t* limits, mc_result_t* out, float probabilities[BB_CELLS]) {
+    uint64_t start = bs_time_ns();
+    uint32_t workers = (pool != NULL && pool->workers > 0) ? pool->workers : 1;
+    mc_ctx_t ctx;
+    memset(&ctx, 0, sizeof(mc_ctx_t));
+    memset(out, 0, sizeof(mc_result_t));
+
+    bb_t blocked = bs_bb_or(k->misses, k->sunk);
+    ctx.hits = k->hits;
+    ctx.unknown = bs_bb_not(bs_bb_or(blocked, k->hits));
+    ctx.seed = limits->seed;
+    ctx.deadline = limits->max_time_ns ? start + limits->max_time_ns : 0;
+    ctx.cancel = limits->cancel;
+    ctx.weighted = limits->weights != NULL;
+
+    bs_placement_init();
+
+    uint8_t target = bs_bb_lsb(k->hits);
+    ctx.targeting = target < BB_CELLS;
+
+    for(uint8_t s = 0; s < FLEET_SIZE; s++) {
+        if(!(k->afloat & (1 << s))) continue;
+
+        const ship_placements_t* table = &bs_ship_placements[s];
+        uint16_t n = 0;
+        uint32_t valid_weights[MC_MAX_PLACEMENTS];
+        uint32_t cover_weights[10];
+        for(uint8_t i = 0; i < table->count; i++) {
+            bb_t mask = table->list[i].mask;
+            if(bs_bb_intersects(mask, blocked)) continue;
+            if(bs_bb_is_empty(bs_bb_andnot(mask, k->hits))) continue; // It would have been sunk
+
+            uint32_t w = ctx.weighted ? limits->weights[s][i] : 1;
+            valid_weights[n] = w;
+            ctx.valid[s][n++] = mask;
+            if(ctx.targeting && bs_bb_test(mask, target)) {
+                cover_weights[ctx.cover_count[s]] = w;
+                ctx.cover[s][ctx.cover_count[s]++] = mask;
+            }
+        }
+
+        if(n == 0) return false; // Nowhere for this ship to be
+        if(ctx.weighted) {
+            bs_mc_alias(&ctx.valid_alias[s], valid_weights, n);
+            bs_mc_alias(&ctx.cover_alias[s], cover_weights, ctx.cover_count[s]);
+        }
+        ctx.valid_count[s] = n;
+        ctx.ships[ctx.count++] = s;
+        if(ctx.cover_count[s] > 0) ctx.coverers[ctx.coverer_count++] = s;
+    }
+
+    if(ctx.count == 0 || (ctx.targeting && ctx.coverer_count == 0)) return false;
+
+    mc_accumulator_t local;
+    if(workers == 1) ctx.acc = &local;
+    else ctx.acc = bs_pool_scratch(pool, sizeof(mc_accumulator_t) * workers); // Only more than one worker with a pool
+    if(ctx.acc == NULL) return false;
+    memset(ctx.acc, 0, sizeof(mc_accumulator_t) * workers);
+
+    uint64_t max_samples = limits->max_samples;
+    if(max_samples == 0 && limits->max_time_ns == 0) max_samples = limits->confidence > 0.0f ? MC_SAFETY_SAMPLES : 65536;
+    uint64_t total_tasks = max_samples ? (max_samples + MC_CHUNK - 1) / MC_CHUNK : UINT64_MAX;
+
+    // Sample in rounds so the confidence can be checked as it goes. The rounds are always the
+    // same chunks whatever the pool's size, so stopping on confidence is still reproducible.
+    // They start small, so an easy position can stop early, and double so a big pool has
+    // plenty to share out. Without a confidence there's nothing to check, so it's all one
+    // round (unless it's only the time that stops it, which the tasks check themselves).
+    uint64_t round = MC_ROUND_FIRST;
+    if(limits->confidence <= 0.0f) round = total_tasks <= UINT32_MAX ? total_tasks : MC_ROUND;
+    uint64_t done = 0;
+    float error = 1.0f;
+    bool finished = false; // Stopped because it had enough, rather than running out of time
+
+    while(done < total_tasks) {
+        uint32_t n = (uint32_t)((total_tasks - done) < round ? (total_tasks - done) : round);
+        ctx.base = done;
+        bs_pool_run(pool, bs_mc_task, &ctx, n);
+        done += n;
+
+        if(limits->confidence > 0.0f) {
+            error = bs_mc_merge(&ctx, workers, out, probabilities);
+            if(error < limits->confidence) {
+                finished = true;
+                break;
+            }
+            if(round < MC_ROUND) round *= 2;
+        }
+        if(ctx.deadline != 0 && bs_time_ns() > ctx.deadline) break;
+        if(ctx.cancel != NULL && bs_atomic_load32(ctx.cancel)) break;
+    }
+
+    if(done >= total_tasks) finished = true;
+    error = bs_mc_merge(&ctx, workers, out, probabilities);
+
+    // Chunks that started after the deadline (or cancelling) didn't sample anything either
+    out->cut_short = !finished || out->samples < done * MC_CHUNK;
+    out->error = error;
+    out->time_ns = bs_time_ns() - start;
+
+    return out->accepted > 0;
+}
@@ -0,0 +1,53 @@
+/*
+    BSBOT made by William Dawson (MrBisquit on GitHub)
+    https://wtdawson.info
+
+    --------------------------------------------------------------------------------------------
+
+    Monte Carlo sampler
+
+    Estimates the chance of each cell being a hit by drawing random layouts of the ships
+    still afloat that agree with what's known. This is for when exact enumeration is too
+    slow (mostly the start of the game), and it spreads the sampling over a thread pool.
+
+    --------------------------------------------------------------------------------------------
+
+ *  License:    SPDX-License-Identifier: MIT
+ *              See LICENSE file in the project root for full license text.
+*/
+
+#ifndef BSBOT_MONTECARLO_H
+#define BSBOT_MONTECARLO_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "bitboard.h"
+#include "knowledge.h"
+#include "placement.h"
+#include "pool.h"
+
+#define MC_CHUNK        2048 // Samples per task
+#define MC_ROUND_FIRST  32  // Tasks before the first confidence check
+#define MC_ROUND        256 // Most tasks between confidence checks (each round's twice the last, up to this)
+
+/// @brief When to stop sampling. Whichever is reached first wins, 0 means "don't use this one"
+typedef struct {
+    uint64_t max_samples;   // Stop after this many samples
+    uint64_t max_time_ns;   // Stop after this long (the result won't be reproducible then)
+    float confidence;       // Stop once every cell's standard error is below this
+    uint64_t seed;          // Same seed + same knowledge = same result (unless time runs out first)
+    volatile int32_t* cancel; // Stop as soon as this is set, from any thread (NULL = never)
+    const uint8_t (*weights)[PLACEMENT_MAX]; // How likely each ship's placements are (NULL = all the same, see `prior_weights_t`)
+} mc_limits_t;
+
+typedef struct {
+    uint64_t samples;       // Layouts drawn
+    uint64_t accepted;      // Layouts that agreed with what's known
+    float error;            // Largest standard error of any cell
+    uint64_t time_ns;       // How long it took
+    bool cut_short;         // Time ran out (or it was cancelled) first, so it's not what running it again would give
+} mc_result_t;
+
+bool bs_mc_run(pool_t* pool, const knowledge_t* k, const mc_limits_t* limits, mc_result_t* out, float probabilities[BB_CELLS]);
+
+#endif
@@ -0,0 +1,72 @@
+/*
+    BSBOT made by William Dawson (MrBisquit on GitHub)
+    https://wtdawson.info
+
+    --------------------------------------------------------------------------------------------
+
+    Ship placement tables (See placement.h)
+
+    --------------------------------------------------------------------------------------------
+
+ *  License:    SPDX-License-Identifier: MIT
+ *              See LICENSE file in the project root for full license text.
+*/
+
+#include <string.h>
+#include "placement.h"
+
+ship_placements_t bs_ship_placements[FLEET_SIZE];
+static bool initialised = false;
+
+/// @brief Builds the tables
+/// @note Everything that uses the tables calls this, but it isn't thread-safe, so call it once at startup if threads are involved
+void bs_placement_init(void) {
+    if(initialised) return;
+
+    for(uint8_t s = 0; s < FLEET_SIZE; s++) {
+        ship_placements_t* ship = &bs_ship_placements[s];
+        memset(ship, 0, sizeof(ship_placements_t));
+        memset(ship->index, PLACEMENT_NONE, sizeof(ship->index));
+
+        for(uint8_t rotation = 0; rotation < 2; rotation++) {
+            for(uint8_t cell = 0; cell < BB_CELLS; cell++) {
+                placement_t* p = &ship->grid[rotation][cell];
+                p->cell = cell;
+                p->rotation = rotation;
+                p->mask = bs_bb_ship(cell % BB_SIZE, cell / BB_SIZE, bs_fleet_lengths[s], rotation);
+                if(bs_bb_is_empty(p->mask)) continue;
+
+                p->halo = bs_bb_neighbours8(p->mask);
+                ship->index[rotation][cell] = ship->count;
+
+                bb_t cells = p->mask;
+                while(!bs_bb_is_empty(cells)) {
+                    uint8_t c = bs_bb_pop_lsb(&cells);
+                    ship->covering[c][ship->covering_count[c]++] = ship->count;
+                }
+
+                ship->list[ship->count++] = *p;
+            }
+        }
+    }
+
+    initialised = true;
+}
+
+/// @brief Finds the placement a ship's cells came from
+/// @param ship The ship (PLACE_x - 1)
+/// @param mask Its cells
+/// @return The placement, or NULL if the ship can't cover exactly those cells
+const placement_t* bs_placement_find(uint8_t ship, bb_t mask) {
+    bs_placement_init();
+
+    uint8_t cell = bs_bb_lsb(mask);
+    if(ship >= FLEET_SIZE || cell >= BB_CELLS) return NULL;
+
+    for(uint8_t rotation = 0; rotation < 2; rotation++) {
+        const placement_t* p = bs_placement(ship, rotation, cell);
+        if(bs_bb_equal(p->mask, mask)) return p;
+    }
+
+    return NULL;
+}
@@ -0,0 +1,64 @@
+/*
+    BSBOT made by William Dawson (MrBisquit on GitHub)
+    https://wtdawson.info
+
+    --------------------------------------------------------------------------------------------
+
+    Ship placement tables
+
+    Every ship, on every cell, in both rotations, worked out once: the cells it covers, and
+    the cells touching it. Anything that moves ships around (checking a placement, random
+    fleets, the bot) looks them up here, so it's just ANDing masks rather than walking cells.
+
+    Rotation is the same as `bs_bb_ship`: 0 goes down from the cell, 1 goes right.
+
+    --------------------------------------------------------------------------------------------
+
+ *  License:    SPDX-License-Identifier: MIT
+ *              See LICENSE file in the project root for full license text.
+*/
+
+#ifndef BSBOT_PLACEMENT_H
+#define BSBOT_PLACEMENT_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "bitboard.h"
+#include "knowledge.h"
+
+#define PLACEMENT_MAX   180  // Most placements a ship can have on the grid (a 2 long ship: 2 * 10 * 9)
+#define PLACEMENT_NONE  0xFF // `index` of a placement that goes off the grid
+
+typedef struct {
+    bb_t mask;          // Cells it covers (empty if it goes off the grid)
+    bb_t halo;          // Cells touching it, diagonals included (not its own cells)
+    uint8_t cell;       // First cell it covers
+    uint8_t rotation;
+} placement_t;
+
+/// @brief Every placement of one ship
+typedef struct {
+    placement_t grid[2][BB_CELLS];      // [rotation][cell], including the ones that go off the grid
+    placement_t list[PLACEMENT_MAX];    // Only the ones on the grid (rotation 0 first, then by cell)
+    uint8_t index[2][BB_CELLS];         // Where each one is in `list`
+    uint8_t count;                      // How many are in `list`
+
+    uint8_t covering[BB_CELLS][10];     // Placements in `list` that cover each cell (at most 2 * length)
+    uint8_t covering_count[BB_CELLS];
+} ship_placements_t;
+
+extern ship_placements_t bs_ship_placements[FLEET_SIZE];
+
+void bs_placement_init(void);
+const placement_t* bs_placement_find(uint8_t ship, bb_t mask);
+
+/// @brief Gets a placement
+/// @param ship The ship (PLACE_x - 1)
+/// @param rotation 0 or 1
+/// @param cell The first cell it covers
+/// @note `bs_placement_init` has to have been called first
+static inline const placement_t* bs_placement(uint8_t ship, uint8_t rotation, uint8_t cell) {
+    return &bs_ship_placements[ship].grid[rotation][cell];
+}
+
+#endif
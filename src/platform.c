@@ -0,0 +1,342 @@
+/*
+    BSBOT made by William Dawson (MrBisquit on GitHub)
+    https://wtdawson.info
+
+    --------------------------------------------------------------------------------------------
+
+    Platform (See platform.h)
+
+    --------------------------------------------------------------------------------------------
+
+ *  License:    SPDX-License-Identifier: MIT
+ *              See LICENSE file in the project root for full license text.
+*/
+
+#if !defined(_WIN32) && !defined(_POSIX_C_SOURCE)
+#define _POSIX_C_SOURCE 200809L // clock_gettime, even with -std=c99
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "platform.h"
+
+/// @brief Makes "<path>.tmp", for writing a file next to the one it'll replace
+static char* bs_temp_path(const char* path) {
+    size_t length = strlen(path);
+    char* temp = malloc(length + 5);
+    if(temp == NULL) return NULL;
+
+    memcpy(temp, path, length);
+    memcpy(temp + length, ".tmp", 5);
+    return temp;
+}
+
+/// @brief Checks what the CPU it's running on supports
+/// @return `BS_CPU_*` flags (always 0 if it isn't x86)
+uint32_t bs_cpu_features(void) {
+    uint32_t features = 0;
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+    __builtin_cpu_init();
+    if(__builtin_cpu_supports("popcnt")) features |= BS_CPU_POPCNT;
+    if(__builtin_cpu_supports("avx2")) features |= BS_CPU_AVX2;
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+    int regs[4];
+    __cpuid(regs, 0);
+    int highest = regs[0];
+
+    __cpuid(regs, 1);
+    if(regs[2] & (1 << 23)) features |= BS_CPU_POPCNT;
+    bool os_saves_avx = (regs[2] & (1 << 27)) && (_xgetbv(0) & 6) == 6; // Or the registers would get lost
+    if(highest >= 7 && os_saves_avx) {
+        __cpuidex(regs, 7, 0);
+        if(regs[1] & (1 << 5)) features |= BS_CPU_AVX2;
+    }
+#endif
+    return features;
+}
+
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+
+typedef struct {
+    bs_thread_fn fn;
+    void* arg;
+} thread_start_t;
+
+static DWORD WINAPI bs_thread_entry(LPVOID param) {
+    thread_start_t start = *(thread_start_t*)param;
+    free(param);
+    start.fn(start.arg);
+    return 0;
+}
+
+/// @brief Starts a thread
+/// @param thread The thread
+/// @param fn The function to run on it
+/// @param arg Passed to `fn`
+/// @return Returns `true` if it started
+bool bs_thread_start(bs_thread_t* thread, bs_thread_fn fn, void* arg) {
+    thread_start_t* start = malloc(sizeof(thread_start_t));
+    if(start == NULL) return false;
+    start->fn = fn;
+    start->arg = arg;
+
+    thread->handle = CreateThread(NULL, 0, bs_thread_entry, start, 0, NULL);
+    if(thread->handle == NULL) {
+        free(start);
+        return false;
+    }
+    return true;
+}
+
+/// @brief Waits for a thread to finish
+void bs_thread_join(bs_thread_t* thread) {
+    WaitForSingleObject(thread->handle, INFINITE);
+    CloseHandle(thread->handle);
+}
+
+/// @brief Gets how many logical CPUs there are
+uint32_t bs_cpu_count(void) {
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    return info.dwNumberOfProcessors > 0 ? info.dwNumberOfProcessors : 1;
+}
+
+void bs_mutex_init(bs_mutex_t* m) { InitializeSRWLock((PSRWLOCK)&m->lock); }
+void bs_mutex_destroy(bs_mutex_t* m) { (void)m; }
+void bs_mutex_lock(bs_mutex_t* m) { AcquireSRWLockExclusive((PSRWLOCK)&m->lock); }
+void bs_mutex_unlock(bs_mutex_t* m) { ReleaseSRWLockExclusive((PSRWLOCK)&m->lock); }
+void bs_cond_init(bs_cond_t* c) { InitializeConditionVariable((PCONDITION_VARIABLE)&c->cond); }
+void bs_cond_destroy(bs_cond_t* c) { (void)c; }
+void bs_cond_wait(bs_cond_t* c, bs_mutex_t* m) { SleepConditionVariableSRW((PCONDITION_VARIABLE)&c->cond, (PSRWLOCK)&m->lock, INFINITE, 0); }
+void bs_cond_broadcast(bs_cond_t* c) { WakeAllConditionVariable((PCONDITION_VARIABLE)&c->cond); }
+
+/// @brief Gets a monotonic time in nanoseconds
+uint64_t bs_time_ns(void) {
+    static LARGE_INTEGER frequency = { 0 };
+    LARGE_INTEGER now;
+    if(frequency.QuadPart == 0) QueryPerformanceFrequency(&frequency);
+    QueryPerformanceCounter(&now);
+
+    // Split it up so it doesn't overflow
+    uint64_t seconds = now.QuadPart / frequency.QuadPart;
+    uint64_t rest = now.QuadPart % frequency.QuadPart;
+    return (seconds * 1000000000ULL) + ((rest * 1000000000ULL) / frequency.QuadPart);
+}
+
+/// @brief Maps a whole file into memory (read-only)
+/// @param map Filled in with where it is
+/// @param path The file
+/// @return Returns `false` if it couldn't be opened or is empty
+bool bs_map_file(bs_map_t* map, const char* path) {
+    map->data = NULL;
+    map->size = 0;
+    map->handle = NULL;
+
+    HANDLE file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if(file == INVALID_HANDLE_VALUE) return false;
+
+    LARGE_INTEGER size;
+    if(!GetFileSizeEx(file, &size) || size.QuadPart == 0) {
+        CloseHandle(file);
+        return false;
+    }
+
+    // The mapping keeps the file open, so the file handle isn't needed after this
+    HANDLE mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+    CloseHandle(file);
+    if(mapping == NULL) return false;
+
+    const void* data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if(data == NULL) {
+        CloseHandle(mapping);
+        return false;
+    }
+
+    map->data = data;
+    map->size = (uint64_t)size.QuadPart;
+    map->handle = mapping;
+    return true;
+}
+
+/// @brief Unmaps a file mapped by `bs_map_file`
+void bs_unmap_file(bs_map_t* map) {
+    if(map->data != NULL) UnmapViewOfFile(map->data);
+    if(map->handle != NULL) CloseHandle(map->handle);
+    map->data = NULL;
+    map->size = 0;
+    map->handle = NULL;
+}
+
+/// @brief Writes a whole file, so that anything reading it sees either the old one or the new one
+/// @note It's written next to it first, flushed to the disk, then moved over the top. Whatever's
+///       mapped the old one has to unmap it first, Windows won't replace a mapped file.
+/// @param path The file
+/// @param data What goes in it
+/// @param size How big it is
+/// @return Returns `false` if it couldn't be written (the old file is left as it was)
+bool bs_replace_file(const char* path, const void* data, uint64_t size) {
+    char* temp = bs_temp_path(path);
+    if(temp == NULL) return false;
+
+    HANDLE file = CreateFileA(temp, GENERIC_WRITE, 0, NULL, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL);
+    if(file == INVALID_HANDLE_VALUE) {
+        free(temp);
+        return false;
+    }
+
+    bool ok = true;
+    const uint8_t* next = data;
+    while(ok && size > 0) {
+        DWORD chunk = size > (1u << 30) ? (1u << 30) : (DWORD)size;
+        DWORD written = 0;
+        ok = WriteFile(file, next, chunk, &written, NULL) && written == chunk;
+        next += chunk;
+        size -= chunk;
+    }
+    if(ok) ok = FlushFileBuffers(file) != 0;
+    CloseHandle(file);
+
+    if(ok) ok = MoveFileExA(temp, path, MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH) != 0;
+    if(!ok) DeleteFileA(temp);
+    free(temp);
+    return ok;
+}
+#else
+#include <time.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+typedef struct {
+    bs_thread_fn fn;
+    void* arg;
+} thread_start_t;
+
+static void* bs_thread_entry(void* param) {
+    thread_start_t start = *(thread_start_t*)param;
+    free(param);
+    start.fn(start.arg);
+    return NULL;
+}
+
+/// @brief Starts a thread
+/// @param thread The thread
+/// @param fn The function to run on it
+/// @param arg Passed to `fn`
+/// @return Returns `true` if it started
+bool bs_thread_start(bs_thread_t* thread, bs_thread_fn fn, void* arg) {
+    thread_start_t* start = malloc(sizeof(thread_start_t));
+    if(start == NULL) return false;
+    start->fn = fn;
+    start->arg = arg;
+
+    if(pthread_create(&thread->handle, NULL, bs_thread_entry, start) != 0) {
+        free(start);
+        return false;
+    }
+    return true;
+}
+
+/// @brief Waits for a thread to finish
+void bs_thread_join(bs_thread_t* thread) {
+    pthread_join(thread->handle, NULL);
+}
+
+/// @brief Gets how many logical CPUs there are
+uint32_t bs_cpu_count(void) {
+    long n = sysconf(_SC_NPROCESSORS_ONLN);
+    return n > 0 ? (uint32_t)n : 1;
+}
+
+void bs_mutex_init(bs_mutex_t* m) { pthread_mutex_init(&m->lock, NULL); }
+void bs_mutex_destroy(bs_mutex_t* m) { pthread_mutex_destroy(&m->lock); }
+void bs_mutex_lock(bs_mutex_t* m) { pthread_mutex_lock(&m->lock); }
+void bs_mutex_unlock(bs_mutex_t* m) { pthread_mutex_unlock(&m->lock); }
+void bs_cond_init(bs_cond_t* c) { pthread_cond_init(&c->cond, NULL); }
+void bs_cond_destroy(bs_cond_t* c) { pthread_cond_destroy(&c->cond); }
+void bs_cond_wait(bs_cond_t* c, bs_mutex_t* m) { pthread_cond_wait(&c->cond, &m->lock); }
+void bs_cond_broadcast(bs_cond_t* c) { pthread_cond_broadcast(&c->cond); }
+
+/// @brief Gets a monotonic time in nanoseconds
+uint64_t bs_time_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ((uint64_t)ts.tv_sec * 1000000000ULL) + (uint64_t)ts.tv_nsec;
+}
+
+/// @brief Maps a whole file into memory (read-only)
+/// @param map Filled in with where it is
+/// @param path The file
+/// @return Returns `false` if it couldn't be opened or is empty
+bool bs_map_file(bs_map_t* map, const char* path) {
+    map->data = NULL;
+    map->size = 0;
+    map->handle = NULL;
+
+    int fd = open(path, O_RDONLY);
+    if(fd < 0) return false;
+
+    struct stat st;
+    if(fstat(fd, &st) != 0 || st.st_size <= 0) {
+        close(fd);
+        return false;
+    }
+
+    // The mapping stays valid after the file's closed
+    void* data = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if(data == MAP_FAILED) return false;
+
+    map->data = data;
+    map->size = (uint64_t)st.st_size;
+    return true;
+}
+
+/// @brief Unmaps a file mapped by `bs_map_file`
+void bs_unmap_file(bs_map_t* map) {
+    if(map->data != NULL) munmap((void*)map->data, (size_t)map->size);
+    map->data = NULL;
+    map->size = 0;
+    map->handle = NULL;
+}
+
+/// @brief Writes a whole file, so that anything reading it sees either the old one or the new one
+/// @note It's written next to it first, flushed to the disk, then renamed over the top. Anything
+///       that's already mapped the old one keeps seeing the old one.
+/// @param path The file
+/// @param data What goes in it
+/// @param size How big it is
+/// @return Returns `false` if it couldn't be written (the old file is left as it was)
+bool bs_replace_file(const char* path, const void* data, uint64_t size) {
+    char* temp = bs_temp_path(path);
+    if(temp == NULL) return false;
+
+    int fd = open(temp, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if(fd < 0) {
+        free(temp);
+        return false;
+    }
+
+    bool ok = true;
+    const uint8_t* next = data;
+    while(ok && size > 0) {
+        ssize_t written = write(fd, next, size > (1u << 30) ? (1u << 30) : (size_t)size);
+        ok = written > 0;
+        if(ok) {
+            next += written;
+            size -= (uint64_t)written;
+        }
+    }
+    if(ok) ok = fsync(fd) == 0;
+    if(close(fd) != 0) ok = false;
+
+    if(ok) ok = rename(temp, path) == 0;
+    if(!ok) unlink(temp);
+    free(temp);
+    return ok;
+}
+#endif
@@ -0,0 +1,116 @@
+/*
+    BSBOT made by William Dawson (MrBisquit on GitHub)
+    https://wtdawson.info
+
+    --------------------------------------------------------------------------------------------
+
+    Platform
+
+    The little bit of threading, atomics, timing and file mapping that the bot needs, for both Windows and
+    everything else (pthreads). This deliberately doesn't include windows.h, since that clashes
+    with raylib (Rectangle, CloseWindow, DrawText, ...), so the Windows types are stored as
+    pointer sized blobs and cast in platform.c.
+
+    --------------------------------------------------------------------------------------------
+
+ *  License:    SPDX-License-Identifier: MIT
+ *              See LICENSE file in the project root for full license text.
+*/
+
+#ifndef BSBOT_PLATFORM_H
+#define BSBOT_PLATFORM_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+#if defined(_WIN32)
+typedef struct { void* handle; } bs_thread_t;
+typedef struct { void* lock; } bs_mutex_t;  // SRWLOCK
+typedef struct { void* cond; } bs_cond_t;   // CONDITION_VARIABLE
+#else
+#include <pthread.h>
+typedef struct { pthread_t handle; } bs_thread_t;
+typedef struct { pthread_mutex_t lock; } bs_mutex_t;
+typedef struct { pthread_cond_t cond; } bs_cond_t;
+#endif
+
+typedef void (*bs_thread_fn)(void* arg);
+
+/// @brief A read-only file mapped into memory
+typedef struct {
+    const void* data;
+    uint64_t size;
+    void* handle;   // The mapping object on Windows (unused elsewhere)
+} bs_map_t;
+
+// Threads
+bool bs_thread_start(bs_thread_t* thread, bs_thread_fn fn, void* arg);
+void bs_thread_join(bs_thread_t* thread);
+uint32_t bs_cpu_count(void);
+
+// Locks
+void bs_mutex_init(bs_mutex_t* m);
+void bs_mutex_destroy(bs_mutex_t* m);
+void bs_mutex_lock(bs_mutex_t* m);
+void bs_mutex_unlock(bs_mutex_t* m);
+void bs_cond_init(bs_cond_t* c);
+void bs_cond_destroy(bs_cond_t* c);
+void bs_cond_wait(bs_cond_t* c, bs_mutex_t* m);
+void bs_cond_broadcast(bs_cond_t* c);
+
+// CPU (what the machine it's running on can do, rather than what it was built for)
+#define BS_CPU_POPCNT   (1 << 0)
+#define BS_CPU_AVX2     (1 << 1)
+uint32_t bs_cpu_features(void);
+
+// Builds one function for an instruction set the rest isn't built for, so it can be picked with
+// `bs_cpu_features` at runtime. Anything it inlines gets built for it too. It's empty where that
+// can't be done (MSVC doesn't need it for intrinsics, and nothing else is x86), and
+// `BS_HAVE_TARGET` is 0 then.
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define BS_TARGET(isa)  __attribute__((target(isa)))
+#define BS_HAVE_TARGET  1
+#else
+#define BS_TARGET(isa)
+#define BS_HAVE_TARGET  0
+#endif
+
+// For a function body that's shared by a `BS_TARGET` version and a plain one
+#if defined(_MSC_VER)
+#define BS_ALWAYS_INLINE __forceinline
+#elif defined(__GNUC__) || defined(__clang__)
+#define BS_ALWAYS_INLINE inline __attribute__((always_inline))
+#else
+#define BS_ALWAYS_INLINE inline
+#endif
+
+// Time
+uint64_t bs_time_ns(void); // Monotonic, only useful for measuring how long something took
+
+// Files
+bool bs_map_file(bs_map_t* map, const char* path);
+void bs_unmap_file(bs_map_t* map);
+bool bs_replace_file(const char* path, const void* data, uint64_t size);
+
+// Atomics (all sequentially consistent, nothing here is hot enough to need anything weaker)
+#if defined(_MSC_VER)
+static inline int64_t bs_atomic_add64(volatile int64_t* p, int64_t v) { return _InterlockedExchangeAdd64((volatile long long*)p, v); }
+static inline int64_t bs_atomic_load64(volatile int64_t* p) { return _InterlockedOr64((volatile long long*)p, 0); }
+static inline void bs_atomic_store64(volatile int64_t* p, int64_t v) { _InterlockedExchange64((volatile long long*)p, v); }
+static inline int32_t bs_atomic_add32(volatile int32_t* p, int32_t v) { return _InterlockedExchangeAdd((volatile long*)p, v); }
+static inline int32_t bs_atomic_load32(volatile int32_t* p) { return _InterlockedOr((volatile long*)p, 0); }
+static inline void bs_atomic_store32(volatile int32_t* p, int32_t v) { _InterlockedExchange((volatile long*)p, v); }
+#else
+static inline int64_t bs_atomic_add64(volatile int64_t* p, int64_t v) { return __atomic_fetch_add(p, v, __ATOMIC_SEQ_CST); }
+static inline int64_t bs_atomic_load64(volatile int64_t* p) { return __atomic_load_n(p, __ATOMIC_SEQ_CST); }
+static inline void bs_atomic_store64(volatile int64_t* p, int64_t v) { __atomic_store_n(p, v, __ATOMIC_SEQ_CST); }
+static inline int32_t bs_atomic_add32(volatile int32_t* p, int32_t v) { return __atomic_fetch_add(p, v, __ATOMIC_SEQ_CST); }
+static inline int32_t bs_atomic_load32(volatile int32_t* p) { return __atomic_load_n(p, __ATOMIC_SEQ_CST); }
+static inline void bs_atomic_store32(volatile int32_t* p, int32_t v) { __atomic_store_n(p, v, __ATOMIC_SEQ_CST); }
+#endif
+
+#endif
@@ -0,0 +1,153 @@
+/*
+    BSBOT made by William Dawson (MrBisquit on GitHub)
+    https://wtdawson.info
+
+    --------------------------------------------------------------------------------------------
+
+    Thread pool (See pool.h)
+
+    Both the owner and any thieves take tasks off the front of a queue with an atomic
+    add, so there's no locking at all while tasks are running. The lock is only used to
+    wake the workers up and to wait for them to finish.
+
+    --------------------------------------------------------------------------------------------
+
+ *  License:    SPDX-License-Identifier: MIT
+ *              See LICENSE file in the project root for full license text.
+*/
+
+#include <stdlib.h>
+#include <string.h>
+#include "pool.h"
+
+/// @brief Runs tasks until every queue is empty, starting with this worker's own
+static void bs_pool_drain(pool_t* pool, uint32_t self) {
+    for(uint32_t i = 0; i < pool->workers; i++) {
+        // i = 0 is our own queue, anything after that is stealing
+        pool_queue_t* q = &pool->queues[(self + i) % pool->workers];
+
+        for(;;) {
+            int64_t task = bs_atomic_add64(&q->next, 1);
+            if(task >= q->end) break;
+            pool->fn(pool->ctx, (uint32_t)task, self);
+        }
+    }
+}
+
+static void bs_pool_worker(void* arg) {
+    pool_worker_t* info = arg;
+    pool_t* pool = info->pool;
+    uint64_t seen = 0;
+
+    for(;;) {
+        bs_mutex_lock(&pool->lock);
+        while(!pool->quit && pool->generation == seen) bs_cond_wait(&pool->wake, &pool->lock);
+        if(pool->quit) {
+            bs_mutex_unlock(&pool->lock);
+            return;
+        }
+        seen = pool->generation;
+        bs_mutex_unlock(&pool->lock);
+
+        bs_pool_drain(pool, info->index);
+
+        bs_mutex_lock(&pool->lock);
+        if(--pool->busy == 0) bs_cond_broadcast(&pool->done);
+        bs_mutex_unlock(&pool->lock);
+    }
+}
+
+/// @brief Starts the pool
+/// @param pool The pool
+/// @param workers How many workers (0 = one per core)
+/// @return Returns `true` if every thread started
+bool bs_pool_init(pool_t* pool, uint32_t workers) {
+    memset(pool, 0, sizeof(pool_t));
+    if(workers == 0) workers = bs_cpu_count();
+    if(workers > POOL_MAX_WORKERS) workers = POOL_MAX_WORKERS;
+
+    bs_mutex_init(&pool->lock);
+    bs_cond_init(&pool->wake);
+    bs_cond_init(&pool->done);
+
+    // Worker 0 is whoever calls bs_pool_run, so it doesn't get a thread
+    pool->workers = 1;
+    for(uint32_t i = 1; i < workers; i++) {
+        pool->info[i].pool = pool;
+        pool->info[i].index = i;
+        if(!bs_thread_start(&pool->threads[i], bs_pool_worker, &pool->info[i])) break;
+        pool->workers++;
+    }
+
+    return pool->workers == workers;
+}
+
+/// @brief Runs a batch of tasks, and waits until they've all finished
+/// @param pool The pool (NULL runs everything on this thread)
+/// @param fn The task
+/// @param ctx Passed to every task
+/// @param tasks How many tasks
+void bs_pool_run(pool_t* pool, pool_task_fn fn, void* ctx, uint32_t tasks) {
+    if(pool == NULL || pool->workers <= 1 || tasks <= 1) {
+        for(uint32_t i = 0; i < tasks; i++) fn(ctx, i, 0);
+        return;
+    }
+
+    bs_mutex_lock(&pool->lock);
+    pool->fn = fn;
+    pool->ctx = ctx;
+
+    // Hand out contiguous runs, the stealing evens it out if some tasks are slower
+    uint32_t per = tasks / pool->workers;
+    uint32_t extra = tasks % pool->workers;
+    int64_t start = 0;
+    for(uint32_t i = 0; i < pool->workers; i++) {
+        int64_t n = per + (i < extra ? 1 : 0);
+        pool->queues[i].next = start;
+        pool->queues[i].end = start + n;
+        start += n;
+    }
+
+    pool->busy = pool->workers - 1;
+    pool->generation++;
+    bs_cond_broadcast(&pool->wake);
+    bs_mutex_unlock(&pool->lock);
+
+    bs_pool_drain(pool, 0);
+
+    bs_mutex_lock(&pool->lock);
+    while(pool->busy > 0) bs_cond_wait(&pool->done, &pool->lock);
+    bs_mutex_unlock(&pool->lock);
+}
+
+/// @brief Gets the pool's scratch memory, which only grows, so it's only allocated the first few times
+/// @param pool The pool
+/// @param size How many bytes are needed
+/// @return The memory (NULL if it couldn't be allocated), which is only valid until the next call
+void* bs_pool_scratch(pool_t* pool, size_t size) {
+    if(size > pool->scratch_size) {
+        void* grown = realloc(pool->scratch, size);
+        if(grown == NULL) return NULL;
+        pool->scratch = grown;
+        pool->scratch_size = size;
+    }
+    return pool->scratch;
+}
+
+/// @brief Stops every thread in the pool
+void bs_pool_destroy(pool_t* pool) {
+    bs_mutex_lock(&pool->lock);
+    pool->quit = true;
+    bs_cond_broadcast(&pool->wake);
+    bs_mutex_unlock(&pool->lock);
+
+    for(uint32_t i = 1; i < pool->workers; i++) bs_thread_join(&pool->threads[i]);
+
+    bs_cond_destroy(&pool->done);
+    bs_cond_destroy(&pool->wake);
+    bs_mutex_destroy(&pool->lock);
+
+    free(pool->scratch);
+    pool->scratch = NULL;
+    pool->scratch_size = 0;
+}
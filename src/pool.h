@@ -0,0 +1,77 @@
+/*
+    BSBOT made by William Dawson (MrBisquit on GitHub)
+    https://wtdawson.info
+
+    --------------------------------------------------------------------------------------------
+
+    Thread pool
+
+    Runs a batch of numbered tasks across every core and waits for them all to finish. The
+    tasks are split into one queue per worker up front, and a worker that runs out steals
+    from the others, so a slow task on one core doesn't leave the rest sitting idle.
+
+    The thread that calls `bs_pool_run` works too (as worker 0), so a pool of 1 has no
+    extra threads at all.
+
+    --------------------------------------------------------------------------------------------
+
+ *  License:    SPDX-License-Identifier: MIT
+ *              See LICENSE file in the project root for full license text.
+*/
+
+#ifndef BSBOT_POOL_H
+#define BSBOT_POOL_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include "platform.h"
+
+#define POOL_MAX_WORKERS 128
+
+/// @brief A task
+/// @param ctx Whatever was passed to `bs_pool_run`
+/// @param task The task number (0 to tasks - 1)
+/// @param worker Which worker is running it (0 to workers - 1), for per-thread data
+typedef void (*pool_task_fn)(void* ctx, uint32_t task, uint32_t worker);
+
+/// @brief One worker's queue, padded so workers don't fight over cache lines
+typedef struct {
+    volatile int64_t next;
+    int64_t end;
+    uint8_t padding[64 - (2 * sizeof(int64_t))];
+} pool_queue_t;
+
+typedef struct pool_t pool_t;
+
+typedef struct {
+    pool_t* pool;
+    uint32_t index;
+} pool_worker_t;
+
+struct pool_t {
+    uint32_t workers; // Including the thread that calls `bs_pool_run`
+    bs_thread_t threads[POOL_MAX_WORKERS];
+    pool_worker_t info[POOL_MAX_WORKERS];
+    pool_queue_t queues[POOL_MAX_WORKERS];
+
+    bs_mutex_t lock;
+    bs_cond_t wake;
+    bs_cond_t done;
+    uint64_t generation; // Goes up every time there's a new batch
+    uint32_t busy;       // Workers still working on this batch
+    bool quit;
+
+    pool_task_fn fn;
+    void* ctx;
+
+    void* scratch;       // Kept between runs so callers don't have to allocate every time
+    size_t scratch_size;
+};
+
+bool bs_pool_init(pool_t* pool, uint32_t workers);
+void bs_pool_run(pool_t* pool, pool_task_fn fn, void* ctx, uint32_t tasks);
+void* bs_pool_scratch(pool_t* pool, size_t size);
+void bs_pool_destroy(pool_t* pool);
+
+#endif
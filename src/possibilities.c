@@ -0,0 +1,223 @@
+/*
+    BSBOT made by William Dawson (MrBisquit on GitHub)
+    https://wtdawson.info
+
+    --------------------------------------------------------------------------------------------
+
+    Possibility grids (See possibilities.h)
+
+    Everything works a row at a time: a bitboard row becomes a mask of 16 lanes, and the row is
+    updated with saturating 16-bit adds. With SSE2 that's two registers per row, without it the
+    same thing is done one value at a time.
+
+    --------------------------------------------------------------------------------------------
+
+ *  License:    SPDX-License-Identifier: MIT
+ *              See LICENSE file in the project root for full license text.
+*/
+
+#include <string.h>
+#include "possibilities.h"
+
+#if !defined(BSBOT_POSS_SCALAR) && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#include <emmintrin.h>
+#define POSS_SSE2
+#endif
+
+/// @brief Gets the 10 bits of one row of a bitboard
+static inline uint16_t bs_poss_row_bits(bb_t mask, uint8_t y) {
+    uint8_t first = y * BB_SIZE;
+    if(first >= 64) return (uint16_t)((mask.hi >> (first - 64)) & 0x3FF);
+    if(first + BB_SIZE <= 64) return (uint16_t)((mask.lo >> first) & 0x3FF);
+    return (uint16_t)(((mask.lo >> first) | (mask.hi << (64 - first))) & 0x3FF); // Row 6 is split across both words
+}
+
+#ifdef POSS_SSE2
+/// @brief Turns the bits of a row into lanes (all ones where the bit's set)
+static inline void bs_poss_row_lanes(uint16_t bits, __m128i lanes[2]) {
+    const __m128i low = _mm_setr_epi16(1 << 0, 1 << 1, 1 << 2, 1 << 3, 1 << 4, 1 << 5, 1 << 6, 1 << 7);
+    const __m128i high = _mm_setr_epi16(1 << 8, 1 << 9, 0, 0, 0, 0, 0, 0);
+    __m128i b = _mm_set1_epi16((short)bits);
+
+    lanes[0] = _mm_cmpeq_epi16(_mm_and_si128(b, low), low);
+    lanes[1] = _mm_andnot_si128(_mm_cmpeq_epi16(high, _mm_setzero_si128()), _mm_cmpeq_epi16(_mm_and_si128(b, high), high));
+}
+#endif
+
+/// @brief Sets every cell (and the padding) to one value
+/// @param grid The grid
+/// @param value The value
+void bs_poss_fill(poss_row_t* grid, uint16_t value) {
+    for(uint8_t y = 0; y < BB_SIZE; y++) {
+        for(uint8_t x = 0; x < POSS_STRIDE; x++) grid[y][x] = x < BB_SIZE ? value : 0;
+    }
+}
+
+/// @brief Adds an amount to every cell in a mask (stops at `POSS_ONE`)
+/// @param grid The grid
+/// @param mask The cells to change
+/// @param amount How much to add
+void bs_poss_add(poss_row_t* grid, bb_t mask, uint16_t amount) {
+    for(uint8_t y = 0; y < BB_SIZE; y++) {
+        uint16_t bits = bs_poss_row_bits(mask, y);
+        if(bits == 0) continue;
+
+#ifdef POSS_SSE2
+        __m128i lanes[2];
+        bs_poss_row_lanes(bits, lanes);
+        __m128i a = _mm_set1_epi16((short)amount);
+        for(uint8_t h = 0; h < 2; h++) {
+            __m128i* row = (__m128i*)&grid[y][h * 8];
+            _mm_storeu_si128(row, _mm_adds_epu16(_mm_loadu_si128(row), _mm_and_si128(lanes[h], a)));
+        }
+#else
+        for(uint8_t x = 0; x < BB_SIZE; x++) {
+            if(!(bits & (1 << x))) continue;
+            uint32_t v = (uint32_t)grid[y][x] + amount;
+            grid[y][x] = v > POSS_ONE ? POSS_ONE : (uint16_t)v;
+        }
+#endif
+    }
+}
+
+/// @brief Takes an amount away from every cell in a mask (stops at 0)
+/// @param grid The grid
+/// @param mask The cells to change
+/// @param amount How much to take away
+void bs_poss_sub(poss_row_t* grid, bb_t mask, uint16_t amount) {
+    for(uint8_t y = 0; y < BB_SIZE; y++) {
+        uint16_t bits = bs_poss_row_bits(mask, y);
+        if(bits == 0) continue;
+
+#ifdef POSS_SSE2
+        __m128i lanes[2];
+        bs_poss_row_lanes(bits, lanes);
+        __m128i a = _mm_set1_epi16((short)amount);
+        for(uint8_t h = 0; h < 2; h++) {
+            __m128i* row = (__m128i*)&grid[y][h * 8];
+            _mm_storeu_si128(row, _mm_subs_epu16(_mm_loadu_si128(row), _mm_and_si128(lanes[h], a)));
+        }
+#else
+        for(uint8_t x = 0; x < BB_SIZE; x++) {
+            if(!(bits & (1 << x))) continue;
+            grid[y][x] = grid[y][x] > amount ? (uint16_t)(grid[y][x] - amount) : 0;
+        }
+#endif
+    }
+}
+
+/// @brief Fills a grid from the probabilities the engines work out
+/// @param grid The grid
+/// @param p The value of each cell (between 0 and 1)
+void bs_poss_from_float(poss_row_t* grid, const float p[BB_CELLS]) {
+#ifdef POSS_SSE2
+    // 8 at a time into one flat list, then copied out a row at a time
+    uint16_t flat[BB_CELLS + 4];
+    const __m128 scale = _mm_set1_ps((float)POSS_ONE);
+    const __m128 half = _mm_set1_ps(0.5f);
+    const __m128i bias = _mm_set1_epi32(0x8000);
+
+    for(uint8_t i = 0; i < BB_CELLS; i += 8) {
+        __m128i v[2];
+        for(uint8_t h = 0; h < 2; h++) {
+            __m128 f;
+            if(i + (h * 4) < BB_CELLS) f = _mm_loadu_ps(&p[i + (h * 4)]);
+            else f = _mm_setzero_ps(); // Past the end (only the last 4)
+            f = _mm_min_ps(_mm_max_ps(f, _mm_setzero_ps()), _mm_set1_ps(1.0f));
+
+            // There's no unsigned pack in SSE2, so shift down into signed and back up after
+            v[h] = _mm_sub_epi32(_mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(f, scale), half)), bias);
+        }
+        _mm_storeu_si128((__m128i*)&flat[i], _mm_xor_si128(_mm_packs_epi32(v[0], v[1]), _mm_set1_epi16((short)0x8000)));
+    }
+
+    for(uint8_t y = 0; y < BB_SIZE; y++) memcpy(grid[y], &flat[y * BB_SIZE], BB_SIZE * sizeof(uint16_t));
+#else
+    for(uint8_t y = 0; y < BB_SIZE; y++) {
+        for(uint8_t x = 0; x < BB_SIZE; x++) {
+            float v = p[(y * BB_SIZE) + x];
+            if(v < 0.0f) v = 0.0f;
+            if(v > 1.0f) v = 1.0f;
+            grid[y][x] = POSS_FIXED(v);
+        }
+    }
+#endif
+}
+
+/// @brief Finds the best few cells that haven't been shot (the lowest index wins a tie)
+/// @note Each pass finds the biggest value under the last one, then takes the cells with it
+/// in order, so picking one cell is only a single pass
+/// @param grid The grid
+/// @param shot The cells that have already been shot at (never picked)
+/// @param best Where the best cells go, best first
+/// @param count How many to find (at most `POSS_TOP`)
+/// @return How many were found (0 if everything's been shot)
+uint8_t bs_poss_top(const poss_row_t* grid, bb_t shot, uint8_t best[POSS_TOP], uint8_t count) {
+    uint8_t found = 0;
+
+#ifdef POSS_SSE2
+    // SSE2 only has a signed max, so everything's flipped into signed (0 becomes -32768)
+    const __m128i flip = _mm_set1_epi16((short)0x8000);
+    __m128i values[BB_SIZE][2];
+    __m128i open[BB_SIZE][2];
+
+    for(uint8_t y = 0; y < BB_SIZE; y++) {
+        bs_poss_row_lanes((uint16_t)(~bs_poss_row_bits(shot, y) & 0x3FF), open[y]);
+        for(uint8_t h = 0; h < 2; h++) values[y][h] = _mm_xor_si128(_mm_loadu_si128((const __m128i*)&grid[y][h * 8]), flip);
+    }
+
+    while(found < count) {
+        __m128i most = flip;
+        for(uint8_t y = 0; y < BB_SIZE; y++) {
+            for(uint8_t h = 0; h < 2; h++) {
+                __m128i v = _mm_or_si128(_mm_and_si128(open[y][h], values[y][h]), _mm_andnot_si128(open[y][h], flip));
+                most = _mm_max_epi16(most, v);
+            }
+        }
+        most = _mm_max_epi16(most, _mm_shuffle_epi32(most, _MM_SHUFFLE(1, 0, 3, 2)));
+        most = _mm_max_epi16(most, _mm_shuffle_epi32(most, _MM_SHUFFLE(2, 3, 0, 1)));
+        most = _mm_max_epi16(most, _mm_shufflelo_epi16(_mm_shufflehi_epi16(most, _MM_SHUFFLE(2, 3, 0, 1)), _MM_SHUFFLE(2, 3, 0, 1)));
+
+        // Take the cells with that value (in order), and leave everything below it for the next pass
+        bool any = false;
+        for(uint8_t y = 0; y < BB_SIZE; y++) {
+            for(uint8_t h = 0; h < 2; h++) {
+                __m128i equal = _mm_and_si128(open[y][h], _mm_cmpeq_epi16(values[y][h], most));
+                uint32_t lanes = (uint32_t)_mm_movemask_epi8(equal);
+                open[y][h] = _mm_andnot_si128(equal, open[y][h]);
+                if(lanes != 0) any = true;
+
+                while(lanes != 0 && found < count) {
+                    best[found++] = (uint8_t)((y * BB_SIZE) + (h * 8) + (bs_ctz64(lanes) / 2));
+                    lanes &= lanes - 1; // Each lane is 2 bits of the mask
+                    lanes &= lanes - 1;
+                }
+            }
+        }
+        if(!any) break;
+    }
+#else
+    bb_t open = bs_bb_not(shot);
+    while(found < count) {
+        // The biggest value left, then every cell with it
+        int32_t most = -1;
+        bb_t cells = open;
+        while(!bs_bb_is_empty(cells)) {
+            uint16_t v = bs_poss_get(grid, bs_bb_pop_lsb(&cells));
+            if(v > most) most = v;
+        }
+        if(most < 0) break;
+
+        cells = open;
+        while(!bs_bb_is_empty(cells)) {
+            uint8_t cell = bs_bb_pop_lsb(&cells);
+            if(bs_poss_get(grid, cell) != most) continue;
+
+            bs_bb_clear(&open, cell);
+            if(found < count) best[found++] = cell;
+        }
+    }
+#endif
+
+    return found;
+}
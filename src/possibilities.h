@@ -0,0 +1,52 @@
+/*
+    BSBOT made by William Dawson (MrBisquit on GitHub)
+    https://wtdawson.info
+
+    --------------------------------------------------------------------------------------------
+
+    Possibility grids
+
+    The bot's possibilities, as 16-bit fixed point (0 = no chance, `POSS_ONE` = certain). Each
+    row is padded out to 16 values (32 bytes), so a whole row is one or two SIMD registers and
+    the padding is never read as a cell. Adding and taking away saturates, so nothing ever
+    needs clamping, and picking the best move is a single pass over the rows.
+
+    --------------------------------------------------------------------------------------------
+
+ *  License:    SPDX-License-Identifier: MIT
+ *              See LICENSE file in the project root for full license text.
+*/
+
+#ifndef BSBOT_POSSIBILITIES_H
+#define BSBOT_POSSIBILITIES_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "bitboard.h"
+
+#define POSS_STRIDE 16      // Values per row (10 cells, then padding)
+#define POSS_ONE    0xFFFF  // 1.0
+#define POSS_TOP    3       // How many moves `bs_poss_top` keeps
+
+/// @brief Turns a value between 0 and 1 into fixed point
+#define POSS_FIXED(f) ((uint16_t)((f) * (float)POSS_ONE + 0.5f))
+
+typedef uint16_t poss_row_t[POSS_STRIDE];
+
+void bs_poss_fill(poss_row_t* grid, uint16_t value);
+void bs_poss_add(poss_row_t* grid, bb_t mask, uint16_t amount);
+void bs_poss_sub(poss_row_t* grid, bb_t mask, uint16_t amount);
+void bs_poss_from_float(poss_row_t* grid, const float p[BB_CELLS]);
+uint8_t bs_poss_top(const poss_row_t* grid, bb_t shot, uint8_t best[POSS_TOP], uint8_t count);
+
+/// @brief Gets one cell's value
+static inline uint16_t bs_poss_get(const poss_row_t* grid, uint8_t cell) {
+    return grid[cell / BB_SIZE][cell % BB_SIZE];
+}
+
+/// @brief Sets one cell's value
+static inline void bs_poss_set(poss_row_t* grid, uint8_t cell, uint16_t value) {
+    grid[cell / BB_SIZE][cell % BB_SIZE] = value;
+}
+
+#endif
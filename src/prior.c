@@ -0,0 +1,251 @@
+/*
+    BSBOT made by William Dawson (MrBisquit on GitHub)
+    https://wtdawson.info
+
+    --------------------------------------------------------------------------------------------
+
+    Priors (See prior.h)
+
+    --------------------------------------------------------------------------------------------
+
+ *  License:    SPDX-License-Identifier: MIT
+ *              See LICENSE file in the project root for full license text.
+*/
+
+#include <stdlib.h>
+#include <string.h>
+#include "prior.h"
+
+/// @brief A whole prior file, as it's written
+typedef struct {
+    prior_header_t header;
+    prior_counts_t counts;
+    prior_weights_t weights;
+} prior_file_t;
+
+/// @brief Clears every count
+void bs_prior_clear(prior_counts_t* counts) {
+    bs_placement_init();
+    memset(counts, 0, sizeof(prior_counts_t));
+}
+
+/// @brief Counts one game
+/// @note Only the placements are counted per ship, the cells are worked out from them by `bs_prior_finish`
+/// @param counts The counts
+/// @param game The game
+/// @param sides Which sides to count (PRIOR_SIDE_x)
+void bs_prior_count(prior_counts_t* counts, const replay_game_t* game, uint8_t sides) {
+    bb_t own[2] = { bs_bb_empty(), bs_bb_empty() };
+    bool whole[2] = { false, false };
+
+    for(uint8_t side = 0; side < 2; side++) {
+        if(!(sides & (1 << side))) continue;
+
+        const placement_t* placed[FLEET_SIZE];
+        uint8_t count = 0;
+
+        for(uint8_t ship = 0; ship < FLEET_SIZE; ship++) {
+            uint8_t packed = game->fleet[side][ship];
+            uint8_t cell = packed & ~REPLAY_ROTATED;
+            if(packed == REPLAY_NONE || cell >= BB_CELLS) continue;
+
+            uint8_t rotation = (packed & REPLAY_ROTATED) ? 1 : 0;
+            uint8_t index = bs_ship_placements[ship].index[rotation][cell];
+            if(index == PLACEMENT_NONE) continue;
+
+            counts->placements[ship][index]++;
+            placed[ship] = &bs_ship_placements[ship].list[index];
+            own[side] = bs_bb_or(own[side], placed[ship]->mask);
+            count++;
+        }
+
+        // Which ships touch only means anything with the whole fleet there
+        if(count != FLEET_SIZE) continue;
+        whole[side] = true;
+        counts->fleets++;
+
+        uint8_t pairs = 0;
+        for(uint8_t i = 0; i < FLEET_SIZE; i++) {
+            for(uint8_t j = i + 1; j < FLEET_SIZE; j++) {
+                if(!bs_bb_intersects(placed[i]->mask, placed[j]->halo)) continue;
+                counts->touching[i][j]++;
+                pairs++;
+            }
+        }
+        counts->touching_pairs[pairs]++;
+    }
+
+    // The shooter is whoever owns the other side. Without a whole fleet of their own only the
+    // opening matters, and that's all in the first few shots even if they're taking turns.
+    uint8_t ply[2] = { 0, 0 };
+    uint8_t count = game->count;
+    if(!whole[0] && !whole[1] && count > PRIOR_OPENING * 2) count = PRIOR_OPENING * 2;
+
+    for(uint8_t i = 0; i < count; i++) {
+        uint8_t shooter = (game->shots[i] & REPLAY_SIDE_B) ? 0 : 1;
+        uint8_t cell = game->shots[i] & ~REPLAY_SIDE_B;
+        if(!(sides & (1 << shooter)) || cell >= BB_CELLS) continue;
+
+        if(ply[shooter] < PRIOR_OPENING) counts->opening[ply[shooter]++][cell]++;
+        if(whole[shooter]) {
+            counts->shots[cell]++;
+            if(bs_bb_test(own[shooter], cell)) counts->own[cell]++;
+        }
+    }
+
+    counts->openings += (ply[0] > 0) + (ply[1] > 0);
+}
+
+/// @brief Adds one set of counts to another
+/// @param into Where they're added
+/// @param from What's added
+void bs_prior_merge(prior_counts_t* into, const prior_counts_t* from) {
+    // It's nothing but counts, so it can be added up as one array
+    uint64_t* a = (uint64_t*)into;
+    const uint64_t* b = (const uint64_t*)from;
+    for(size_t i = 0; i < sizeof(prior_counts_t) / sizeof(uint64_t); i++) a[i] += b[i];
+}
+
+/// @brief Works out the per-cell counts from the placements (after everything's been counted and merged)
+void bs_prior_finish(prior_counts_t* counts) {
+    memset(counts->cells, 0, sizeof(counts->cells));
+
+    for(uint8_t ship = 0; ship < FLEET_SIZE; ship++) {
+        const ship_placements_t* table = &bs_ship_placements[ship];
+        for(uint8_t p = 0; p < table->count; p++) {
+            uint64_t n = counts->placements[ship][p];
+            if(n == 0) continue;
+
+            bb_t cells = table->list[p].mask;
+            while(!bs_bb_is_empty(cells)) counts->cells[ship][bs_bb_pop_lsb(&cells)] += n;
+        }
+    }
+}
+
+/// @brief Turns the counts into a possibility grid for the bot, how likely each cell is to have a ship on it
+/// @note It's scaled so the average cell is 0.5 (what the bot starts every cell on without a prior)
+/// @param counts The counts (after `bs_prior_finish`)
+/// @param grid The grid
+void bs_prior_possibilities(const prior_counts_t* counts, poss_row_t* grid) {
+    float p[BB_CELLS];
+    uint64_t total = 0;
+
+    for(uint8_t cell = 0; cell < BB_CELLS; cell++) {
+        uint64_t n = 0;
+        for(uint8_t ship = 0; ship < FLEET_SIZE; ship++) n += counts->cells[ship][cell];
+        p[cell] = (float)n;
+        total += n;
+    }
+
+    if(total == 0) {
+        bs_poss_fill(grid, POSS_FIXED(0.5f));
+        return;
+    }
+
+    float scale = (0.5f * BB_CELLS) / (float)total;
+    for(uint8_t cell = 0; cell < BB_CELLS; cell++) {
+        p[cell] *= scale;
+        if(p[cell] > 1.0f) p[cell] = 1.0f;
+    }
+
+    bs_poss_from_float(grid, p);
+}
+
+/// @brief Works out the weights the bot uses
+/// @note A placement's weight is how often it was used compared to the average for that ship
+///       (smoothed, so it starts at `PRIOR_NEUTRAL` and only moves once there's enough games)
+/// @param counts The counts (after `bs_prior_finish`)
+/// @param weights The weights
+void bs_prior_weights(const prior_counts_t* counts, prior_weights_t* weights) {
+    bs_prior_possibilities(counts, weights->cells);
+    memset(weights->placements, 0, sizeof(weights->placements));
+
+    for(uint8_t ship = 0; ship < FLEET_SIZE; ship++) {
+        const ship_placements_t* table = &bs_ship_placements[ship];
+
+        uint64_t total = 0;
+        for(uint8_t p = 0; p < table->count; p++) total += counts->placements[ship][p];
+        double average = (double)total / (double)table->count + PRIOR_SMOOTHING;
+
+        for(uint8_t p = 0; p < table->count; p++) {
+            double w = PRIOR_NEUTRAL * ((double)counts->placements[ship][p] + PRIOR_SMOOTHING) / average;
+            if(w < 1.0) w = 1.0;
+            if(w > PRIOR_WEIGHT_MAX) w = PRIOR_WEIGHT_MAX;
+            weights->placements[ship][p] = (uint8_t)(w + 0.5);
+        }
+    }
+}
+
+/// @brief Writes a prior file (replacing it in one go, see `bs_replace_file`)
+/// @param path The file
+/// @param counts The counts (after `bs_prior_finish`)
+/// @return Returns `true` if it was written
+bool bs_prior_write(const char* path, const prior_counts_t* counts) {
+    prior_file_t* file = calloc(1, sizeof(prior_file_t));
+    if(file == NULL) return false;
+
+    file->header = (prior_header_t) {
+        .magic = PRIOR_MAGIC,
+        .version = PRIOR_VERSION,
+        .size = sizeof(prior_counts_t) + sizeof(prior_weights_t)
+    };
+    memcpy(&file->counts, counts, sizeof(prior_counts_t));
+    bs_prior_weights(counts, &file->weights);
+
+    bool ok = bs_replace_file(path, file, sizeof(prior_file_t));
+    free(file);
+    return ok;
+}
+
+/// @brief Adds one game to a prior file (starting a new one if it isn't there)
+/// @note Anything that's mapped the file has to close it first on Windows (see `bs_replace_file`)
+/// @param path The file
+/// @param game The game
+/// @param sides Which sides to count (PRIOR_SIDE_x)
+/// @return Returns `true` if it was written
+bool bs_prior_update(const char* path, const replay_game_t* game, uint8_t sides) {
+    prior_counts_t* counts = malloc(sizeof(prior_counts_t));
+    if(counts == NULL) return false;
+
+    // Whatever's there is the starting point, if it can't be read it's started again
+    prior_t prior;
+    if(bs_prior_open(&prior, path)) {
+        bs_placement_init();
+        memcpy(counts, prior.counts, sizeof(prior_counts_t));
+        bs_prior_close(&prior);
+    } else bs_prior_clear(counts);
+
+    bs_prior_count(counts, game, sides);
+    bs_prior_finish(counts);
+
+    bool ok = bs_prior_write(path, counts);
+    free(counts);
+    return ok;
+}
+
+/// @brief Maps a prior file
+/// @param prior The prior
+/// @param path The file
+/// @return Returns `false` if it couldn't be opened or isn't a prior (the prior is left empty)
+bool bs_prior_open(prior_t* prior, const char* path) {
+    memset(prior, 0, sizeof(prior_t));
+    if(!bs_map_file(&prior->map, path)) return false;
+
+    const prior_header_t* header = prior->map.data;
+    if(prior->map.size < sizeof(prior_file_t) || header->magic != PRIOR_MAGIC ||
+        header->version != PRIOR_VERSION || header->size != sizeof(prior_counts_t) + sizeof(prior_weights_t)) {
+        bs_prior_close(prior);
+        return false;
+    }
+
+    const prior_file_t* file = prior->map.data;
+    prior->counts = &file->counts;
+    prior->weights = &file->weights;
+    return true;
+}
+
+/// @brief Unmaps a prior
+void bs_prior_close(prior_t* prior) {
+    bs_unmap_file(&prior->map);
+    memset(prior, 0, sizeof(prior_t));
+}
@@ -0,0 +1,99 @@
+/*
+    BSBOT made by William Dawson (MrBisquit on GitHub)
+    https://wtdawson.info
+
+    --------------------------------------------------------------------------------------------
+
+    Priors
+
+    What people actually do, counted from replay logs (see replay.h and analyze.c): where they
+    put each ship, which ships end up next to each other, where their first few shots go, and
+    how often they shoot where their own ships are (players tend to avoid it, which is a hint
+    at where their fleet is).
+
+    Counts just add up, so each thread can count its own share of a log and they're merged
+    at the end, and a file can be topped up a game at a time (`bs_prior_update`) without
+    recounting everything.
+
+    The file also has the weights the bot uses worked out already, so loading it is mapping
+    it and pointing the bot at them (`bs_bot_prior`), nothing gets parsed or converted.
+
+    File layout (little endian, everything is read straight out of the mapped file):
+        prior_header_t
+        prior_counts_t
+        prior_weights_t
+
+    --------------------------------------------------------------------------------------------
+
+ *  License:    SPDX-License-Identifier: MIT
+ *              See LICENSE file in the project root for full license text.
+*/
+
+#ifndef BSBOT_PRIOR_H
+#define BSBOT_PRIOR_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "bitboard.h"
+#include "knowledge.h"
+#include "placement.h"
+#include "possibilities.h"
+#include "replay.h"
+
+#define PRIOR_MAGIC     0x52505342 // "BSPR"
+#define PRIOR_VERSION   2
+#define PRIOR_OPENING   8   // Shots from the start of each game that are counted on their own
+#define PRIOR_PAIRS     ((FLEET_SIZE * (FLEET_SIZE - 1)) / 2) // Most pairs of ships that can touch
+
+#define PRIOR_NEUTRAL   16  // Placement weight for one that's used as much as any other
+#define PRIOR_WEIGHT_MAX 64 // Biggest placement weight (4x as likely), so one placement can't take over
+#define PRIOR_SMOOTHING 16  // Pretend every placement was used this many more times, so a few games can't swing it far
+
+#define PRIOR_SIDE_A    1   // Count `a` (its fleet, and the shots fired by whoever owns it)
+#define PRIOR_SIDE_B    2
+#define PRIOR_SIDE_BOTH (PRIOR_SIDE_A | PRIOR_SIDE_B)
+
+typedef struct {
+    uint32_t magic;
+    uint32_t version;
+    uint64_t size;      // sizeof(prior_counts_t) + sizeof(prior_weights_t), so a file from a different build isn't misread
+    uint64_t reserved[2];
+} prior_header_t;
+
+typedef struct {
+    uint64_t fleets;                                // Whole fleets counted
+    uint64_t openings;                              // Players whose first shots were counted
+    uint64_t placements[FLEET_SIZE][PLACEMENT_MAX]; // How often each placement was used (same order as the placement lists)
+    uint64_t cells[FLEET_SIZE][BB_CELLS];           // How often each ship was on each cell (filled in by `bs_prior_finish`)
+    uint64_t touching[FLEET_SIZE][FLEET_SIZE];      // How often two ships were next to each other, diagonals included ([i][j], i < j)
+    uint64_t touching_pairs[PRIOR_PAIRS + 1];       // Fleets with this many pairs of ships next to each other
+    uint64_t opening[PRIOR_OPENING][BB_CELLS];      // Where a player's first, second... shot went
+    uint64_t shots[BB_CELLS];                       // Every shot by a player who has a fleet of their own, where it went
+    uint64_t own[BB_CELLS];                         // ...and how many of those were on the shooter's own ships
+} prior_counts_t;
+
+/// @brief What the bot uses, worked out from the counts (by `bs_prior_weights`)
+typedef struct prior_weights {
+    poss_row_t cells[BB_SIZE];                      // Where it starts, the same layout as `bot_t.possibilities`
+    uint8_t placements[FLEET_SIZE][PLACEMENT_MAX];  // Each placement's weight (PRIOR_NEUTRAL = used as much as any other)
+} prior_weights_t;
+
+typedef struct {
+    bs_map_t map;
+    const prior_counts_t* counts;   // Straight out of the file
+    const prior_weights_t* weights;
+} prior_t;
+
+void bs_prior_clear(prior_counts_t* counts);
+void bs_prior_count(prior_counts_t* counts, const replay_game_t* game, uint8_t sides);
+void bs_prior_merge(prior_counts_t* into, const prior_counts_t* from);
+void bs_prior_finish(prior_counts_t* counts);
+void bs_prior_possibilities(const prior_counts_t* counts, poss_row_t* grid);
+void bs_prior_weights(const prior_counts_t* counts, prior_weights_t* weights);
+
+bool bs_prior_write(const char* path, const prior_counts_t* counts);
+bool bs_prior_update(const char* path, const replay_game_t* game, uint8_t sides);
+bool bs_prior_open(prior_t* prior, const char* path);
+void bs_prior_close(prior_t* prior);
+
+#endif
@@ -0,0 +1,65 @@
+/*
+    BSBOT made by William Dawson (MrBisquit on GitHub)
+    https://wtdawson.info
+
+    --------------------------------------------------------------------------------------------
+
+    Batched rectangles (See quads.h)
+
+    --------------------------------------------------------------------------------------------
+
+ *  License:    SPDX-License-Identifier: MIT
+ *              See LICENSE file in the project root for full license text.
+*/
+
+#include <rlgl.h>
+#include "quads.h"
+
+/// @brief Adds a rectangle to be drawn at the next flush
+/// @param q The list
+/// @param rect Where it goes
+/// @param colour What colour it is
+void bs_quads_add(quads_t* q, Rectangle rect, Color colour) {
+    if(q->count == QUADS_MAX) bs_quads_flush(q);
+    q->list[q->count++] = (quad_entry_t){ .rect = rect, .colour = colour };
+}
+
+/// @brief Draws everything that's been added (in the order it was added), and empties the list
+/// @param q The list
+void bs_quads_flush(quads_t* q) {
+    if(q->count == 0) return;
+
+    // The same bit of the shapes texture `DrawRectangle` uses, so they look exactly the same
+    Texture2D texture = GetShapesTexture();
+    Rectangle source = GetShapesTextureRectangle();
+    float u0 = source.x / texture.width;
+    float v0 = source.y / texture.height;
+    float u1 = (source.x + source.width) / texture.width;
+    float v1 = (source.y + source.height) / texture.height;
+
+    // Makes sure they all fit in what's left of rlgl's batch, so they go out together
+    rlCheckRenderBatchLimit(4 * (int)q->count);
+
+    rlSetTexture(texture.id);
+    rlBegin(RL_QUADS);
+    rlNormal3f(0.0f, 0.0f, 1.0f);
+    for(uint32_t i = 0; i < q->count; i++) {
+        Rectangle r = q->list[i].rect;
+        Color c = q->list[i].colour;
+
+        // Top-left, bottom-left, bottom-right, top-right (anticlockwise, the same as raylib)
+        rlColor4ub(c.r, c.g, c.b, c.a);
+        rlTexCoord2f(u0, v0);
+        rlVertex2f(r.x, r.y);
+        rlTexCoord2f(u0, v1);
+        rlVertex2f(r.x, r.y + r.height);
+        rlTexCoord2f(u1, v1);
+        rlVertex2f(r.x + r.width, r.y + r.height);
+        rlTexCoord2f(u1, v0);
+        rlVertex2f(r.x + r.width, r.y);
+    }
+    rlEnd();
+    rlSetTexture(0);
+
+    q->count = 0;
+}
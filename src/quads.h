@@ -0,0 +1,47 @@
+/*
+    BSBOT made by William Dawson (MrBisquit on GitHub)
+    https://wtdawson.info
+
+    --------------------------------------------------------------------------------------------
+
+    Batched rectangles
+
+    Nearly everything on the screen is a solid rectangle (the cells, the ships, the debug
+    heatmap), and drawing them one `DrawRectangle` at a time works out the corners (and checks
+    for rotation) every time. Instead they're put in a list, and the whole list goes to rlgl
+    in one go, as one run of quads on the shapes texture, which is one draw call.
+
+    Nothing's drawn until `bs_quads_flush`, so anything raylib draws that has to go over them
+    (text, circles) has to be after a flush, and so does anything that changes where it's
+    drawn (`EndScissorMode`, `EndTextureMode`, `EndDrawing`). If it fills up it flushes itself.
+
+    This is only used by the window (main.c), so it isn't in bsbot_core.
+
+    --------------------------------------------------------------------------------------------
+
+ *  License:    SPDX-License-Identifier: MIT
+ *              See LICENSE file in the project root for full license text.
+*/
+
+#ifndef BSBOT_QUADS_H
+#define BSBOT_QUADS_H
+
+#include <stdint.h>
+#include <raylib.h>
+
+#define QUADS_MAX   1024        // Rectangles per flush (4 vertices each, well inside rlgl's batch)
+
+typedef struct {
+    Rectangle rect;
+    Color colour;
+} quad_entry_t;
+
+typedef struct {
+    quad_entry_t list[QUADS_MAX];
+    uint32_t count;
+} quads_t;
+
+void bs_quads_add(quads_t* q, Rectangle rect, Color colour);
+void bs_quads_flush(quads_t* q);
+
+#endif
@@ -0,0 +1,256 @@
+/*
+    BSBOT made by William Dawson (MrBisquit on GitHub)
+    https://wtdawson.info
+
+    --------------------------------------------------------------------------------------------
+
+    Replay logs (See replay.h)
+
+    --------------------------------------------------------------------------------------------
+
+ *  License:    SPDX-License-Identifier: MIT
+ *              See LICENSE file in the project root for full license text.
+*/
+
+#include <string.h>
+#include "replay.h"
+
+/// @brief Starts recording a game, from the fleets on a board
+/// @param game The game
+/// @param board The board (only the items are used)
+void bs_replay_begin(replay_game_t* game, const board_t* board) {
+    game->winner = REPLAY_WINNER_NONE;
+    game->count = 0;
+    bs_replay_fleet(game, 0, board->a_items);
+    bs_replay_fleet(game, 1, board->b_items);
+}
+
+/// @brief Records one side's fleet
+/// @param game The game
+/// @param side Which side (0 = `a`, 1 = `b`)
+/// @param items The items (in any order, ones with a type of `PLACE_HIT_INVALID` aren't placed)
+void bs_replay_fleet(replay_game_t* game, uint8_t side, const item_t items[5]) {
+    memset(game->fleet[side], REPLAY_NONE, FLEET_SIZE);
+    if(items == NULL) return;
+
+    for(uint8_t i = 0; i < 5; i++) {
+        uint32_t ship = (uint32_t)items[i].type - PLACE_AC;
+        uint32_t x = (uint32_t)(int32_t)items[i].relative_pos.x;
+        uint32_t y = (uint32_t)(int32_t)items[i].relative_pos.y;
+        if(ship >= FLEET_SIZE || x >= BB_SIZE || y >= BB_SIZE) continue;
+
+        game->fleet[side][ship] = bs_bb_index(x, y) | (items[i].rotation ? REPLAY_ROTATED : 0);
+    }
+}
+
+/// @brief Writes out the games in the buffer as one block
+static bool bs_replay_flush(replay_writer_t* writer) {
+    if(writer->games == 0) return writer->ok;
+
+    replay_block_t block = { .bytes = writer->used, .games = writer->games };
+    if(fwrite(&block, sizeof(block), 1, writer->f) != 1 || fwrite(writer->buffer, 1, writer->used, writer->f) != writer->used) writer->ok = false;
+
+    writer->header.games += writer->games;
+    writer->header.blocks++;
+    writer->used = 0;
+    writer->games = 0;
+    return writer->ok;
+}
+
+/// @brief Starts a new log (anything already at `path` is replaced)
+/// @param writer The writer (it has a 64KB buffer in it, so it's best not on the stack)
+/// @param path The file
+/// @param seed The seed the games are played with (just stored, 0 = none)
+/// @return Returns `true` if the file could be created
+bool bs_replay_create(replay_writer_t* writer, const char* path, uint64_t seed) {
+    writer->f = fopen(path, "wb");
+    writer->header = (replay_header_t) {
+        .magic = REPLAY_MAGIC,
+        .version = REPLAY_VERSION,
+        .seed = seed
+    };
+    writer->used = 0;
+    writer->games = 0;
+    writer->ok = writer->f != NULL;
+    if(!writer->ok) return false;
+
+    // The counts get filled in by `bs_replay_finish`
+    if(fwrite(&writer->header, sizeof(replay_header_t), 1, writer->f) != 1) writer->ok = false;
+    return writer->ok;
+}
+
+/// @brief Adds a game to the log
+/// @param writer The writer
+/// @param game The game
+/// @return Returns `false` if writing has gone wrong (at any point, not just this game)
+bool bs_replay_append(replay_writer_t* writer, const replay_game_t* game) {
+    if(writer->f == NULL) return false;
+
+    uint32_t size = (uint32_t)REPLAY_GAME_SIZE + game->count;
+    if(writer->used + size > REPLAY_BLOCK) bs_replay_flush(writer);
+
+    memcpy(writer->buffer + writer->used, game, size);
+    writer->used += size;
+    writer->games++;
+    return writer->ok;
+}
+
+/// @brief Writes out what's left, fills in the header and closes the file
+/// @param writer The writer
+/// @return Returns `true` if the whole log was written
+bool bs_replay_finish(replay_writer_t* writer) {
+    if(writer->f == NULL) return false;
+
+    bs_replay_flush(writer);
+    if(fseek(writer->f, 0, SEEK_SET) != 0 || fwrite(&writer->header, sizeof(replay_header_t), 1, writer->f) != 1) writer->ok = false;
+    if(fclose(writer->f) != 0) writer->ok = false;
+
+    writer->f = NULL;
+    return writer->ok;
+}
+
+/// @brief Maps a log
+/// @param replay The log
+/// @param path The file
+/// @return Returns `false` if it couldn't be opened or isn't a log (the log is left empty)
+bool bs_replay_open(replay_t* replay, const char* path) {
+    memset(replay, 0, sizeof(replay_t));
+    if(!bs_map_file(&replay->map, path)) return false;
+
+    replay_header_t header;
+    if(replay->map.size < sizeof(replay_header_t)) {
+        bs_replay_close(replay);
+        return false;
+    }
+
+    memcpy(&header, replay->map.data, sizeof(replay_header_t));
+    if(header.magic != REPLAY_MAGIC || header.version != REPLAY_VERSION) {
+        bs_replay_close(replay);
+        return false;
+    }
+
+    replay->start = (const uint8_t*)replay->map.data + sizeof(replay_header_t);
+    replay->end = (const uint8_t*)replay->map.data + replay->map.size;
+    replay->seed = header.seed;
+    replay->games = header.games;
+    return true;
+}
+
+/// @brief Unmaps a log
+void bs_replay_close(replay_t* replay) {
+    bs_unmap_file(&replay->map);
+    memset(replay, 0, sizeof(replay_t));
+}
+
+/// @brief Starts reading from the first game
+/// @param replay The log
+/// @param cursor The cursor
+void bs_replay_cursor(const replay_t* replay, replay_cursor_t* cursor) {
+    cursor->block = replay->start;
+    cursor->end = replay->end;
+    cursor->next = NULL;
+    cursor->left = 0;
+}
+
+/// @brief Finds where every block starts, without reading any games (so a log can be split up)
+/// @param replay The log
+/// @param starts Where they go (NULL to just count them)
+/// @param max How many fit in `starts`
+/// @return How many whole blocks there are (even if that's more than `max`)
+uint64_t bs_replay_blocks(const replay_t* replay, const uint8_t** starts, uint64_t max) {
+    const uint8_t* block = replay->start;
+    uint64_t count = 0;
+
+    while((size_t)(replay->end - block) >= sizeof(replay_block_t)) {
+        replay_block_t header;
+        memcpy(&header, block, sizeof(replay_block_t));
+        if((size_t)(replay->end - block) - sizeof(replay_block_t) < header.bytes) break;
+
+        if(starts != NULL && count < max) starts[count] = block;
+        count++;
+        block += sizeof(replay_block_t) + header.bytes;
+    }
+
+    return count;
+}
+
+/// @brief Starts reading part of a log
+/// @param replay The log
+/// @param cursor The cursor
+/// @param from The first block (from `bs_replay_blocks`)
+/// @param to Where to stop (another block's start, or NULL for the end of the log)
+void bs_replay_range(const replay_t* replay, replay_cursor_t* cursor, const uint8_t* from, const uint8_t* to) {
+    cursor->block = from;
+    cursor->end = to != NULL ? to : replay->end;
+    cursor->next = NULL;
+    cursor->left = 0;
+}
+
+/// @brief Reads the next game
+/// @param cursor The cursor
+/// @return The game (pointing into the log, valid until it's closed), or NULL once there aren't any more
+const replay_game_t* bs_replay_next(replay_cursor_t* cursor) {
+    while(cursor->left == 0) {
+        if((size_t)(cursor->end - cursor->block) < sizeof(replay_block_t)) return NULL;
+
+        replay_block_t block;
+        memcpy(&block, cursor->block, sizeof(replay_block_t)); // Blocks aren't aligned
+        const uint8_t* games = cursor->block + sizeof(replay_block_t);
+        if((size_t)(cursor->end - games) < block.bytes) return NULL; // Cut off part way through
+
+        cursor->next = games;
+        cursor->left = block.games;
+        cursor->block = games + block.bytes;
+    }
+
+    // Everything in a game is a byte, so it can be read where it is
+    const replay_game_t* game = (const replay_game_t*)cursor->next;
+    if((size_t)(cursor->block - cursor->next) < REPLAY_GAME_SIZE || (size_t)(cursor->block - cursor->next) < REPLAY_GAME_SIZE + game->count) {
+        cursor->left = 0;
+        cursor->block = cursor->end; // The block doesn't add up, so nothing after it can be trusted
+        return NULL;
+    }
+
+    cursor->next += REPLAY_GAME_SIZE + game->count;
+    cursor->left--;
+    return game;
+}
+
+/// @brief Plays a game back onto a board, checking every step of it
+/// @param game The game
+/// @param board The board (cleared first)
+/// @return Returns `false` if a ship doesn't fit, a shot's been fired twice, or the winner doesn't match
+bool bs_replay_board(const replay_game_t* game, board_t* board) {
+    bs_new_board_ptr(board);
+
+    for(uint8_t side = 0; side < 2; side++) {
+        side_t* target = side ? &board->b : &board->a;
+        item_t* items = side ? board->b_items : board->a_items;
+
+        for(uint8_t ship = 0; ship < FLEET_SIZE; ship++) {
+            uint8_t packed = game->fleet[side][ship];
+            if(packed == REPLAY_NONE) continue;
+
+            uint8_t cell = packed & ~REPLAY_ROTATED;
+            if(cell >= BB_CELLS) return false;
+
+            item_t item = bs_get_item((game_item_t)ship);
+            item.rotation = (packed & REPLAY_ROTATED) ? 1 : 0;
+            item.relative_pos.x = cell % BB_SIZE;
+            item.relative_pos.y = cell / BB_SIZE;
+            item.pos = item.relative_pos;
+
+            if(!bs_place_item(target, item)) return false;
+            bs_add_item(items, item);
+        }
+    }
+
+    for(uint8_t i = 0; i < game->count; i++) {
+        side_t* target = (game->shots[i] & REPLAY_SIDE_B) ? &board->b : &board->a;
+        if(bs_fire(target, game->shots[i] & ~REPLAY_SIDE_B) == PLACE_HIT_INVALID) return false;
+    }
+
+    if(game->winner == REPLAY_WINNER_A) return board->b.sunk == FLEET_ALL;
+    if(game->winner == REPLAY_WINNER_B) return board->a.sunk == FLEET_ALL;
+    return game->winner == REPLAY_WINNER_NONE;
+}
@@ -0,0 +1,132 @@
+/*
+    BSBOT made by William Dawson (MrBisquit on GitHub)
+    https://wtdawson.info
+
+    --------------------------------------------------------------------------------------------
+
+    Replay logs
+
+    Whole games, packed small enough to keep millions of them. A game is both fleets (one byte
+    a ship) and every shot (one byte a shot), so a typical game is around 60 bytes.
+
+    Games are written through a buffer and go out a block at a time, so writing is one memcpy
+    a game. Reading maps the file and hands back pointers straight into it, so going through
+    millions of games doesn't copy or allocate anything. Each block says how big it is, so
+    a reader can jump from block to block (to split a log between threads) without looking
+    at any games.
+
+    File layout (little endian):
+        replay_header_t
+        Blocks, each:
+            replay_block_t
+            Games, each:
+                uint8_t fleet[2][5]     Each ship's first cell, with its rotation in the top bit (REPLAY_NONE = not placed)
+                uint8_t winner          REPLAY_WINNER_x
+                uint8_t count           How many shots
+                uint8_t shots[count]    The cell, with the top bit set if it was fired at `b` (otherwise `a`)
+
+    The header's game and block counts are filled in when the log is finished, a log that was
+    never finished (a crash, say) can still be read up to its last whole block.
+
+    --------------------------------------------------------------------------------------------
+
+ *  License:    SPDX-License-Identifier: MIT
+ *              See LICENSE file in the project root for full license text.
+*/
+
+#ifndef BSBOT_REPLAY_H
+#define BSBOT_REPLAY_H
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include "game.h"
+#include "platform.h"
+
+#define REPLAY_MAGIC        0x50525342 // "BSRP"
+#define REPLAY_VERSION      1
+#define REPLAY_BLOCK        (64 * 1024) // Biggest a block gets (a game never gets split between blocks)
+#define REPLAY_MAX_SHOTS    (BB_CELLS * 2)
+#define REPLAY_GAME_SIZE    (sizeof(replay_game_t) - REPLAY_MAX_SHOTS) // Before the shots
+#define REPLAY_NONE         0xFF
+#define REPLAY_ROTATED      0x80 // In a fleet byte, the ship has rotation 1
+#define REPLAY_SIDE_B       0x80 // In a shot byte, it was fired at `b`
+
+#define REPLAY_WINNER_NONE  0
+#define REPLAY_WINNER_A     1
+#define REPLAY_WINNER_B     2
+
+typedef struct {
+    uint32_t magic;
+    uint32_t version;
+    uint64_t seed;      // Whatever seed the games were played with (0 = none)
+    uint64_t games;     // 0 until the log's finished
+    uint64_t blocks;
+} replay_header_t;
+
+typedef struct {
+    uint32_t bytes;     // Size of the games after this
+    uint32_t games;
+} replay_block_t;
+
+/// @brief One game (as it's stored, so a game read back is a pointer into the file)
+/// @note A game read from a log only has `count` shots, anything after that is the next game
+typedef struct {
+    uint8_t fleet[2][FLEET_SIZE];
+    uint8_t winner;
+    uint8_t count;
+    uint8_t shots[REPLAY_MAX_SHOTS];
+} replay_game_t;
+
+typedef struct {
+    FILE* f;
+    replay_header_t header;
+    uint32_t used;          // Bytes in the buffer so far
+    uint32_t games;         // Games in the buffer so far
+    bool ok;                // Every write so far worked
+    uint8_t buffer[REPLAY_BLOCK];
+} replay_writer_t;
+
+typedef struct {
+    bs_map_t map;
+    const uint8_t* start;   // The first block
+    const uint8_t* end;
+    uint64_t seed;
+    uint64_t games;         // From the header (0 if it was never finished)
+} replay_t;
+
+/// @brief Where a reader's up to
+typedef struct {
+    const uint8_t* block;   // The next block
+    const uint8_t* end;     // Where to stop (the end of the file, or of this thread's share)
+    const uint8_t* next;    // The next game in this block
+    uint32_t left;          // Games left in this block
+} replay_cursor_t;
+
+// Recording
+void bs_replay_begin(replay_game_t* game, const board_t* board);
+void bs_replay_fleet(replay_game_t* game, uint8_t side, const item_t items[5]);
+
+/// @brief Records a shot
+/// @param game The game
+/// @param side Which side it was fired at (0 = `a`, 1 = `b`)
+/// @param cell The cell
+static inline void bs_replay_shot(replay_game_t* game, uint8_t side, uint8_t cell) {
+    if(game->count < REPLAY_MAX_SHOTS) game->shots[game->count++] = cell | (side ? REPLAY_SIDE_B : 0);
+}
+
+// Writing
+bool bs_replay_create(replay_writer_t* writer, const char* path, uint64_t seed);
+bool bs_replay_append(replay_writer_t* writer, const replay_game_t* game);
+bool bs_replay_finish(replay_writer_t* writer);
+
+// Reading
+bool bs_replay_open(replay_t* replay, const char* path);
+void bs_replay_close(replay_t* replay);
+void bs_replay_cursor(const replay_t* replay, replay_cursor_t* cursor);
+uint64_t bs_replay_blocks(const replay_t* replay, const uint8_t** starts, uint64_t max);
+void bs_replay_range(const replay_t* replay, replay_cursor_t* cursor, const uint8_t* from, const uint8_t* to);
+const replay_game_t* bs_replay_next(replay_cursor_t* cursor);
+bool bs_replay_board(const replay_game_t* game, board_t* board);
+
+#endif
@@ -0,0 +1,96 @@
+/*
+    BSBOT made by William Dawson (MrBisquit on GitHub)
+    https://wtdawson.info
+
+    --------------------------------------------------------------------------------------------
+
+    bsbot_replay
+
+    Reads a replay log (see replay.h) and says what's in it. With --verify every game is also
+    played back onto a board, to check the fleets fit, no cell's shot twice and the winner
+    really did sink everything.
+
+    Usage: bsbot_replay FILE [--verify]
+
+    --------------------------------------------------------------------------------------------
+
+ *  License:    SPDX-License-Identifier: MIT
+ *              See LICENSE file in the project root for full license text.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "replay.h"
+
+static void bs_replayer_usage(void) {
+    printf("Usage: bsbot_replay FILE [--verify]\n");
+    printf("  --verify      Play every game back onto a board and check it\n");
+}
+
+/// @brief The main function
+/// @param argc Args count
+/// @param argv Args
+/// @return Return code (0 = Success, 1 = bad arguments or couldn't read the log, 2 = a game didn't check out)
+int main(int argc, char* argv[]) {
+    const char* path = NULL;
+    bool verify = false;
+
+    for(int i = 1; i < argc; i++) {
+        if(strcmp(argv[i], "--help") == 0 || strcmp(argv[i], "-h") == 0) {
+            bs_replayer_usage();
+            return 0;
+        }
+        if(strcmp(argv[i], "--verify") == 0) verify = true;
+        else if(path == NULL) path = argv[i];
+        else {
+            bs_replayer_usage();
+            return 1;
+        }
+    }
+
+    if(path == NULL) {
+        bs_replayer_usage();
+        return 1;
+    }
+
+    replay_t replay;
+    if(!bs_replay_open(&replay, path)) {
+        printf("couldn't open the replay log %s\n", path);
+        return 1;
+    }
+
+    uint64_t games = 0, shots = 0, bad = 0;
+    uint64_t winners[3] = { 0 };
+    board_t board;
+
+    uint64_t start = bs_time_ns();
+    replay_cursor_t cursor;
+    bs_replay_cursor(&replay, &cursor);
+
+    const replay_game_t* game;
+    while((game = bs_replay_next(&cursor)) != NULL) {
+        games++;
+        shots += game->count;
+        if(game->winner <= REPLAY_WINNER_B) winners[game->winner]++;
+
+        if(verify && !bs_replay_board(game, &board)) {
+            if(bad == 0) printf("game %llu doesn't check out\n", (unsigned long long)(games - 1));
+            bad++;
+        }
+    }
+    double seconds = (double)(bs_time_ns() - start) / 1e9;
+    if(seconds <= 0.0) seconds = 1e-9;
+
+    printf("bsbot_replay: %s, seed %llu\n", path, (unsigned long long)replay.seed);
+    printf("games:     %llu (%.1f bytes each)\n", (unsigned long long)games, games ? (double)replay.map.size / (double)games : 0.0);
+    if(replay.games != games) printf("           the header says %llu (it was never finished, or it's been cut short)\n", (unsigned long long)replay.games);
+    printf("shots:     mean %.2f\n", games ? (double)shots / (double)games : 0.0);
+    printf("winners:   a %llu, b %llu, none %llu\n", (unsigned long long)winners[REPLAY_WINNER_A], (unsigned long long)winners[REPLAY_WINNER_B], (unsigned long long)winners[REPLAY_WINNER_NONE]);
+    printf("read:      %.1f games/s, %.1f MB/s\n", (double)games / seconds, ((double)replay.map.size / (1024.0 * 1024.0)) / seconds);
+    if(verify) printf("verified:  %llu bad\n", (unsigned long long)bad);
+
+    bs_replay_close(&replay);
+    return bad > 0 ? 2 : 0;
+}
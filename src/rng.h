@@ -0,0 +1,112 @@
+/*
+    BSBOT made by William Dawson (MrBisquit on GitHub)
+    https://wtdawson.info
+
+    --------------------------------------------------------------------------------------------
+
+    Random numbers
+
+    xoshiro256** (https://prng.di.unimi.it/), seeded through splitmix64. Every user keeps
+    its own `rng_t`, so there's no hidden global state, and the same seed always gives the
+    same numbers.
+
+    To give each thread its own numbers, either seed each one from the seed and its own
+    number (what the simulator does per game, so the thread count doesn't matter), or split
+    them off one generator with `bs_rng_split`, which jumps 2^128 numbers ahead each time, so
+    the streams can never overlap.
+
+    --------------------------------------------------------------------------------------------
+
+ *  License:    SPDX-License-Identifier: MIT
+ *              See LICENSE file in the project root for full license text.
+*/
+
+#ifndef BSBOT_RNG_H
+#define BSBOT_RNG_H
+
+#include <stdint.h>
+
+typedef struct {
+    uint64_t s[4];
+} rng_t;
+
+static inline uint64_t bs_rotl64(uint64_t x, int k) {
+    return (x << k) | (x >> (64 - k));
+}
+
+/// @brief splitmix64, used to spread a seed out into a full state
+static inline uint64_t bs_splitmix64(uint64_t* x) {
+    uint64_t z = (*x += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+/// @brief Seeds a generator
+static inline void bs_rng_seed(rng_t* r, uint64_t seed) {
+    for(int i = 0; i < 4; i++) r->s[i] = bs_splitmix64(&seed);
+}
+
+/// @brief Gets the next 64 random bits
+static inline uint64_t bs_rng_next(rng_t* r) {
+    uint64_t* s = r->s;
+    uint64_t result = bs_rotl64(s[1] * 5, 7) * 9;
+    uint64_t t = s[1] << 17;
+
+    s[2] ^= s[0];
+    s[3] ^= s[1];
+    s[1] ^= s[2];
+    s[0] ^= s[3];
+    s[2] ^= t;
+    s[3] = bs_rotl64(s[3], 45);
+
+    return result;
+}
+
+/// @brief Gets a number from 0 to n - 1, without the bias `% n` has (Lemire's method)
+static inline uint32_t bs_rng_below(rng_t* r, uint32_t n) {
+    uint64_t m = (uint64_t)(uint32_t)bs_rng_next(r) * n;
+    uint32_t low = (uint32_t)m;
+
+    if(low < n) {
+        uint32_t threshold = (uint32_t)(-n) % n;
+        while(low < threshold) {
+            m = (uint64_t)(uint32_t)bs_rng_next(r) * n;
+            low = (uint32_t)m;
+        }
+    }
+
+    return (uint32_t)(m >> 32);
+}
+
+/// @brief Gets a number from `from` to `to` - 1 (unbiased, like `bs_rng_below`)
+static inline int32_t bs_rng_range(rng_t* r, int32_t from, int32_t to) {
+    if(to <= from) return from;
+    return from + (int32_t)bs_rng_below(r, (uint32_t)(to - from));
+}
+
+/// @brief Jumps 2^128 numbers ahead (as if `bs_rng_next` had been called that many times)
+static inline void bs_rng_jump(rng_t* r) {
+    static const uint64_t jump[4] = { 0x180EC6D33CFD0ABAULL, 0xD5A61266F0C9392CULL, 0xA9582618E03FC9AAULL, 0x39ABDC4529B1661CULL };
+    uint64_t s[4] = { 0, 0, 0, 0 };
+
+    for(int i = 0; i < 4; i++) {
+        for(int b = 0; b < 64; b++) {
+            if(jump[i] & (1ULL << b)) {
+                for(int j = 0; j < 4; j++) s[j] ^= r->s[j];
+            }
+            bs_rng_next(r);
+        }
+    }
+
+    for(int j = 0; j < 4; j++) r->s[j] = s[j];
+}
+
+/// @brief Splits a new stream off a generator (the child gets the current stream, and the
+/// parent jumps past it), so however many threads get one, none of them overlap
+static inline void bs_rng_split(rng_t* parent, rng_t* child) {
+    *child = *parent;
+    bs_rng_jump(parent);
+}
+
+#endif
@@ -0,0 +1,209 @@
+/*
+    BSBOT made by William Dawson (MrBisquit on GitHub)
+    https://wtdawson.info
+
+    --------------------------------------------------------------------------------------------
+
+    Lookahead search (See search.h)
+
+    --------------------------------------------------------------------------------------------
+
+ *  License:    SPDX-License-Identifier: MIT
+ *              See LICENSE file in the project root for full license text.
+*/
+
+#include <string.h>
+#include "search.h"
+#include "placement.h"
+#include "density.h"
+#include "platform.h"
+
+typedef struct {
+    const knowledge_t* k;
+    search_limits_t limits;
+    uint64_t deadline;          // 0 = no time limit
+    uint64_t nodes;
+    bool stopped;               // Ran out part way through, so nothing from this depth can be used
+    uint8_t groups;             // Ships afloat, grouped by length (the same length has the same placements)
+    uint8_t ship[FLEET_SIZE];   // One ship from each group
+    uint8_t count[FLEET_SIZE];  // How many ships are in each group
+} search_t;
+
+/// @brief Works out the chance of a hit on each cell, with these hits and misses on top of what's known
+static void bs_search_chances(const search_t* s, bb_t hits, bb_t misses, float p[BB_CELLS]) {
+    bb_t blocked = bs_bb_or(misses, s->k->sunk);
+    bb_t shot = bs_bb_or(blocked, hits);
+
+    // The chance of nothing being there, ship by ship
+    float empty[BB_CELLS];
+    for(uint8_t c = 0; c < BB_CELLS; c++) empty[c] = 1.0f;
+
+    for(uint8_t g = 0; g < s->groups; g++) {
+        const ship_placements_t* table = &bs_ship_placements[s->ship[g]];
+        uint8_t length = bs_fleet_lengths[s->ship[g]];
+        uint32_t counts[BB_CELLS];
+        uint64_t total = 0;
+        memset(counts, 0, sizeof(counts));
+
+        for(uint8_t i = 0; i < table->count; i++) {
+            bb_t mask = table->list[i].mask;
+            if(bs_bb_intersects(mask, blocked)) continue;
+
+            uint8_t covered = (uint8_t)bs_bb_popcount(bs_bb_and(mask, hits));
+            if(covered >= length) continue; // It'd have been sunk
+
+            uint32_t weight = bs_density_weights[covered];
+            total += weight;
+            while(!bs_bb_is_empty(mask)) counts[bs_bb_pop_lsb(&mask)] += weight;
+        }
+        if(total == 0) continue;
+
+        float scale = 1.0f / (float)total;
+        for(uint8_t c = 0; c < BB_CELLS; c++) {
+            if(counts[c] == 0) continue;
+
+            float f = 1.0f - ((float)counts[c] * scale);
+            for(uint8_t n = 0; n < s->count[g]; n++) empty[c] *= f;
+        }
+    }
+
+    for(uint8_t c = 0; c < BB_CELLS; c++) p[c] = bs_bb_test(shot, c) ? 0.0f : 1.0f - empty[c];
+}
+
+/// @brief Finds the most likely cells, best first (ties go to the lowest cell)
+/// @return How many it found (only cells with some chance count)
+static uint8_t bs_search_top(const float p[BB_CELLS], uint8_t width, uint8_t best[SEARCH_MAX_WIDTH]) {
+    uint8_t found = 0;
+
+    for(uint8_t c = 0; c < BB_CELLS; c++) {
+        if(p[c] <= 0.0f) continue;
+        if(found == width && p[c] <= p[best[found - 1]]) continue;
+
+        uint8_t i = found < width ? found++ : width - 1;
+        while(i > 0 && p[best[i - 1]] < p[c]) {
+            best[i] = best[i - 1];
+            i--;
+        }
+        best[i] = c;
+    }
+
+    return found;
+}
+
+/// @brief Gets whether the budget's run out (and remembers it if it has)
+static inline bool bs_search_stop(search_t* s) {
+    if(s->stopped) return true;
+    if(s->limits.max_nodes != 0 && s->nodes >= s->limits.max_nodes) s->stopped = true;
+    else if(s->deadline != 0 && bs_time_ns() >= s->deadline) s->stopped = true;
+    else if(s->limits.cancel != NULL && bs_atomic_load32(s->limits.cancel)) s->stopped = true;
+    return s->stopped;
+}
+
+/// @brief How many hits the best shots from here are expected to get
+/// @param depth Shots to look ahead (at least 1)
+static float bs_search_value(search_t* s, bb_t hits, bb_t misses, uint8_t depth) {
+    if(bs_search_stop(s)) return 0.0f;
+    s->nodes++;
+
+    float p[BB_CELLS];
+    uint8_t best[SEARCH_MAX_WIDTH];
+    bs_search_chances(s, hits, misses, p);
+
+    // The last shot is only worth whatever's most likely
+    uint8_t found = bs_search_top(p, depth == 1 ? 1 : s->limits.width, best);
+    if(found == 0) return 0.0f;
+    if(depth == 1) return p[best[0]];
+
+    float most = 0.0f;
+    for(uint8_t i = 0; i < found; i++) {
+        uint8_t c = best[i];
+        float hit = bs_search_value(s, bs_bb_or(hits, bs_bb_cell(c)), misses, depth - 1);
+        float miss = bs_search_value(s, hits, bs_bb_or(misses, bs_bb_cell(c)), depth - 1);
+        if(s->stopped) return 0.0f;
+
+        float value = (p[c] * (1.0f + hit)) + ((1.0f - p[c]) * miss);
+        if(value > most) most = value;
+    }
+
+    return most;
+}
+
+/// @brief Searches for the best shot
+/// @param k What's known
+/// @param limits When to stop (the first shot ahead is always finished, whatever the budget)
+/// @param out Filled in with the move and how far it got
+/// @param probabilities Filled in with the chance of a hit on each cell right now (NULL if it's not wanted)
+/// @return Returns `false` if there's nowhere left to shoot
+bool bs_search_run(const knowledge_t* k, const search_limits_t* limits, search_result_t* out, float probabilities[BB_CELLS]) {
+    uint64_t start = bs_time_ns();
+    bs_placement_init();
+
+    search_t s;
+    memset(&s, 0, sizeof(s));
+    s.k = k;
+    s.limits = *limits;
+    if(s.limits.width == 0 || s.limits.width > SEARCH_MAX_WIDTH) s.limits.width = SEARCH_MAX_WIDTH;
+    if(s.limits.max_depth == 0 || s.limits.max_depth > SEARCH_MAX_DEPTH) s.limits.max_depth = SEARCH_MAX_DEPTH;
+    s.deadline = limits->max_time_ns != 0 ? start + limits->max_time_ns : 0;
+
+    for(uint8_t ship = 0; ship < FLEET_SIZE; ship++) {
+        if(!(k->afloat & (1 << ship))) continue;
+
+        uint8_t g = 0;
+        while(g < s.groups && bs_fleet_lengths[s.ship[g]] != bs_fleet_lengths[ship]) g++;
+        if(g == s.groups) s.ship[s.groups++] = ship;
+        s.count[g]++;
+    }
+
+    memset(out, 0, sizeof(search_result_t));
+    out->move = BB_CELLS;
+
+    float p[BB_CELLS];
+    uint8_t order[SEARCH_MAX_WIDTH];
+    bs_search_chances(&s, k->hits, k->misses, p);
+    s.nodes = 1;
+    if(probabilities != NULL) memcpy(probabilities, p, sizeof(p));
+
+    uint8_t found = bs_search_top(p, s.limits.width, order);
+    if(found == 0) {
+        // Nothing fits what's known (so it's been lied to), anywhere that's left will do
+        bb_t left = bs_bb_andnot(bs_bb_full(), bs_bb_or(bs_bb_or(k->hits, k->misses), k->sunk));
+        out->time_ns = bs_time_ns() - start;
+        if(bs_bb_is_empty(left)) return false;
+
+        out->move = bs_bb_lsb(left);
+        out->nodes = s.nodes;
+        return true;
+    }
+
+    // One shot ahead is just the most likely cell
+    out->move = order[0];
+    out->depth = 1;
+    out->value = p[order[0]];
+
+    for(uint8_t depth = 2; depth <= s.limits.max_depth; depth++) {
+        uint8_t best = 0;
+        float most = -1.0f;
+
+        for(uint8_t i = 0; i < found && !s.stopped; i++) {
+            uint8_t c = order[i];
+            float hit = bs_search_value(&s, bs_bb_or(k->hits, bs_bb_cell(c)), k->misses, depth - 1);
+            float miss = bs_search_value(&s, k->hits, bs_bb_or(k->misses, bs_bb_cell(c)), depth - 1);
+
+            float value = (p[c] * (1.0f + hit)) + ((1.0f - p[c]) * miss);
+            if(value > most) {
+                most = value;
+                best = i;
+            }
+        }
+        if(s.stopped) break;
+
+        out->move = order[best];
+        out->depth = depth;
+        out->value = most;
+    }
+
+    out->nodes = s.nodes;
+    out->time_ns = bs_time_ns() - start;
+    return true;
+}
@@ -0,0 +1,58 @@
+/*
+    BSBOT made by William Dawson (MrBisquit on GitHub)
+    https://wtdawson.info
+
+    --------------------------------------------------------------------------------------------
+
+    Lookahead search
+
+    The other engines pick whichever cell is most likely to be a hit right now. This looks a
+    few shots ahead instead: for each of the best few cells it tries both a hit and a miss,
+    weighted by how likely each is, and picks the one that's expected to get the most hits
+    over the next few shots (a shot that barely loses out now can set up better ones later).
+
+    Each position's chances come from counting placements of each ship still afloat (like
+    the density mode, but per ship so they're proper chances). Ships are treated as if they
+    don't get in each other's way, which keeps a position down to a few microseconds.
+
+    It's iterative deepening: one shot ahead, then two, and so on, until the time or node
+    budget runs out, and the move from the deepest search that finished is the one that's
+    used. So any budget gets a move, and a bigger one just gets a better one.
+
+    --------------------------------------------------------------------------------------------
+
+ *  License:    SPDX-License-Identifier: MIT
+ *              See LICENSE file in the project root for full license text.
+*/
+
+#ifndef BSBOT_SEARCH_H
+#define BSBOT_SEARCH_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "bitboard.h"
+#include "knowledge.h"
+
+#define SEARCH_MAX_DEPTH    8
+#define SEARCH_MAX_WIDTH    8
+
+/// @brief When to stop searching. Whichever is reached first wins, 0 means "don't use this one"
+typedef struct {
+    uint64_t max_time_ns;   // Stop after this long (the result won't be reproducible then)
+    uint64_t max_nodes;     // Stop after looking at this many positions
+    uint8_t max_depth;      // Shots to look ahead (1 to SEARCH_MAX_DEPTH, 1 = just the most likely cell)
+    uint8_t width;          // Cells tried at each position (1 to SEARCH_MAX_WIDTH)
+    volatile int32_t* cancel; // Stop as soon as this is set, from any thread (NULL = never)
+} search_limits_t;
+
+typedef struct {
+    uint8_t move;           // The best cell (`BB_CELLS` if there's nowhere left)
+    uint8_t depth;          // Deepest search that finished
+    float value;            // Hits it expects over the next `depth` shots
+    uint64_t nodes;         // Positions looked at (including any from a search that didn't finish)
+    uint64_t time_ns;       // How long it took
+} search_result_t;
+
+bool bs_search_run(const knowledge_t* k, const search_limits_t* limits, search_result_t* out, float probabilities[BB_CELLS]);
+
+#endif
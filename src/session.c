@@ -0,0 +1,201 @@
+/*
+    BSBOT made by William Dawson (MrBisquit on GitHub)
+    https://wtdawson.info
+
+    --------------------------------------------------------------------------------------------
+
+    Sessions (See session.h)
+
+    --------------------------------------------------------------------------------------------
+
+ *  License:    SPDX-License-Identifier: MIT
+ *              See LICENSE file in the project root for full license text.
+*/
+
+#include <stdlib.h>
+#include <string.h>
+#include "session.h"
+
+/// @brief Allocates every session up front
+/// @param pool The pool
+/// @param capacity How many sessions can be open at once
+/// @return Returns `true` if it could allocate them
+bool bs_session_pool_init(session_pool_t* pool, uint32_t capacity) {
+    memset(pool, 0, sizeof(session_pool_t));
+    if(capacity == 0) return false;
+
+    pool->sessions = calloc(capacity, sizeof(session_t));
+    pool->free = calloc(capacity, sizeof(uint32_t));
+    if(pool->sessions == NULL || pool->free == NULL) {
+        bs_session_pool_destroy(pool);
+        return false;
+    }
+
+    // Hand out the lowest slots first
+    for(uint32_t i = 0; i < capacity; i++) pool->free[i] = capacity - 1 - i;
+    pool->free_count = capacity;
+    pool->capacity = capacity;
+
+    bs_placement_init(); // Not thread-safe, so before anything gets stepped on another thread
+    return true;
+}
+
+/// @brief Frees every session (any still open are gone too)
+/// @param pool The pool
+void bs_session_pool_destroy(session_pool_t* pool) {
+    free(pool->sessions);
+    free(pool->free);
+    memset(pool, 0, sizeof(session_pool_t));
+}
+
+/// @brief Starts a new game, with the bot's ships already placed
+/// @param pool The pool
+/// @param seed The seed (the same seed and the same moves always play out the same)
+/// @return The session, or NULL if every session's in use
+session_t* bs_session_open(session_pool_t* pool, uint64_t seed) {
+    if(pool->free_count == 0) return NULL;
+
+    uint32_t id = pool->free[--pool->free_count];
+    session_t* session = &pool->sessions[id];
+
+    session->state = SESSION_SETUP;
+    session->winner = SESSION_WINNER_NONE;
+    bs_new_board_ptr(&session->board);
+    bs_bot_init(&session->bot);
+    bs_bot_seed(&session->bot, seed);
+    bs_rng_seed(&session->rng, seed);
+    bs_rng_jump(&session->rng); // Keep it well away from anything else seeded with the same number
+
+    memset(&session->setup, 0, sizeof(session_setup_t));
+    memset(&session->replay, 0, REPLAY_GAME_SIZE);
+    session->shots[0] = 0;
+    session->shots[1] = 0;
+    session->last_shot = BB_CELLS;
+    session->last_result = PLACE_HIT_INVALID;
+    session->id = id;
+
+    bs_random_fleet(&session->board.b, session->board.b_items, NULL, &session->rng);
+    return session;
+}
+
+/// @brief Ends a game, and gives its slot back to the pool
+/// @param pool The pool it came from
+/// @param session The session
+void bs_session_close(session_pool_t* pool, session_t* session) {
+    if(session == NULL || pool->free_count >= pool->capacity) return;
+    pool->free[pool->free_count++] = session->id;
+}
+
+/// @brief Places one of the player's ships
+/// @param session The session
+/// @param item The ship (`relative_pos` is the first cell it takes up)
+/// @return Returns `true` if it was placed (it has to fit, and that ship can't already be placed)
+bool bs_session_place(session_t* session, item_t item) {
+    if(session->state != SESSION_SETUP) return false;
+    if(item.type < PLACE_AC || item.type > PLACE_PB) return false;
+    if(!bs_bb_is_empty(session->board.a.places[item.type - 1])) return false;
+
+    if(!bs_place_item(&session->board.a, item)) return false;
+    return bs_add_item(session->board.a_items, item);
+}
+
+/// @brief Places all of the player's ships at random (anything already placed is cleared)
+/// @param session The session
+/// @param gen The rules to place them by (NULL = none)
+/// @return Returns `false` if the rules couldn't be met
+bool bs_session_place_random(session_t* session, const fleet_gen_t* gen) {
+    if(session->state != SESSION_SETUP) return false;
+    return bs_random_fleet(&session->board.a, session->board.a_items, gen, &session->rng);
+}
+
+/// @brief Moves the bot's ships (they start off random)
+/// @param session The session
+/// @param picks Each ship's placement (see placement.h, they have to fit together)
+/// @return Returns `false` if it's too late to move them
+bool bs_session_place_bot(session_t* session, const uint8_t picks[FLEET_SIZE]) {
+    if(session->state != SESSION_SETUP) return false;
+
+    bs_place_fleet(&session->board.b, session->board.b_items, picks);
+    return true;
+}
+
+/// @brief Starts shooting (the player goes first)
+/// @param session The session
+/// @return Returns `false` if the player hasn't placed every ship yet
+bool bs_session_start(session_t* session) {
+    if(session->state != SESSION_SETUP) return false;
+
+    for(uint8_t i = 0; i < FLEET_SIZE; i++) {
+        if(bs_bb_is_empty(session->board.a.places[i])) return false;
+    }
+
+    bs_replay_begin(&session->replay, &session->board);
+    session->state = SESSION_PLAYER_TURN;
+    return true;
+}
+
+/// @brief The player shoots at the bot
+/// @param session The session
+/// @param cell The cell
+/// @return The result from `bs_fire` (`PLACE_HIT_INVALID` if it isn't their turn or it's already been shot, and it's still their turn)
+uint8_t bs_session_fire(session_t* session, uint8_t cell) {
+    if(session->state != SESSION_PLAYER_TURN) return PLACE_HIT_INVALID;
+
+    uint8_t result = bs_fire(&session->board.b, cell);
+    if(result == PLACE_HIT_INVALID) return result;
+
+    session->shots[0]++;
+    bs_replay_shot(&session->replay, 1, cell);
+    bs_bot_observe_opponent(&session->bot, cell, result);
+
+    if(session->board.b.sunk == FLEET_ALL) {
+        session->state = SESSION_OVER;
+        session->winner = SESSION_WINNER_PLAYER;
+        session->replay.winner = REPLAY_WINNER_A;
+    } else {
+        session->state = SESSION_BOT_TURN;
+    }
+
+    return result;
+}
+
+/// @brief The bot thinks, then takes its shot
+/// @param session The session
+/// @return The cell it shot (`BB_CELLS` if it isn't its turn)
+uint8_t bs_session_bot_turn(session_t* session) {
+    if(session->state != SESSION_BOT_TURN) return BB_CELLS;
+
+    knowledge_t k = bs_side_knowledge(&session->board.a);
+    bs_bot_think(&session->bot, &k);
+    return bs_session_bot_move(session);
+}
+
+/// @brief The bot takes its shot, going by whatever it last thought (for when it's thought somewhere else, see thinker.h)
+/// @param session The session
+/// @return The cell it shot (`BB_CELLS` if it isn't its turn)
+uint8_t bs_session_bot_move(session_t* session) {
+    if(session->state != SESSION_BOT_TURN) return BB_CELLS;
+
+    side_t* target = &session->board.a;
+    uint8_t cell = bs_bot_pick(&session->bot, bs_bb_or(target->hitmap, target->missmap));
+    uint8_t result = bs_fire(target, cell);
+
+    bb_t sunk = bs_bb_empty();
+    if(result != PLACE_HIT_INVALID && (result & HIT_SUNK)) sunk = target->places[(result & ~HIT_SUNK) - 1];
+    bs_bot_observe(&session->bot, cell, result, sunk);
+
+    session->shots[1]++;
+    if(result != PLACE_HIT_INVALID) bs_replay_shot(&session->replay, 0, cell);
+    session->last_shot = cell;
+    session->last_result = result;
+
+    if(target->sunk == FLEET_ALL) {
+        session->state = SESSION_OVER;
+        session->winner = SESSION_WINNER_BOT;
+        session->replay.winner = REPLAY_WINNER_B;
+    } else {
+        session->state = SESSION_PLAYER_TURN;
+    }
+
+    return cell;
+}
@@ -0,0 +1,90 @@
+/*
+    BSBOT made by William Dawson (MrBisquit on GitHub)
+    https://wtdawson.info
+
+    --------------------------------------------------------------------------------------------
+
+    Sessions
+
+    One game against the bot: the board, the bot, where it's up to, and its own random numbers.
+    Nothing's global, so one process can run as many as it likes, each stepped on its own.
+
+    Every session records itself as it goes (see replay.h), so a finished game can be added
+    to a log straight from `session->replay`.
+
+    Sessions come out of a `session_pool_t`, which allocates all of them up front, so opening,
+    playing and closing a game never touches malloc, and the memory used is known from the
+    start (`capacity * sizeof(session_t)`). A session is only touched by whoever's stepping it,
+    so different sessions can be stepped on different threads, but opening and closing have to
+    be done from one thread at a time.
+
+    --------------------------------------------------------------------------------------------
+
+ *  License:    SPDX-License-Identifier: MIT
+ *              See LICENSE file in the project root for full license text.
+*/
+
+#ifndef BSBOT_SESSION_H
+#define BSBOT_SESSION_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "game.h"
+#include "replay.h"
+
+typedef enum {
+    SESSION_SETUP,          // The player's placing their ships
+    SESSION_PLAYER_TURN,
+    SESSION_BOT_TURN,
+    SESSION_OVER
+} session_state_t;
+
+typedef enum {
+    SESSION_WINNER_NONE,
+    SESSION_WINNER_PLAYER,
+    SESSION_WINNER_BOT
+} session_winner_t;
+
+/// @brief Where the player's up to placing their ships (so a window doesn't have to keep it)
+typedef struct {
+    uint8_t selected;       // PLACE_x being placed (0 = none)
+    uint8_t rotation;       // 0 = Horizontal, 1 = Vertical
+    item_t item;            // What's being dragged around
+} session_setup_t;
+
+typedef struct {
+    session_state_t state;
+    session_winner_t winner;
+    board_t board;          // `a` is the player, `b` is the bot
+    bot_t bot;
+    rng_t rng;              // For anything random the session does itself (the bot has its own)
+    session_setup_t setup;
+    uint8_t shots[2];       // Shots fired by the player and by the bot
+    uint8_t last_shot;      // The bot's last shot (`BB_CELLS` = none yet)
+    uint8_t last_result;    // What it did (from `bs_fire`)
+    replay_game_t replay;   // The game so far (starts when the shooting does), ready for `bs_replay_append`
+    uint32_t id;            // Its slot in the pool
+} session_t;
+
+typedef struct {
+    session_t* sessions;
+    uint32_t* free;         // Slots that aren't in use (a stack)
+    uint32_t free_count;
+    uint32_t capacity;
+} session_pool_t;
+
+bool bs_session_pool_init(session_pool_t* pool, uint32_t capacity);
+void bs_session_pool_destroy(session_pool_t* pool);
+
+session_t* bs_session_open(session_pool_t* pool, uint64_t seed);
+void bs_session_close(session_pool_t* pool, session_t* session);
+
+bool bs_session_place(session_t* session, item_t item);
+bool bs_session_place_random(session_t* session, const fleet_gen_t* gen);
+bool bs_session_place_bot(session_t* session, const uint8_t picks[FLEET_SIZE]);
+bool bs_session_start(session_t* session);
+uint8_t bs_session_fire(session_t* session, uint8_t cell);
+uint8_t bs_session_bot_turn(session_t* session);
+uint8_t bs_session_bot_move(session_t* session);
+
+#endif
@@ -0,0 +1,565 @@
+/*
+    BSBOT made by William Dawson (MrBisquit on GitHub)
+    https://wtdawson.info
+
+    --------------------------------------------------------------------------------------------
+
+    bsbot_sim
+
+    Plays the bot against random fleets as fast as it can, without a window, and reports how
+    many shots it took to win. Games are spread across every core, and every game is seeded
+    from the seed and its own number, so the same options always give the same numbers no
+    matter how many threads there are.
+
+    With --lockstep (density only) each thread plays a batch of games at once, one per SIMD
+    lane (see batch.h). It takes the same shots, so the numbers come out the same, just faster.
+
+    With --record every game is written to a replay log (see replay.h), in whatever order the
+    threads finish them (the bot's fleet is `a`, and every shot is at it).
+
+    With --prior the bot starts from a prior file (see prior.h), which is how to check whether
+    one learned from real players helps against fleets placed like theirs.
+
+    With --size or --ships the games are on a different board, or with a different fleet (see
+    grid.h). Those are always played with the density mode, on the slower general code, so
+    it's for seeing how the bot scales rather than how well it plays the real game.
+
+    With --defend the fleets are placed by the optimiser the game uses for the bot's own ships
+    (see defense.h), against that model of how the opponent shoots, so it's the bot playing
+    against itself. It's a fixed number of tries per fleet rather than a time limit, so the
+    numbers still come out the same every time.
+
+    Usage: bsbot_sim [--games N] [--seed N] [--threads N] [--mode heuristic|exact|mc|density|lookahead] [--samples N] [--depth N] [--cache MB] [--book FILE] [--lockstep] [--no-touch] [--edge-bias F] [--record FILE] [--prior FILE] [--size WxH] [--ships L,L,...] [--defend uniform|parity|density]
+
+    --------------------------------------------------------------------------------------------
+
+ *  License:    SPDX-License-Identifier: MIT
+ *              See LICENSE file in the project root for full license text.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "game.h"
+#include "batch.h"
+#include "enumerate.h"
+#include "pool.h"
+#include "replay.h"
+#include "prior.h"
+#include "grid.h"
+#include "defense.h"
+
+#define SIM_MAX_SHOTS GRID_MAX_CELLS // Biggest board there can be
+#define SIM_BATCH 64 // Games each thread plays at once with --lockstep
+#define SIM_DEFEND 20000 // Layouts the optimiser tries for each fleet with --defend
+
+/// @brief One worker's results, padded so workers don't share cache lines
+typedef struct {
+    uint64_t histogram[SIM_MAX_SHOTS + 1]; // How many games were won in this many shots
+    uint64_t games;
+    uint64_t unplaced; // Games that never started, because the fleet couldn't be placed
+    uint8_t padding[64];
+} sim_stats_t;
+
+typedef struct {
+    uint64_t seed;
+    uint64_t games;
+    uint64_t per_task;
+    bot_mode_t mode;
+    uint64_t samples;
+    uint8_t depth;
+    sim_stats_t* stats;
+    cache_t* caches;    // One per worker (NULL = no caching)
+    const book_t* book; // Shared, it's only read (NULL = none)
+    const prior_weights_t* prior; // Shared too (NULL = none)
+    bool lockstep;      // Play the games in batches (density only)
+    const fleet_gen_t* fleet; // How the fleets are placed (NULL = every legal layout equally likely)
+    const grid_rules_t* grid; // A different board or fleet (NULL = the standard game)
+    const defense_model_t* defend; // Fleets are placed by the optimiser against this (NULL = they're random)
+    replay_writer_t* record;  // Where every game goes (NULL = nowhere)
+    bs_mutex_t record_lock;
+} sim_ctx_t;
+
+/// @brief Sets up a game's fleet
+static void bs_sim_fleet(const sim_ctx_t* ctx, uint64_t game, side_t* target, item_t items[5]) {
+    rng_t rng;
+    uint64_t seed = ctx->seed ^ ((game + 1) * 0x9E3779B97F4A7C15ULL);
+    if(ctx->defend != NULL) {
+        // Only this thread, every game's already got one
+        defense_limits_t limits = { .iterations = SIM_DEFEND, .seed = seed };
+        defense_result_t placed;
+        if(bs_defense_run(NULL, ctx->defend, &limits, &placed)) {
+            bs_place_fleet(target, items, placed.picks);
+            return;
+        }
+    }
+
+    bs_rng_seed(&rng, seed);
+    bs_random_fleet(target, items, ctx->fleet, &rng);
+}
+
+/// @brief Plays one game
+/// @return How many shots it took to sink everything
+static uint8_t bs_sim_game(sim_ctx_t* ctx, uint64_t game, cache_t* cache) {
+    side_t target;
+    item_t items[5];
+    bot_t bot;
+    replay_game_t replay;
+
+    bs_sim_fleet(ctx, game, &target, ctx->record != NULL ? items : NULL);
+
+    bs_bot_init(&bot);
+    bot.mode = ctx->mode;
+    bot.randomness = false;
+    bot.sampling.max_samples = ctx->samples;
+    bot.sampling.max_time_ns = 0; // Time limits would make it unreproducible
+    bot.sampling.confidence = 0.0f;
+    bot.search.max_time_ns = 0;
+    bot.search.max_depth = ctx->depth;
+    // Every game samples with the same seed, so a cached position comes out the same as
+    // working it out again would (otherwise which thread ran what would change the results)
+    bs_bot_seed(&bot, ctx->seed);
+    bot.cache = cache;
+    bot.book = ctx->book;
+    if(ctx->prior != NULL) bs_bot_prior(&bot, ctx->prior);
+
+    uint8_t shots = 0;
+    while(target.sunk != FLEET_ALL && shots < BB_CELLS) {
+        knowledge_t k = bs_side_knowledge(&target);
+        bs_bot_think(&bot, &k);
+
+        uint8_t cell = bs_bot_pick(&bot, bs_bb_or(target.hitmap, target.missmap));
+        if(cell >= BB_CELLS) break;
+
+        uint8_t result = bs_fire(&target, cell);
+        bb_t sunk = bs_bb_empty();
+        if(result != PLACE_HIT_INVALID && (result & HIT_SUNK)) sunk = target.places[(result & ~HIT_SUNK) - 1];
+
+        bs_bot_observe(&bot, cell, result, sunk);
+        replay.shots[shots++] = cell;
+    }
+
+    if(ctx->record != NULL) {
+        bs_replay_fleet(&replay, 0, items);
+        bs_replay_fleet(&replay, 1, NULL);
+        replay.winner = target.sunk == FLEET_ALL ? REPLAY_WINNER_B : REPLAY_WINNER_NONE;
+        replay.count = shots;
+
+        bs_mutex_lock(&ctx->record_lock);
+        bs_replay_append(ctx->record, &replay);
+        bs_mutex_unlock(&ctx->record_lock);
+    }
+
+    return shots;
+}
+
+/// @brief Plays one game on a different board or with a different fleet
+/// @param shots Set to how many shots it took to sink everything
+/// @return Returns `false` if the fleet couldn't be placed (so there wasn't a game)
+static bool bs_sim_grid_game(const sim_ctx_t* ctx, uint64_t game, uint32_t* shots) {
+    const grid_rules_t* rules = ctx->grid;
+    rng_t rng;
+    bs_rng_seed(&rng, ctx->seed ^ ((game + 1) * 0x9E3779B97F4A7C15ULL));
+
+    grid_side_t target;
+    grid_bot_t bot;
+    if(!bs_grid_random_fleet(&target, rules, &rng)) return false;
+    bs_grid_bot_init(&bot, rules);
+
+    uint32_t all = (uint32_t)((1ULL << rules->count) - 1);
+    *shots = 0;
+    while(target.sunk != all && *shots < rules->cells) {
+        uint16_t cell = bs_grid_bot_pick(&bot);
+        if(cell >= rules->cells) break;
+
+        uint8_t result = bs_grid_fire(&target, cell);
+        grid_bits_t sunk;
+        if(result != PLACE_HIT_INVALID && (result & HIT_SUNK)) bs_grid_ship(&target, (result & ~HIT_SUNK) - 1, &sunk);
+
+        bs_grid_bot_observe(&bot, cell, result, &sunk);
+        (*shots)++;
+    }
+
+    return true;
+}
+
+/// @brief Reads "W", "WxH" or "L,L,..." into a list of numbers
+/// @return How many there were (0 if any of them weren't 1 to 255)
+static uint8_t bs_sim_numbers(const char* value, char separator, uint8_t* out, uint8_t max) {
+    uint8_t count = 0;
+    while(*value != '\0' && count < max) {
+        char* end;
+        unsigned long n = strtoul(value, &end, 10);
+        if(end == value || n == 0 || n > 255) return 0;
+
+        out[count++] = (uint8_t)n;
+        if(*end == '\0') return count;
+        if(*end != separator) return 0;
+        value = end + 1;
+    }
+    return 0;
+}
+
+/// @brief Plays a task's games through a batch, starting the next game as soon as a slot's free
+static void bs_sim_lockstep(const sim_ctx_t* ctx, uint64_t start, uint64_t end, sim_stats_t* stats) {
+    batch_t batch;
+    uint32_t slots = (end - start) < SIM_BATCH ? (uint32_t)(end - start) : SIM_BATCH;
+    if(!bs_batch_init(&batch, slots)) return;
+
+    uint64_t next = start;
+    uint32_t playing = 0;
+    for(;;) {
+        // Fill every empty slot with the next game
+        for(uint32_t slot = 0; slot < slots && next < end; slot++) {
+            if(batch.afloat[slot] != 0) continue;
+
+            side_t target;
+            bs_sim_fleet(ctx, next++, &target, NULL);
+            bs_batch_set(&batch, slot, target.places);
+            playing++;
+        }
+        if(playing == 0) break;
+
+        bs_batch_pick(&batch);
+        playing = bs_batch_fire(&batch);
+
+        // Count the ones that just finished, and clear them so they don't get counted again
+        for(uint32_t slot = 0; slot < slots; slot++) {
+            if(batch.afloat[slot] != 0 || batch.shots[slot] == 0) continue;
+            stats->histogram[batch.shots[slot]]++;
+            stats->games++;
+            batch.shots[slot] = 0;
+        }
+    }
+
+    bs_batch_destroy(&batch);
+}
+
+static void bs_sim_task(void* arg, uint32_t task, uint32_t worker) {
+    sim_ctx_t* ctx = arg;
+    sim_stats_t* stats = &ctx->stats[worker];
+
+    uint64_t start = task * ctx->per_task;
+    uint64_t end = start + ctx->per_task;
+    if(end > ctx->games) end = ctx->games;
+
+    if(ctx->lockstep) {
+        bs_sim_lockstep(ctx, start, end, stats);
+        return;
+    }
+
+    if(ctx->grid != NULL) {
+        for(uint64_t game = start; game < end; game++) {
+            uint32_t shots;
+            if(!bs_sim_grid_game(ctx, game, &shots)) {
+                stats->unplaced++;
+                continue;
+            }
+            stats->histogram[shots]++;
+            stats->games++;
+        }
+        return;
+    }
+
+    for(uint64_t game = start; game < end; game++) {
+        stats->histogram[bs_sim_game(ctx, game, ctx->caches != NULL ? &ctx->caches[worker] : NULL)]++;
+        stats->games++;
+    }
+}
+
+static void bs_sim_usage(void) {
+    printf("Usage: bsbot_sim [--games N] [--seed N] [--threads N] [--mode heuristic|exact|mc|density|lookahead] [--samples N] [--depth N] [--cache MB] [--book FILE] [--lockstep] [--no-touch] [--edge-bias F] [--record FILE] [--prior FILE] [--size WxH] [--ships L,L,...] [--defend uniform|parity|density]\n");
+    printf("  --games N     How many games to play (default 10000)\n");
+    printf("  --seed N      Seed for the fleets and the bot (default 1)\n");
+    printf("  --threads N   How many threads to use (default 0 = one per core)\n");
+    printf("  --mode M      How the bot thinks (default exact)\n");
+    printf("  --samples N   Monte Carlo samples per move (default 16384)\n");
+    printf("  --depth N     Shots the lookahead looks ahead (default 2, there's no time limit here)\n");
+    printf("  --cache MB    Position cache per thread, in megabytes (default 8, 0 = off)\n");
+    printf("  --book FILE   Opening book to play from (see bsbot_book)\n");
+    printf("  --lockstep    Play several games at once with SIMD (density only, no book)\n");
+    printf("  --no-touch    Fleets never have ships next to each other\n");
+    printf("  --edge-bias F How much more likely ships on the edge are (default 0, -1 = never)\n");
+    printf("  --record FILE Write every game to a replay log (not with --lockstep)\n");
+    printf("  --prior FILE  Start the bot from a prior (see bsbot_analyze, not with --lockstep)\n");
+    printf("  --size WxH    Board size, up to 32x32 (default 10x10, \"16\" is 16x16)\n");
+    printf("  --ships L,... Each ship's length, up to 16 ships (default 5,4,3,3,2)\n");
+    printf("  --defend M    Place the fleets with the optimiser, against a uniform, parity or density opponent\n");
+}
+
+/// @brief The main function
+/// @param argc Args count
+/// @param argv Args
+/// @return Return code (0 = Success, 1 = bad arguments)
+int main(int argc, char* argv[]) {
+    sim_ctx_t ctx = {
+        .seed = 1,
+        .games = 10000,
+        .mode = BOT_MODE_EXACT,
+        .samples = 16384,
+        .depth = 2
+    };
+    uint32_t threads = 0;
+    uint64_t cache_mb = 8;
+    const char* book_path = NULL;
+    const char* record_path = NULL;
+    const char* prior_path = NULL;
+    static replay_writer_t record;
+    static prior_t prior;
+    uint8_t size[2] = { BB_SIZE, BB_SIZE };
+    uint8_t lengths[GRID_MAX_SHIPS] = { 5, 4, 3, 3, 2 };
+    uint8_t ships = FLEET_SIZE;
+    static grid_rules_t grid;
+    static book_t book;
+    fleet_rules_t rules = { .no_touch = false, .edge_bias = 0.0f };
+    static fleet_gen_t fleet;
+    static defense_model_t defend;
+
+    for(int i = 1; i < argc; i++) {
+        const char* arg = argv[i];
+        const char* value = (i + 1 < argc) ? argv[i + 1] : NULL;
+
+        if(strcmp(arg, "--help") == 0 || strcmp(arg, "-h") == 0) {
+            bs_sim_usage();
+            return 0;
+        }
+        if(strcmp(arg, "--lockstep") == 0) {
+            ctx.lockstep = true;
+            continue;
+        }
+        if(strcmp(arg, "--no-touch") == 0) {
+            rules.no_touch = true;
+            continue;
+        }
+        if(value == NULL) {
+            bs_sim_usage();
+            return 1;
+        }
+
+        if(strcmp(arg, "--games") == 0) ctx.games = strtoull(value, NULL, 10);
+        else if(strcmp(arg, "--seed") == 0) ctx.seed = strtoull(value, NULL, 10);
+        else if(strcmp(arg, "--threads") == 0) threads = (uint32_t)strtoul(value, NULL, 10);
+        else if(strcmp(arg, "--samples") == 0) ctx.samples = strtoull(value, NULL, 10);
+        else if(strcmp(arg, "--depth") == 0) ctx.depth = (uint8_t)strtoul(value, NULL, 10);
+        else if(strcmp(arg, "--cache") == 0) cache_mb = strtoull(value, NULL, 10);
+        else if(strcmp(arg, "--book") == 0) book_path = value;
+        else if(strcmp(arg, "--record") == 0) record_path = value;
+        else if(strcmp(arg, "--prior") == 0) prior_path = value;
+        else if(strcmp(arg, "--size") == 0) {
+            uint8_t n = bs_sim_numbers(value, 'x', size, 2);
+            if(n == 1) size[1] = size[0];
+            else if(n != 2) {
+                bs_sim_usage();
+                return 1;
+            }
+        } else if(strcmp(arg, "--ships") == 0) {
+            ships = bs_sim_numbers(value, ',', lengths, GRID_MAX_SHIPS);
+            if(ships == 0) {
+                bs_sim_usage();
+                return 1;
+            }
+        }
+        else if(strcmp(arg, "--edge-bias") == 0) rules.edge_bias = strtof(value, NULL);
+        else if(strcmp(arg, "--defend") == 0) {
+            if(strcmp(value, "uniform") == 0) bs_defense_uniform(&defend);
+            else if(strcmp(value, "parity") == 0) bs_defense_parity(&defend);
+            else if(strcmp(value, "density") == 0) bs_defense_density(&defend);
+            else {
+                bs_sim_usage();
+                return 1;
+            }
+            ctx.defend = &defend;
+        }
+        else if(strcmp(arg, "--mode") == 0) {
+            if(strcmp(value, "heuristic") == 0) ctx.mode = BOT_MODE_HEURISTIC;
+            else if(strcmp(value, "exact") == 0) ctx.mode = BOT_MODE_EXACT;
+            else if(strcmp(value, "mc") == 0) ctx.mode = BOT_MODE_MONTE_CARLO;
+            else if(strcmp(value, "density") == 0) ctx.mode = BOT_MODE_DENSITY;
+            else if(strcmp(value, "lookahead") == 0) ctx.mode = BOT_MODE_LOOKAHEAD;
+            else {
+                bs_sim_usage();
+                return 1;
+            }
+        } else {
+            bs_sim_usage();
+            return 1;
+        }
+        i++;
+    }
+
+    if(ctx.games == 0) return 0;
+    if(ctx.lockstep && (ctx.mode != BOT_MODE_DENSITY || book_path != NULL)) {
+        printf("--lockstep only works with --mode density and no book\n");
+        return 1;
+    }
+
+    if(ctx.lockstep && record_path != NULL) {
+        printf("--record doesn't work with --lockstep\n");
+        return 1;
+    }
+
+    if(ctx.lockstep && prior_path != NULL) {
+        printf("--prior doesn't work with --lockstep\n");
+        return 1;
+    }
+
+    if(ctx.defend != NULL && (rules.no_touch || rules.edge_bias != 0.0f)) {
+        printf("--defend doesn't work with --no-touch or --edge-bias\n");
+        return 1;
+    }
+
+    if(!bs_grid_rules(&grid, size[0], size[1], lengths, ships)) {
+        printf("those ships don't fit on a %ux%u board (it can be up to %ux%u, with up to %u ships)\n", size[0], size[1], GRID_MAX, GRID_MAX, GRID_MAX_SHIPS);
+        return 1;
+    }
+
+    // The standard game stays on the fixed-size code, however it was asked for
+    if(!bs_grid_is_standard(&grid)) {
+        if(ctx.lockstep || record_path != NULL || prior_path != NULL || book_path != NULL || rules.no_touch || rules.edge_bias != 0.0f || ctx.defend != NULL) {
+            printf("--size and --ships don't work with --lockstep, --record, --prior, --book, --no-touch, --edge-bias or --defend\n");
+            return 1;
+        }
+        ctx.grid = &grid;
+        ctx.mode = BOT_MODE_DENSITY;
+    }
+
+    if(prior_path != NULL) {
+        if(!bs_prior_open(&prior, prior_path)) {
+            printf("couldn't open the prior %s\n", prior_path);
+            return 1;
+        }
+        ctx.prior = prior.weights;
+    }
+
+    if(record_path != NULL) {
+        if(!bs_replay_create(&record, record_path, ctx.seed)) {
+            printf("couldn't create the replay log %s\n", record_path);
+            return 1;
+        }
+        ctx.record = &record;
+        bs_mutex_init(&ctx.record_lock);
+    }
+
+    if(book_path != NULL) {
+        if(!bs_book_open(&book, book_path)) {
+            printf("couldn't open the book %s\n", book_path);
+            return 1;
+        }
+        ctx.book = &book;
+    }
+
+    bs_enum_init(); // Not thread-safe, so before any threads start
+
+    if(rules.no_touch || rules.edge_bias != 0.0f) {
+        if(!bs_fleet_init(&fleet, &rules)) {
+            printf("no fleet can be placed with those rules\n");
+            return 1;
+        }
+        ctx.fleet = &fleet;
+    }
+
+    static pool_t pool;
+    bs_pool_init(&pool, threads);
+
+    ctx.stats = calloc(pool.workers, sizeof(sim_stats_t));
+    if(ctx.stats == NULL) return 1;
+
+    if(cache_mb > 0 && !ctx.lockstep && ctx.grid == NULL) {
+        ctx.caches = calloc(pool.workers, sizeof(cache_t));
+        if(ctx.caches == NULL) return 1;
+        for(uint32_t w = 0; w < pool.workers; w++) {
+            if(!bs_cache_init(&ctx.caches[w], (size_t)cache_mb << 20)) return 1;
+        }
+    }
+
+    // Enough tasks that stealing can even things out, but not so many they cost anything
+    uint64_t tasks = (uint64_t)pool.workers * 16;
+    ctx.per_task = (ctx.games + tasks - 1) / tasks;
+    tasks = (ctx.games + ctx.per_task - 1) / ctx.per_task;
+
+    uint64_t start = bs_time_ns();
+    bs_pool_run(&pool, bs_sim_task, &ctx, (uint32_t)tasks);
+    double seconds = (double)(bs_time_ns() - start) / 1e9;
+
+    if(ctx.record != NULL) {
+        if(!bs_replay_finish(&record)) printf("couldn't write all of the replay log %s\n", record_path);
+        bs_mutex_destroy(&ctx.record_lock);
+    }
+
+    uint64_t histogram[SIM_MAX_SHOTS + 1] = { 0 };
+    uint64_t games = 0;
+    uint64_t unplaced = 0;
+    uint64_t total = 0;
+    for(uint32_t w = 0; w < pool.workers; w++) {
+        games += ctx.stats[w].games;
+        unplaced += ctx.stats[w].unplaced;
+        for(uint32_t s = 0; s <= SIM_MAX_SHOTS; s++) {
+            histogram[s] += ctx.stats[w].histogram[s];
+            total += ctx.stats[w].histogram[s] * s;
+        }
+    }
+
+    uint32_t min = SIM_MAX_SHOTS, max = 0, median = 0;
+    uint64_t seen = 0;
+    for(uint32_t s = 0; s <= SIM_MAX_SHOTS; s++) {
+        if(histogram[s] == 0) continue;
+        if(s < min) min = s;
+        if(s > max) max = s;
+        if(seen < (games + 1) / 2 && seen + histogram[s] >= (games + 1) / 2) median = s;
+        seen += histogram[s];
+    }
+
+    const char* modes[] = { "heuristic", "exact", "mc", "density", "lookahead" };
+    printf("bsbot_sim: %llu games, mode %s, %u threads, seed %llu\n", (unsigned long long)games, modes[ctx.mode], pool.workers, (unsigned long long)ctx.seed);
+    if(ctx.lockstep) printf("lockstep:  %d games per batch, %s\n", SIM_BATCH, bs_batch_isa());
+    if(ctx.grid != NULL) printf("board:     %ux%u, %u ships (general code)\n", grid.width, grid.height, grid.count);
+    if(unplaced > 0) printf("unplaced:  %llu fleets couldn't be placed, so those games aren't counted\n", (unsigned long long)unplaced);
+    if(games == 0) {
+        printf("no games were played\n");
+        return 1;
+    }
+    printf("games/s:   %.1f (%.3fs)\n", (double)games / seconds, seconds);
+    printf("shots:     mean %.2f, median %u, min %u, max %u\n", (double)total / (double)games, median, min, max);
+    if(ctx.caches != NULL) {
+        uint64_t hits = 0, misses = 0, evictions = 0;
+        for(uint32_t w = 0; w < pool.workers; w++) {
+            hits += ctx.caches[w].hits;
+            misses += ctx.caches[w].misses;
+            evictions += ctx.caches[w].evictions;
+        }
+        double rate = (hits + misses) ? (100.0 * (double)hits) / (double)(hits + misses) : 0.0;
+        printf("cache:     %llu hits, %llu misses (%.1f%%), %llu evictions\n", (unsigned long long)hits, (unsigned long long)misses, rate, (unsigned long long)evictions);
+    }
+    printf("distribution:\n");
+
+    // Buckets of 5 shots (more on bigger boards, so it's still about 20 lines)
+    uint32_t bucket = grid.cells > 100 ? grid.cells / 20 : 5;
+    uint64_t biggest = 1;
+    for(uint32_t b = 0; b <= SIM_MAX_SHOTS; b += bucket) {
+        uint64_t n = 0;
+        for(uint32_t s = b; s < b + bucket && s <= SIM_MAX_SHOTS; s++) n += histogram[s];
+        if(n > biggest) biggest = n;
+    }
+    for(uint32_t b = 0; b <= SIM_MAX_SHOTS; b += bucket) {
+        uint64_t n = 0;
+        for(uint32_t s = b; s < b + bucket && s <= SIM_MAX_SHOTS; s++) n += histogram[s];
+        if(n == 0) continue;
+
+        char bar[41];
+        uint32_t len = (uint32_t)((n * 40) / biggest);
+        memset(bar, '#', len);
+        bar[len] = '\0';
+        printf("  %3u-%-3u %10llu %6.2f%% %s\n", b, b + bucket - 1, (unsigned long long)n, (100.0 * (double)n) / (double)games, bar);
+    }
+
+    bs_pool_destroy(&pool);
+    if(ctx.caches != NULL) {
+        for(uint32_t w = 0; w < pool.workers; w++) bs_cache_destroy(&ctx.caches[w]);
+        free(ctx.caches);
+    }
+    free(ctx.stats);
+    if(ctx.book != NULL) bs_book_close(&book);
+    if(ctx.prior != NULL) bs_prior_close(&prior);
+    return 0;
+}
@@ -0,0 +1,186 @@
+/*
+    BSBOT made by William Dawson (MrBisquit on GitHub)
+    https://wtdawson.info
+
+    --------------------------------------------------------------------------------------------
+
+    Thinking in the background (See thinker.h)
+
+    --------------------------------------------------------------------------------------------
+
+ *  License:    SPDX-License-Identifier: MIT
+ *              See LICENSE file in the project root for full license text.
+*/
+
+#include <string.h>
+#include "thinker.h"
+
+/// @brief Copies what the bot's worked out into whichever buffer isn't being shown, then shows it
+static void bs_thinker_publish(thinker_t* t, const bot_t* bot) {
+    int32_t back = !bs_atomic_load32(&t->front);
+    memcpy(t->shown[back].possibilities, bot->possibilities, sizeof(t->shown[back].possibilities));
+    t->shown[back].searched = bot->searched;
+    if(bot->cache != NULL) {
+        t->shown[back].cache_hits = bot->cache->hits;
+        t->shown[back].cache_misses = bot->cache->misses;
+        t->shown[back].cache_evictions = bot->cache->evictions;
+    }
+    bs_atomic_store32(&t->front, back);
+}
+
+static void bs_thinker_worker(void* arg) {
+    thinker_t* t = arg;
+
+    for(;;) {
+        bs_mutex_lock(&t->lock);
+        while(!t->quit && t->bot == NULL && t->job == NULL) bs_cond_wait(&t->wake, &t->lock);
+        if(t->quit) {
+            bs_mutex_unlock(&t->lock);
+            return;
+        }
+        bot_t* bot = t->bot;
+        thinker_job_t job = t->job;
+        void* arg = t->arg;
+        bs_mutex_unlock(&t->lock);
+
+        if(job != NULL) job(arg);
+        else {
+            bs_bot_think(bot, &t->k);
+            if(!bs_atomic_load32(&t->cancel)) bs_thinker_publish(t, bot);
+        }
+
+        bs_mutex_lock(&t->lock);
+        t->bot = NULL;
+        t->job = NULL;
+        bs_atomic_store32(&t->state, THINKER_DONE);
+        bs_cond_broadcast(&t->wake);
+        bs_mutex_unlock(&t->lock);
+    }
+}
+
+/// @brief Starts the thread
+/// @param t The thinker
+/// @return Returns `false` if the thread couldn't be started (it'll still work, just on whoever calls `bs_thinker_start`)
+bool bs_thinker_init(thinker_t* t) {
+    memset(t, 0, sizeof(thinker_t));
+    bs_mutex_init(&t->lock);
+    bs_cond_init(&t->wake);
+
+    for(uint8_t i = 0; i < 2; i++) bs_poss_fill(t->shown[i].possibilities, POSS_FIXED(0.5f));
+
+    t->started = bs_thread_start(&t->thread, bs_thinker_worker, t);
+    return t->started;
+}
+
+/// @brief Cancels anything it's thinking about, and stops the thread
+void bs_thinker_destroy(thinker_t* t) {
+    bs_thinker_cancel(t);
+
+    bs_mutex_lock(&t->lock);
+    t->quit = true;
+    bs_cond_broadcast(&t->wake);
+    bs_mutex_unlock(&t->lock);
+
+    if(t->started) bs_thread_join(&t->thread);
+    bs_cond_destroy(&t->wake);
+    bs_mutex_destroy(&t->lock);
+}
+
+/// @brief Starts the bot thinking about its next move
+/// @param t The thinker
+/// @param bot The bot (hands off until `bs_thinker_done`, and it has to stay around until then)
+/// @param k What the bot knows (copied)
+/// @return Returns `false` if it's already thinking (or the last result hasn't been taken yet)
+bool bs_thinker_start(thinker_t* t, bot_t* bot, const knowledge_t* k) {
+    if(bs_atomic_load32(&t->state) != THINKER_IDLE) return false;
+
+    bot->cancel = &t->cancel;
+    bs_atomic_store32(&t->cancel, 0);
+
+    // Without a thread it's all done here, the same as if it didn't exist
+    if(!t->started) {
+        bs_bot_think(bot, k);
+        bs_thinker_publish(t, bot);
+        bs_atomic_store32(&t->state, THINKER_DONE);
+        return true;
+    }
+
+    bs_mutex_lock(&t->lock);
+    t->k = *k;
+    t->bot = bot;
+    bs_atomic_store32(&t->state, THINKER_BUSY);
+    bs_cond_broadcast(&t->wake);
+    bs_mutex_unlock(&t->lock);
+    return true;
+}
+
+/// @brief Runs something else on the thread, instead of the window waiting for it
+/// @note It isn't cancelled, `bs_thinker_cancel` (and `bs_thinker_destroy`) just wait for it
+/// @param t The thinker
+/// @param job What to run
+/// @param arg What it's given (it has to stay around until `bs_thinker_done`)
+/// @return Returns `false` if it's already busy (or the last result hasn't been taken yet)
+bool bs_thinker_run(thinker_t* t, thinker_job_t job, void* arg) {
+    if(bs_atomic_load32(&t->state) != THINKER_IDLE) return false;
+
+    if(!t->started) {
+        job(arg);
+        bs_atomic_store32(&t->state, THINKER_DONE);
+        return true;
+    }
+
+    bs_mutex_lock(&t->lock);
+    t->job = job;
+    t->arg = arg;
+    bs_atomic_store32(&t->state, THINKER_BUSY);
+    bs_cond_broadcast(&t->wake);
+    bs_mutex_unlock(&t->lock);
+    return true;
+}
+
+/// @brief Checks if the bot's finished thinking (or running a job), and takes the result if it has (so the next one can start)
+/// @param t The thinker
+/// @return Returns `true` once, when it's finished (the bot's back to whoever started it then)
+bool bs_thinker_done(thinker_t* t) {
+    if(bs_atomic_load32(&t->state) != THINKER_DONE) return false;
+
+    bs_atomic_store32(&t->state, THINKER_IDLE);
+    return true;
+}
+
+/// @brief Waits for whatever it's doing to finish, the result's still there for `bs_thinker_done`
+void bs_thinker_wait(thinker_t* t) {
+    if(bs_atomic_load32(&t->state) != THINKER_BUSY) return;
+
+    bs_mutex_lock(&t->lock);
+    while(bs_atomic_load32(&t->state) == THINKER_BUSY) bs_cond_wait(&t->wake, &t->lock);
+    bs_mutex_unlock(&t->lock);
+}
+
+/// @brief Stops the bot thinking (if it is), and waits for it to stop
+/// @note Whatever it was thinking is thrown away, and the bot's back to whoever started it
+void bs_thinker_cancel(thinker_t* t) {
+    if(bs_atomic_load32(&t->state) == THINKER_IDLE) return;
+    bs_atomic_store32(&t->cancel, 1);
+
+    bs_mutex_lock(&t->lock);
+    while(bs_atomic_load32(&t->state) == THINKER_BUSY) bs_cond_wait(&t->wake, &t->lock);
+    bs_atomic_store32(&t->state, THINKER_IDLE);
+    bs_mutex_unlock(&t->lock);
+}
+
+/// @brief Shows what a bot's worked out (for anything it's done that wasn't thinking, like after a shot)
+/// @note Only while it isn't thinking, the thread's the only one that writes to it then
+/// @param t The thinker
+/// @param bot The bot
+void bs_thinker_show(thinker_t* t, const bot_t* bot) {
+    if(bs_atomic_load32(&t->state) == THINKER_BUSY) return;
+    bs_thinker_publish(t, bot);
+}
+
+/// @brief Gets what the bot last worked out (safe to read every frame, from the thread that shows it)
+/// @param t The thinker
+/// @return What to show
+const thinker_shown_t* bs_thinker_shown(const thinker_t* t) {
+    return &t->shown[bs_atomic_load32((volatile int32_t*)&t->front)];
+}
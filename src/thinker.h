@@ -0,0 +1,88 @@
+/*
+    BSBOT made by William Dawson (MrBisquit on GitHub)
+    https://wtdawson.info
+
+    --------------------------------------------------------------------------------------------
+
+    Thinking in the background
+
+    The slower modes can take tens of milliseconds a move (more with a big lookahead budget),
+    which is a dropped frame or two if the window waits for them. So the bot thinks on its own
+    thread instead, and the window just checks each frame whether it's done yet.
+
+    While it's thinking the bot belongs to that thread, so nothing else should touch it until
+    `bs_thinker_done` says it's finished (the session won't, it's the bot's turn). Anything
+    that changes the game part way through (a new game, closing the window) cancels it first,
+    which stops the engines at their next check and waits for them.
+
+    Anything else that's slow the window shouldn't wait for (placing the bot's ships, learning
+    from a game) can be run on it too with `bs_thinker_run`, one thing at a time, and
+    `bs_thinker_done` says when that's finished the same way.
+
+    What the bot last worked out is copied into one of two buffers, and then that one's swapped
+    in with an atomic store, so the debug panel can read it every frame without locking. The
+    thread only ever writes the one that isn't in, once a move, and the next move can't start
+    until the window's done drawing, so nothing's read while it's being written.
+
+    --------------------------------------------------------------------------------------------
+
+ *  License:    SPDX-License-Identifier: MIT
+ *              See LICENSE file in the project root for full license text.
+*/
+
+#ifndef BSBOT_THINKER_H
+#define BSBOT_THINKER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "game.h"
+#include "platform.h"
+
+typedef enum {
+    THINKER_IDLE,           // Nothing to do (or the result's been taken)
+    THINKER_BUSY,           // Thinking
+    THINKER_DONE            // Finished, the bot can move
+} thinker_state_t;
+
+/// @brief What the bot last worked out, for showing
+typedef struct {
+    poss_row_t possibilities[BB_SIZE];
+    search_result_t searched;
+    uint64_t cache_hits;        // The bot's cache counters (it's only counted while thinking)
+    uint64_t cache_misses;
+    uint64_t cache_evictions;
+} thinker_shown_t;
+
+typedef void (*thinker_job_t)(void* arg);
+
+typedef struct {
+    bs_thread_t thread;
+    bs_mutex_t lock;
+    bs_cond_t wake;         // Something's changed (there's a job, it's finished, or it's quitting)
+    bool quit;
+    bool started;
+
+    bot_t* bot;             // Who it's thinking for (NULL = nobody)
+    knowledge_t k;
+    thinker_job_t job;      // Or something else to run (NULL = nothing, see `bs_thinker_run`)
+    void* arg;
+    volatile int32_t state; // A `thinker_state_t`
+    volatile int32_t cancel;
+
+    thinker_shown_t shown[2];
+    volatile int32_t front; // Which of `shown` is the newest
+} thinker_t;
+
+bool bs_thinker_init(thinker_t* t);
+void bs_thinker_destroy(thinker_t* t);
+
+bool bs_thinker_start(thinker_t* t, bot_t* bot, const knowledge_t* k);
+bool bs_thinker_run(thinker_t* t, thinker_job_t job, void* arg);
+bool bs_thinker_done(thinker_t* t);
+void bs_thinker_wait(thinker_t* t);
+void bs_thinker_cancel(thinker_t* t);
+
+void bs_thinker_show(thinker_t* t, const bot_t* bot);
+const thinker_shown_t* bs_thinker_shown(const thinker_t* t);
+
+#endif